@@ -19,8 +19,11 @@
 
 #include <log/log.h>
 #include <cutils/properties.h>
+#include <stdio.h>
 
 #include "Gnss.h"
+#include "GnssEpochBarrier.h"
+#include "GnssMeasQueue.h"
 
 namespace android {
 namespace hardware {
@@ -48,6 +51,7 @@ Gnss::Gnss(void) :
         mGnssHwIface = new GnssHwTTY(-1);
         //mGnssHwIface->SetUpHandleThread();
         mGnssMeasurement = new GnssMeasurementImpl();
+        mGnssNavigationMessage = new GnssNavigationMessage(mGnssHwIface);
         ALOGI("Using TTY HW backend");
     }
 }
@@ -214,24 +218,14 @@ Return<sp<IGnssMeasurement>> Gnss::getExtensionGnssMeasurement() {
 }
 
 Return<sp<IGnssNavigationMessage>> Gnss::getExtensionGnssNavigationMessage() {
-    if (mGnssIface == nullptr) {
+    if (mGnssHwIface == nullptr) {
         ALOGE("%s: Gnss interface is unavailable", __func__);
         return nullptr;
     }
 
     if (mGnssNavigationMessage == nullptr) {
-        const GpsNavigationMessageInterface* gpsNavigationMessageIface =
-                static_cast<const GpsNavigationMessageInterface*>(
-                        mGnssIface->get_extension(GPS_NAVIGATION_MESSAGE_INTERFACE));
-
-        if (gpsNavigationMessageIface == nullptr) {
-            ALOGE("%s GnssNavigationMessage interface not implemented by GNSS HAL",
-                  __func__);
-        } else {
-            mGnssNavigationMessage = new GnssNavigationMessage();
-        }
+        ALOGE("%s GnssNavigationMessage interface not implemented by GNSS HAL", __func__);
     }
-
     return mGnssNavigationMessage;
 }
 
@@ -256,20 +250,14 @@ Return<sp<IGnssXtra>> Gnss::getExtensionXtra()  {
 }
 
 Return<sp<IGnssDebug>> Gnss::getExtensionGnssDebug()  {
-    if (mGnssIface == nullptr) {
+    if (mGnssHwIface == nullptr) {
         ALOGE("%s: Gnss interface is unavailable", __func__);
         return nullptr;
     }
 
+    // debug data is read from the snapshots of the backend, no legacy extension is needed
     if (mGnssDebug == nullptr) {
-        const GpsDebugInterface* gpsDebugIface = static_cast<const GpsDebugInterface*>(
-                mGnssIface->get_extension(GPS_DEBUG_INTERFACE));
-
-        if (gpsDebugIface == nullptr) {
-            ALOGE("%s: GnssDebug interface is not implemented by HAL", __func__);
-        } else {
-            mGnssDebug = new GnssDebug();
-        }
+        mGnssDebug = new GnssDebug(mGnssHwIface);
     }
 
     return mGnssDebug;
@@ -398,6 +386,47 @@ Return<bool> Gnss::setPositionMode(IGnss::GnssPositionMode mode,
     return true;
 }
 
+Return<void> Gnss::debug(const hidl_handle& fd, const hidl_vec<hidl_string>& /*options*/)
+{
+    if (fd == nullptr || fd->numFds < 1) {
+        ALOGE("%s: invalid file descriptor", __func__);
+        return Void();
+    }
+
+    const int out = fd->data[0];
+    GnssMeasQueue& measQueue = GnssMeasQueue::getInstance();
+    const GnssMeasQueue::QueueStats queue = measQueue.getQueueStats();
+    const GnssMeasQueue::EpochStats epochs = measQueue.getEpochStats();
+
+    dprintf(out, "GnssMeasQueue: size %zu/%zu, high water %zu, pushed %llu, popped %llu, "
+            "dropped %llu\n", queue.size, GnssMeasQueue::mMaxSize, queue.highWater,
+            static_cast<unsigned long long>(queue.pushed),
+            static_cast<unsigned long long>(queue.popped),
+            static_cast<unsigned long long>(queue.dropped));
+    dprintf(out, "Measurement epochs: completed %llu, emitted incomplete %llu, "
+            "dropped incomplete %llu, max latency %lld us\n",
+            static_cast<unsigned long long>(epochs.completed),
+            static_cast<unsigned long long>(epochs.emittedIncomplete),
+            static_cast<unsigned long long>(epochs.droppedIncomplete),
+            static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    epochs.maxLatency).count()));
+
+    const GnssEpochBarrier::Stats barrier = GnssEpochBarrier::getInstance().getStats();
+    dprintf(out, "Epoch barrier: in order %llu, late %llu, dropped %llu\n",
+            static_cast<unsigned long long>(barrier.inOrder),
+            static_cast<unsigned long long>(barrier.late),
+            static_cast<unsigned long long>(barrier.dropped));
+
+    if (mGnssMeasurement != nullptr) {
+        const GnssDataPool::Stats pool = mGnssMeasurement->getDataPoolStats();
+        dprintf(out, "GnssData: epochs %llu, heap allocations %llu\n",
+                static_cast<unsigned long long>(pool.acquired),
+                static_cast<unsigned long long>(pool.allocated));
+    }
+
+    return Void();
+}
+
 }  // namespace renesas
 }  // namespace V1_0
 }  // namespace gnss
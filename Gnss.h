@@ -43,6 +43,7 @@ using ::android::hardware::Return;
 using ::android::hardware::Void;
 using ::android::hardware::hidl_vec;
 using ::android::hardware::hidl_string;
+using ::android::hardware::hidl_handle;
 using ::android::sp;
 
 struct Gnss : public IGnss {
@@ -85,6 +86,12 @@ struct Gnss : public IGnss {
     Return<sp<IGnssDebug>> getExtensionGnssDebug(void) override;
     Return<sp<IGnssBatching>> getExtensionGnssBatching(void) override;
 
+    /*
+     * Methods from ::android::hidl::base::V1_0::IBase follow.
+     * Dump the measurement queue counters on "lshal debug".
+     */
+    Return<void> debug(const hidl_handle& fd, const hidl_vec<hidl_string>& options) override;
+
     /*
      * Wakelock consolidation, only needed for dual use of a gps.h & fused_location.h HAL
      *
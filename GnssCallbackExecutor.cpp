@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasCallbackExecutor"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <log/log.h>
+
+#include "GnssCallbackExecutor.h"
+#include "GnssEpochBarrier.h"
+#include "GnssThreadPolicy.h"
+
+template<typename Duration>
+static std::chrono::microseconds toUs(Duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+}
+
+GnssCallbackExecutor::GnssCallbackExecutor()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    mThread = std::thread(&GnssCallbackExecutor::DeliveryThread, this);
+}
+
+GnssCallbackExecutor::~GnssCallbackExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mThreadExit = true;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void GnssCallbackExecutor::SetCallback(const android::sp<IGnssCallback>& callback)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mCallback = callback;
+}
+
+bool GnssCallbackExecutor::Post(Mailbox mailbox)
+{
+    if (mCallback == nullptr) {
+        return false;
+    }
+
+    Slot& slot = mSlots[static_cast<size_t>(mailbox)];
+    if (slot.pending) {
+        slot.stats.coalesced++;
+    }
+    slot.pending = true;
+    slot.posted = Clock::now();
+    slot.stats.posted++;
+
+    return true;
+}
+
+void GnssCallbackExecutor::PostLocation(const GnssLocation& location, int64_t epochKey)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!Post(Mailbox::Location)) {
+            return;
+        }
+        mLocation = location;
+        mLocationKey = epochKey;
+    }
+    mCv.notify_one();
+}
+
+void GnssCallbackExecutor::PostSvStatus(const IGnssCallback::GnssSvStatus& svStatus)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!Post(Mailbox::SvStatus)) {
+            return;
+        }
+
+        // only the reported part of the list is copied
+        const size_t count = std::min(static_cast<size_t>(svStatus.numSvs),
+                                      static_cast<size_t>(GnssMax::SVS_COUNT));
+        mSvStatus.numSvs = static_cast<uint32_t>(count);
+        std::copy(svStatus.gnssSvList.data(), svStatus.gnssSvList.data() + count,
+                  mSvStatus.gnssSvList.data());
+    }
+    mCv.notify_one();
+}
+
+void GnssCallbackExecutor::Clear()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+    for (auto& slot : mSlots) {
+        slot.pending = false;
+    }
+
+    // a client calling back into the HAL from its callback must not wait for itself
+    if (std::this_thread::get_id() != mThread.get_id()) {
+        mIdleCv.wait(lock, [this] { return !mDelivering; });
+    }
+}
+
+GnssCallbackExecutor::Stats GnssCallbackExecutor::GetStats(Mailbox mailbox)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mSlots[static_cast<size_t>(mailbox)].stats;
+}
+
+bool GnssCallbackExecutor::HasPending() const
+{
+    for (const auto& slot : mSlots) {
+        if (slot.pending) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void GnssCallbackExecutor::DeliveryThread()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Callback, "gnss_callback");
+
+    std::unique_lock<std::mutex> lock(mLock);
+    while (!mThreadExit) {
+        mCv.wait(lock, [this] { return mThreadExit || HasPending(); });
+
+        for (size_t i = 0; i < static_cast<size_t>(Mailbox::MailboxesCount) && !mThreadExit; i++) {
+            Slot& slot = mSlots[i];
+            if (!slot.pending) {
+                continue;
+            }
+
+            const Mailbox mailbox = static_cast<Mailbox>(i);
+            if (Mailbox::Location == mailbox) {
+                mOutLocation = mLocation;
+                mOutLocationKey = mLocationKey;
+            } else {
+                mOutSvStatus.numSvs = mSvStatus.numSvs;
+                std::copy(mSvStatus.gnssSvList.data(), mSvStatus.gnssSvList.data() + mSvStatus.numSvs,
+                          mOutSvStatus.gnssSvList.data());
+            }
+            slot.pending = false;
+
+            const Clock::time_point posted = slot.posted;
+            const android::sp<IGnssCallback> callback = mCallback;
+            if (callback == nullptr) {
+                continue;
+            }
+
+            mDelivering = true;
+            lock.unlock();
+            if (Mailbox::Location == mailbox && !WaitEpochTurn()) {
+                lock.lock();
+                SetIdle();
+                slot.stats.dropped++;
+                continue;
+            }
+            const Clock::time_point start = Clock::now();
+            const bool isOk = Deliver(mailbox, callback);
+            const Clock::time_point end = Clock::now();
+            if (Mailbox::Location == mailbox && mOutLocationKey != mNoEpochKey) {
+                GnssEpochBarrier::getInstance().release(GnssEpochBarrier::Lane::Location, mOutLocationKey);
+            }
+            lock.lock();
+            SetIdle();
+
+            if (isOk) {
+                slot.stats.delivered++;
+            } else {
+                ALOGE("[%s, line %d] Unable to invoke callback of mailbox %zu", __func__, __LINE__, i);
+                slot.stats.failed++;
+            }
+            slot.stats.lastLatency = toUs(end - posted);
+            slot.stats.maxLatency = std::max(slot.stats.maxLatency, slot.stats.lastLatency);
+            slot.stats.maxCallDuration = std::max(slot.stats.maxCallDuration, toUs(end - start));
+        }
+    }
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssCallbackExecutor::SetIdle()
+{
+    mDelivering = false;
+    mIdleCv.notify_all();
+}
+
+bool GnssCallbackExecutor::WaitEpochTurn()
+{
+    if (mOutLocationKey == mNoEpochKey) {
+        return true;
+    }
+
+    return GnssEpochBarrier::getInstance().waitTurn(GnssEpochBarrier::Lane::Location, mOutLocationKey);
+}
+
+bool GnssCallbackExecutor::Deliver(Mailbox mailbox, const android::sp<IGnssCallback>& callback)
+{
+    if (Mailbox::Location == mailbox) {
+        ALOGD("Provide location callback");
+        return callback->gnssLocationCb(mOutLocation).isOk();
+    }
+
+    return callback->gnssSvStatusCb(mOutSvStatus).isOk();
+}
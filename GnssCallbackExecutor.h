@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSCALLBACKEXECUTOR_H__
+#define __GNSSCALLBACKEXECUTOR_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <utils/RefBase.h>
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+using namespace android::hardware::gnss::V1_0;
+
+/*!
+ * \brief GnssCallbackExecutor - delivers location and SV status callbacks off the parse thread
+ * \brief every callback type has a single-slot mailbox, a value posted while the previous
+ * \brief one is still pending replaces it, so a slow client gets the newest data only
+ */
+class GnssCallbackExecutor
+{
+public:
+    enum class Mailbox : uint8_t {
+        Location = 0,
+        SvStatus,
+        MailboxesCount,
+    };
+
+    /*!
+     * \brief Stats - per mailbox counters, latency is measured from Post to callback return
+     * \brief dropped counts locations the epoch barrier did not let through
+     */
+    struct Stats {
+        uint64_t posted = 0;
+        uint64_t delivered = 0;
+        uint64_t coalesced = 0;
+        uint64_t failed = 0;
+        uint64_t dropped = 0;
+        std::chrono::microseconds lastLatency{0};
+        std::chrono::microseconds maxLatency{0};
+        std::chrono::microseconds maxCallDuration{0};
+    };
+
+    static constexpr int64_t mNoEpochKey = -1;
+
+    GnssCallbackExecutor();
+    ~GnssCallbackExecutor();
+
+    /*!
+     * \brief SetCallback - set framework callback used for delivery
+     * \param callback - framework callback, nullptr to stop delivery
+     */
+    void SetCallback(const android::sp<IGnssCallback>& callback);
+
+    /*!
+     * \brief PostLocation - queue location for gnssLocationCb, never blocks on the client
+     * \brief nor on the epoch barrier, the delivery thread waits for the turn of the epoch
+     * \param location - location to deliver, replaces a pending one
+     * \param epochKey - key of the location lane of GnssEpochBarrier, mNoEpochKey to skip it
+     */
+    void PostLocation(const GnssLocation& location, int64_t epochKey = mNoEpochKey);
+
+    /*!
+     * \brief PostSvStatus - queue SV status for gnssSvStatusCb, never blocks on the client
+     * \param svStatus - SV status to deliver, replaces a pending one
+     */
+    void PostSvStatus(const IGnssCallback::GnssSvStatus& svStatus);
+
+    /*!
+     * \brief Clear - discard pending values and wait for the callback in flight to return,
+     * \brief e.g. before the session end is reported, no callback follows until the next Post
+     */
+    void Clear();
+
+    /*!
+     * \brief GetStats - provide the counters of the mailbox
+     * \param mailbox - callback type
+     * \return copy of the counters
+     */
+    Stats GetStats(Mailbox mailbox);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot {
+        bool pending = false;
+        Clock::time_point posted;
+        Stats stats;
+    };
+
+    /*!
+     * \brief Post - mark the mailbox pending, called with mLock held
+     * \return false if there is no client to deliver to
+     */
+    bool Post(Mailbox mailbox);
+    bool HasPending() const;
+    void DeliveryThread();
+
+    /*!
+     * \brief SetIdle - the outgoing value is delivered or dropped, called with mLock held
+     */
+    void SetIdle();
+
+    /*!
+     * \brief WaitEpochTurn - wait for the outgoing location's turn in the epoch barrier, called unlocked
+     * \return false if the barrier drops the location
+     */
+    bool WaitEpochTurn();
+
+    /*!
+     * \brief Deliver - invoke the client with the outgoing value of the mailbox, called unlocked
+     * \return true if the binder call succeeded
+     */
+    bool Deliver(Mailbox mailbox, const android::sp<IGnssCallback>& callback);
+
+    std::mutex              mLock;
+    std::condition_variable mCv;
+    std::thread             mThread;
+    bool                    mThreadExit = false;
+
+    // set while the delivery thread runs unlocked with an outgoing value, Clear waits on mIdleCv
+    bool                    mDelivering = false;
+    std::condition_variable mIdleCv;
+
+    android::sp<IGnssCallback> mCallback;
+    Slot mSlots[static_cast<size_t>(Mailbox::MailboxesCount)];
+
+    // mailbox values are written by Post under mLock, the delivery thread
+    // copies them to the outgoing values and calls the client unlocked
+    GnssLocation                mLocation = {};
+    int64_t                     mLocationKey = mNoEpochKey;
+    IGnssCallback::GnssSvStatus mSvStatus = {};
+    GnssLocation                mOutLocation = {};
+    int64_t                     mOutLocationKey = mNoEpochKey;
+    IGnssCallback::GnssSvStatus mOutSvStatus = {};
+};
+
+#endif // __GNSSCALLBACKEXECUTOR_H__
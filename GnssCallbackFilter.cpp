@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasCbFilter"
+#define LOG_NDEBUG 1
+
+#include <cmath>
+#include <inttypes.h>
+#include <cstdlib>
+#include <log/log.h>
+#include <cutils/properties.h>
+
+#include "GnssCallbackFilter.h"
+
+static const double earthRadiusM = 6371000.0;
+static const double degToRad = M_PI / 180.0;
+static const uint8_t usedInFixFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
+
+static float GetFloatProp(const char* name, const char* def)
+{
+    char value[PROPERTY_VALUE_MAX] = {};
+    property_get(name, value, def);
+    return strtof(value, nullptr);
+}
+
+static float AngleDelta(float a, float b)
+{
+    float delta = std::fabs(a - b);
+    return (delta > 180.f) ? (360.f - delta) : delta;
+}
+
+GnssCallbackFilter::Config GnssCallbackFilter::readConfig()
+{
+    Config config;
+
+    config.enabled          = property_get_bool("ro.boot.gps.filter", false);
+    config.cn0DeltaDbHz     = GetFloatProp("ro.boot.gps.filter_cn0", "2.0");
+    config.angleDeltaDeg    = GetFloatProp("ro.boot.gps.filter_angle", "1.0");
+    config.minDisplacementM = GetFloatProp("ro.boot.gps.filter_dist", "1.0");
+    config.maxSilenceMs     = property_get_int32("ro.boot.gps.filter_silence_ms", 5000);
+
+    ALOGI("Callback filter %s: cn0 %.1f dBHz, angle %.1f deg, distance %.1f m, silence %" PRId64 " ms",
+          config.enabled ? "enabled" : "disabled", config.cn0DeltaDbHz, config.angleDeltaDeg,
+          config.minDisplacementM, config.maxSilenceMs);
+
+    return config;
+}
+
+GnssCallbackFilter::GnssCallbackFilter(const Config& config) :
+    mConfig(config),
+    mSvStatusSent(false),
+    mLocationSent(false),
+    mSavedSvStatus(0),
+    mSavedLocations(0)
+{
+}
+
+void GnssCallbackFilter::Reset()
+{
+    mSvStatusSent = false;
+    mLocationSent = false;
+}
+
+bool GnssCallbackFilter::IsSvStatusChanged(const IGnssCallback::GnssSvStatus& status) const
+{
+    if (status.numSvs != mLastSvStatus.numSvs) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < status.numSvs; i++) {
+        const IGnssCallback::GnssSvInfo& sv = status.gnssSvList[i];
+        const IGnssCallback::GnssSvInfo& last = mLastSvStatus.gnssSvList[i];
+
+        if (sv.svid != last.svid || sv.constellation != last.constellation ||
+                (sv.svFlag & usedInFixFlag) != (last.svFlag & usedInFixFlag)) {
+            return true;
+        }
+
+        if (std::fabs(sv.cN0Dbhz - last.cN0Dbhz) >= mConfig.cn0DeltaDbHz ||
+                std::fabs(sv.elevationDegrees - last.elevationDegrees) >= mConfig.angleDeltaDeg ||
+                AngleDelta(sv.azimuthDegrees, last.azimuthDegrees) >= mConfig.angleDeltaDeg) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool GnssCallbackFilter::IsLocationChanged(const GnssLocation& location) const
+{
+    if (location.gnssLocationFlags != mLastLocation.gnssLocationFlags) {
+        return true;
+    }
+
+    // Equirectangular approximation is precise enough for displacements of a few meters
+    const double meanLat = (location.latitudeDegrees + mLastLocation.latitudeDegrees) * 0.5 * degToRad;
+    const double dx = (location.longitudeDegrees - mLastLocation.longitudeDegrees) * degToRad * std::cos(meanLat);
+    const double dy = (location.latitudeDegrees - mLastLocation.latitudeDegrees) * degToRad;
+    const double displacement = earthRadiusM * std::sqrt(dx * dx + dy * dy);
+
+    if (displacement >= mConfig.minDisplacementM) {
+        return true;
+    }
+
+    return std::fabs(location.altitudeMeters - mLastLocation.altitudeMeters) >= mConfig.minDisplacementM;
+}
+
+bool GnssCallbackFilter::ShouldSendSvStatus(const IGnssCallback::GnssSvStatus& status, int64_t nowMs)
+{
+    if (mConfig.enabled && mSvStatusSent && (nowMs - mSvStatusSentMs) < mConfig.maxSilenceMs &&
+            !IsSvStatusChanged(status)) {
+        mSavedSvStatus++;
+        ALOGV("[%s, line %d] SV status unchanged, saved %" PRIu64, __func__, __LINE__,
+              mSavedSvStatus.load());
+        return false;
+    }
+
+    if (mConfig.enabled) {
+        mLastSvStatus.numSvs = status.numSvs;
+        for (uint32_t i = 0; i < status.numSvs; i++) {
+            mLastSvStatus.gnssSvList[i] = status.gnssSvList[i];
+        }
+        mSvStatusSent = true;
+        mSvStatusSentMs = nowMs;
+    }
+
+    return true;
+}
+
+bool GnssCallbackFilter::ShouldSendLocation(const GnssLocation& location, int64_t nowMs)
+{
+    if (mConfig.enabled && mLocationSent && (nowMs - mLocationSentMs) < mConfig.maxSilenceMs &&
+            !IsLocationChanged(location)) {
+        mSavedLocations++;
+        ALOGV("[%s, line %d] Location unchanged, saved %" PRIu64, __func__, __LINE__,
+              mSavedLocations.load());
+        return false;
+    }
+
+    if (mConfig.enabled) {
+        mLastLocation = location;
+        mLocationSent = true;
+        mLocationSentMs = nowMs;
+    }
+
+    return true;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSCALLBACKFILTER_H__
+#define __GNSSCALLBACKFILTER_H__
+
+#include <atomic>
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+using namespace android::hardware::gnss::V1_0;
+
+/*!
+ * \brief GnssCallbackFilter - change detection for SV status and location callbacks
+ * \brief an update is skipped when it does not differ from the last sent one by more
+ * \brief than the configured thresholds and the maximum silence is not reached yet
+ */
+class GnssCallbackFilter
+{
+public:
+    struct Config {
+        bool    enabled;
+        float   cn0DeltaDbHz;
+        float   angleDeltaDeg;
+        float   minDisplacementM;
+        int64_t maxSilenceMs;
+    };
+
+    /*!
+     * \brief readConfig - read filter configuration from system properties
+     * \return configuration, the filter is disabled by default
+     */
+    static Config readConfig();
+
+    explicit GnssCallbackFilter(const Config& config);
+    ~GnssCallbackFilter() {}
+
+    /*!
+     * \brief ShouldSendSvStatus - check if SV status differs enough from the last sent one
+     * \brief remembers the status as sent if true is returned
+     * \param status - SV status to be sent
+     * \param nowMs - current monotonic time
+     * \return true if callback has to be invoked
+     */
+    bool ShouldSendSvStatus(const IGnssCallback::GnssSvStatus& status, int64_t nowMs);
+
+    /*!
+     * \brief ShouldSendLocation - check if location differs enough from the last sent one
+     * \brief remembers the location as sent if true is returned
+     * \param location - location to be sent
+     * \param nowMs - current monotonic time
+     * \return true if callback has to be invoked
+     */
+    bool ShouldSendLocation(const GnssLocation& location, int64_t nowMs);
+
+    /*!
+     * \brief Reset - forget the last sent values, next updates are always sent
+     * \brief may be called from any thread while the parse thread runs the filter
+     */
+    void Reset();
+
+    uint64_t GetSavedSvStatusCount() const { return mSavedSvStatus; }
+    uint64_t GetSavedLocationCount() const { return mSavedLocations; }
+
+private:
+    bool IsSvStatusChanged(const IGnssCallback::GnssSvStatus& status) const;
+    bool IsLocationChanged(const GnssLocation& location) const;
+
+    const Config mConfig;
+
+    // cleared by Reset from the binder thread, the rest is parse thread only
+    std::atomic<bool> mSvStatusSent;
+    int64_t mSvStatusSentMs = 0;
+    IGnssCallback::GnssSvStatus mLastSvStatus = {};
+
+    std::atomic<bool> mLocationSent;
+    int64_t mLocationSentMs = 0;
+    GnssLocation mLastLocation = {};
+
+    std::atomic<uint64_t> mSavedSvStatus;
+    std::atomic<uint64_t> mSavedLocations;
+};
+
+#endif // __GNSSCALLBACKFILTER_H__
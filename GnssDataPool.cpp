@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasDataPool"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <log/log.h>
+
+#include "GnssDataPool.h"
+
+MeasurementCb::GnssData& GnssDataPool::acquire()
+{
+    mAcquired.fetch_add(1, std::memory_order_relaxed);
+
+    if (mBuffer == nullptr) {
+        ALOGV("[%s, line %d] Allocate GnssData of %zu bytes", __func__, __LINE__,
+              sizeof(MeasurementCb::GnssData));
+        mBuffer = std::make_unique<MeasurementCb::GnssData>();
+        mAllocated.fetch_add(1, std::memory_order_relaxed);
+        return *mBuffer;
+    }
+
+    reset(*mBuffer);
+    return *mBuffer;
+}
+
+void GnssDataPool::release()
+{
+    mBuffer.reset();
+}
+
+GnssDataPool::Stats GnssDataPool::getStats() const
+{
+    Stats stats;
+    stats.acquired = mAcquired.load(std::memory_order_relaxed);
+    stats.allocated = mAllocated.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GnssDataPool::reset(MeasurementCb::GnssData& gnssData)
+{
+    const size_t used = std::min(static_cast<size_t>(gnssData.measurementCount),
+                                 static_cast<size_t>(gnssData.measurements.size()));
+    for (size_t i = 0; i < used; ++i) {
+        gnssData.measurements[i] = MeasurementCb::GnssMeasurement();
+    }
+
+    gnssData.measurementCount = 0;
+    gnssData.clock = MeasurementCb::GnssClock();
+}
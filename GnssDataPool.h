@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSDATAPOOL_H__
+#define __GNSSDATAPOOL_H__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "GnssIParser.h"
+
+/*!
+ * \brief GnssDataPool - GnssData buffer reused by every epoch of the measurement callback
+ * \brief GnssMeasurementCb is synchronous on the thread calling acquire, the buffer is free again
+ * \brief when the next epoch is assembled, so a single buffer is enough
+ */
+class GnssDataPool
+{
+public:
+    /*!
+     * \brief Stats - acquired counts epochs, allocated counts heap allocations of GnssData
+     * \brief on the measurement path, one per measurement session is expected
+     */
+    struct Stats {
+        uint64_t acquired = 0;
+        uint64_t allocated = 0;
+    };
+
+    GnssDataPool() {}
+    ~GnssDataPool() {}
+
+    /*!
+     * \brief acquire - provide the buffer cleared by reset, it is allocated on the first call
+     * \return reference to the buffer, valid until the next acquire
+     */
+    MeasurementCb::GnssData& acquire();
+
+    /*!
+     * \brief release - free the buffer at the end of the measurement session
+     */
+    void release();
+
+    /*!
+     * \brief getStats - provide the counters, may be called from any thread
+     * \return copy of the counters
+     */
+    Stats getStats() const;
+
+    /*!
+     * \brief reset - clear the clock and the used measurement entries only
+     * \param gnssData - buffer to clear
+     */
+    static void reset(MeasurementCb::GnssData& gnssData);
+
+private:
+    GnssDataPool(GnssDataPool const&) = delete;
+    GnssDataPool &operator=(GnssDataPool const&) = delete;
+
+    std::unique_ptr<MeasurementCb::GnssData> mBuffer;
+    std::atomic<uint64_t> mAcquired{0};
+    std::atomic<uint64_t> mAllocated{0};
+};
+
+#endif // __GNSSDATAPOOL_H__
@@ -16,6 +16,8 @@
 
 #define LOG_TAG "GnssRenesasHAL_GnssDebugInterface"
 
+#include <algorithm>
+#include <chrono>
 #include <log/log.h>
 
 #include "GnssDebug.h"
@@ -26,19 +28,93 @@ namespace gnss {
 namespace V1_0 {
 namespace renesas {
 
-GnssDebug::GnssDebug() {}
+typedef IGnssCallback::GnssSvFlags SvFlags;
+
+static const uint16_t hasLatLong = static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
+static const float msInSecond = 1000.0f;
+
+static int64_t NowUtcMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+GnssDebug::GnssDebug(const sp<GnssHwIface>& hwIface) :
+    mGnssHwIface(hwIface)
+{
+}
+
+void GnssDebug::fillPosition(DebugData& data, int64_t nowMs)
+{
+    GnssLocation location = {};
+    if (!mGnssHwIface->GetLocationSnapshot(location) ||
+            !(location.gnssLocationFlags & hasLatLong)) {
+        data.position.valid = false;
+        return;
+    }
+
+    data.position.valid = true;
+    data.position.latitudeDegrees = location.latitudeDegrees;
+    data.position.longitudeDegrees = location.longitudeDegrees;
+    data.position.altitudeMeters = static_cast<float>(location.altitudeMeters);
+    data.position.speedMetersPerSec = location.speedMetersPerSec;
+    data.position.bearingDegrees = location.bearingDegrees;
+    data.position.horizontalAccuracyMeters = location.horizontalAccuracyMeters;
+    data.position.verticalAccuracyMeters = location.verticalAccuracyMeters;
+    data.position.speedAccuracyMetersPerSecond = location.speedAccuracyMetersPerSecond;
+    data.position.bearingAccuracyDegrees = location.bearingAccuracyDegrees;
+    data.position.ageSeconds = static_cast<float>(nowMs - location.timestamp) / msInSecond;
+}
+
+void GnssDebug::fillSatellites(DebugData& data)
+{
+    IGnssCallback::GnssSvStatus svStatus = {};
+    if (!mGnssHwIface->GetSvStatusSnapshot(svStatus)) {
+        return;
+    }
+
+    const size_t count = std::min(static_cast<size_t>(svStatus.numSvs),
+                                  static_cast<size_t>(GnssMax::SVS_COUNT));
+    data.satelliteDataArray.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const IGnssCallback::GnssSvInfo& sv = svStatus.gnssSvList[i];
+        SatelliteData& satellite = data.satelliteDataArray[i];
+
+        satellite.svid = sv.svid;
+        satellite.constellation = sv.constellation;
+        if (sv.svFlag & static_cast<uint8_t>(SvFlags::HAS_EPHEMERIS_DATA)) {
+            satellite.ephemerisType = SatelliteEphemerisType::EPHEMERIS;
+        } else if (sv.svFlag & static_cast<uint8_t>(SvFlags::HAS_ALMANAC_DATA)) {
+            satellite.ephemerisType = SatelliteEphemerisType::ALMANAC_ONLY;
+        } else {
+            satellite.ephemerisType = SatelliteEphemerisType::NOT_AVAILABLE;
+        }
+        satellite.ephemerisSource = SatelliteEphemerisSource::DEMODULATED;
+        satellite.ephemerisHealth = SatelliteEphemerisHealth::UNKNOWN;
+        satellite.ephemerisAgeSeconds = 0.0f;
+        satellite.serverPredictionIsAvailable = false;
+        satellite.serverPredictionAgeSeconds = 0.0f;
+    }
+}
 
 // Methods from ::android::hardware::gnss::V1_0::IGnssDebug follow.
 Return<void> GnssDebug::getDebugData(getDebugData_cb _hidl_cb)  {
-    /*
-     * This is a new interface and hence there is no way to retrieve the
-     * debug data from the HAL.
-     */
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
     DebugData data = {};
+    const int64_t nowMs = NowUtcMs();
+
+    // Snapshots are read lock-free, the parse thread is never held by a debug query
+    if (mGnssHwIface != nullptr) {
+        fillPosition(data, nowMs);
+        fillSatellites(data);
+    }
+
+    // the receiver time is not tracked, the estimate is the system time
+    data.time.timeEstimate = nowMs;
 
     _hidl_cb(data);
 
-    ALOGE("%s: Not implemented", __func__);
     return Void();
 }
 
@@ -20,6 +20,8 @@
 #include <android/hardware/gnss/1.0/IGnssDebug.h>
 #include <hidl/Status.h>
 
+#include "GnssHw.h"
+
 namespace android {
 namespace hardware {
 namespace gnss {
@@ -35,13 +37,26 @@ using ::android::sp;
 
 /* Interface for GNSS Debug support. */
 struct GnssDebug : public IGnssDebug {
-    GnssDebug();
+    GnssDebug(const sp<GnssHwIface>& hwIface);
 
     /*
      * Methods from ::android::hardware::gnss::V1_0::IGnssDebug follow.
      * These declarations were generated from IGnssDebug.hal.
      */
     Return<void> getDebugData(getDebugData_cb _hidl_cb)  override;
+
+private:
+    /*!
+     * \brief fillPosition - fill the position from the snapshot of the last provided fix
+     */
+    void fillPosition(DebugData& data, int64_t nowMs);
+
+    /*!
+     * \brief fillSatellites - fill the satellites from the snapshot of the last SV status
+     */
+    void fillSatellites(DebugData& data);
+
+    sp<GnssHwIface> mGnssHwIface;
 };
 
 }  // namespace renesas
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasEpochBarrier"
+#define LOG_NDEBUG 1
+
+#include <cstring>
+#include <log/log.h>
+#include <cutils/properties.h>
+
+#include "GnssEpochBarrier.h"
+
+static const size_t measurementLane = static_cast<size_t>(GnssEpochBarrier::Lane::Measurement);
+
+GnssEpochBarrier& GnssEpochBarrier::getInstance() {
+    static GnssEpochBarrier instance;
+    return instance;
+}
+
+GnssEpochBarrier::GnssEpochBarrier()
+{
+    char order[PROPERTY_VALUE_MAX] = {};
+    property_get("ro.boot.gps.epoch_order", order, "meas_first");
+    mPolicy = (0 == strcmp(order, "independent")) ? Policy::INDEPENDENT : Policy::MEAS_FIRST;
+    mMaxDelay = std::chrono::milliseconds(property_get_int32("ro.boot.gps.epoch_max_delay_ms", 250));
+
+    ALOGI("Epoch barrier: %s, max delay %lld ms",
+          (Policy::INDEPENDENT == mPolicy) ? "independent" : "measurements first",
+          static_cast<long long>(mMaxDelay.count()));
+}
+
+int64_t GnssEpochBarrier::keyFromUtcMs(int64_t utcMs)
+{
+    const int64_t key = utcMs % mMsInDay;
+    return (key < 0) ? (key + mMsInDay) : key;
+}
+
+int64_t GnssEpochBarrier::keyFromGpsTow(uint32_t iTowMs, int16_t leapSeconds)
+{
+    return keyFromUtcMs(static_cast<int64_t>(iTowMs) - static_cast<int64_t>(leapSeconds) * 1000);
+}
+
+int64_t GnssEpochBarrier::keyDiff(int64_t a, int64_t b)
+{
+    int64_t diff = (a - b) % mMsInDay;
+    if (diff >= mMsInDay / 2) {
+        diff -= mMsInDay;
+    } else if (diff < -mMsInDay / 2) {
+        diff += mMsInDay;
+    }
+
+    return diff;
+}
+
+void GnssEpochBarrier::setPolicy(Policy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mPolicy = policy;
+    }
+
+    mCond.notify_all();
+}
+
+void GnssEpochBarrier::setMaxDelay(std::chrono::milliseconds maxDelay)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mMaxDelay = maxDelay;
+}
+
+void GnssEpochBarrier::setLaneActive(Lane lane, bool active)
+{
+    ALOGV("[%s, line %d] lane %u, active %d", __func__, __LINE__, static_cast<unsigned>(lane), active);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        LaneState& state = mLanes[static_cast<size_t>(lane)];
+        state.active = active;
+        state.delivered = false;
+        state.lastKey = 0;
+    }
+
+    mCond.notify_all();
+}
+
+bool GnssEpochBarrier::isHeld(Lane lane) const
+{
+    return Policy::MEAS_FIRST == mPolicy && Lane::Location == lane &&
+           mLanes[measurementLane].active;
+}
+
+bool GnssEpochBarrier::isReleased(Lane lane, int64_t key) const
+{
+    const LaneState& measurement = mLanes[measurementLane];
+    return !isHeld(lane) || (measurement.delivered && keyDiff(measurement.lastKey, key) >= 0);
+}
+
+bool GnssEpochBarrier::waitTurn(Lane lane, int64_t key)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::unique_lock<std::mutex> lock(mLock);
+    if (!isHeld(lane)) {
+        return true;
+    }
+
+    if (!mLanes[measurementLane].delivered) {
+        // nothing is delivered by the preceding lane in this session yet
+        ALOGV("[%s, line %d] epoch %lld dropped", __func__, __LINE__, static_cast<long long>(key));
+        mStats.dropped++;
+        return false;
+    }
+
+    const LaneState& state = mLanes[static_cast<size_t>(lane)];
+    if (mCond.wait_for(lock, mMaxDelay, [this, &state, lane, key] {
+            return !state.active || isReleased(lane, key);
+        })) {
+        if (!state.active) {
+            // the session of the lane ended, its epoch must not be delivered any more
+            ALOGV("[%s, line %d] epoch %lld dropped, lane is inactive", __func__, __LINE__,
+                  static_cast<long long>(key));
+            mStats.dropped++;
+            return false;
+        }
+        mStats.inOrder++;
+        return true;
+    }
+
+    ALOGV("[%s, line %d] epoch %lld released late", __func__, __LINE__, static_cast<long long>(key));
+    mStats.late++;
+    return true;
+}
+
+void GnssEpochBarrier::release(Lane lane, int64_t key)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        LaneState& state = mLanes[static_cast<size_t>(lane)];
+        state.delivered = true;
+        state.lastKey = key;
+    }
+
+    mCond.notify_all();
+}
+
+GnssEpochBarrier::Stats GnssEpochBarrier::getStats()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mStats;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSEPOCHBARRIER_H__
+#define __GNSSEPOCHBARRIER_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/*!
+ * \brief GnssEpochBarrier - orders the callbacks of the location and the measurement lanes
+ * \brief per GNSS epoch, the epoch key is UTC time of day in ms, so both lanes can compute it:
+ * \brief the location lane from its UTC timestamp, the measurement lane from GPS iTOW
+ */
+class GnssEpochBarrier
+{
+public:
+    enum class Lane : uint8_t {
+        Measurement = 0,
+        Location,
+        LanesCount,
+    };
+
+    /*!
+     * \brief Policy - MEAS_FIRST holds the location of an epoch until the measurements
+     * \brief of the same or a later epoch are delivered, INDEPENDENT never holds a lane
+     */
+    enum class Policy : uint8_t {
+        MEAS_FIRST,
+        INDEPENDENT,
+    };
+
+    /*!
+     * \brief Stats - how the waiting lane was released
+     */
+    struct Stats {
+        uint64_t inOrder = 0;
+        uint64_t late = 0;
+        uint64_t dropped = 0;
+    };
+
+    static constexpr int64_t mMsInDay = 86400000;
+    static constexpr int16_t mDefaultLeapSeconds = 18;
+
+    ~GnssEpochBarrier() {}
+
+    /*!
+     * \brief getInstance - provide an instance of the single object, create if there is no object
+     * \return reference - to the barrier
+     */
+    static GnssEpochBarrier& getInstance();
+
+    /*!
+     * \brief keyFromUtcMs - epoch key of the UTC timestamp
+     * \param utcMs - UTC time in ms since 1970
+     * \return UTC time of day in ms
+     */
+    static int64_t keyFromUtcMs(int64_t utcMs);
+
+    /*!
+     * \brief keyFromGpsTow - epoch key of the GPS time of week
+     * \param iTowMs - GPS time of week in ms
+     * \param leapSeconds - GPS to UTC offset in s
+     * \return UTC time of day in ms
+     */
+    static int64_t keyFromGpsTow(uint32_t iTowMs, int16_t leapSeconds);
+
+    /*!
+     * \brief setPolicy - set the ordering policy, wake up the waiting lane
+     * \param policy - MEAS_FIRST or INDEPENDENT
+     */
+    void setPolicy(Policy policy);
+
+    /*!
+     * \brief setMaxDelay - set the longest time a lane may be held by the other one
+     * \param maxDelay - bound of the wait in waitTurn
+     */
+    void setMaxDelay(std::chrono::milliseconds maxDelay);
+
+    /*!
+     * \brief setLaneActive - register or unregister the lane, e.g. on setCallback and close
+     * \brief an inactive lane never holds the other one, activation forgets delivered epochs
+     * \param lane - the lane
+     * \param active - true if the lane delivers callbacks
+     */
+    void setLaneActive(Lane lane, bool active);
+
+    /*!
+     * \brief waitTurn - wait until the lane may deliver the epoch, at most the max delay
+     * \param lane - the lane
+     * \param key - epoch key
+     * \return true to deliver, false to drop because the preceding lane never delivered yet
+     * \return or the lane was deactivated while waiting
+     */
+    bool waitTurn(Lane lane, int64_t key);
+
+    /*!
+     * \brief release - the lane has delivered the epoch, wake up the lane waiting for it
+     * \param lane - the lane
+     * \param key - epoch key
+     */
+    void release(Lane lane, int64_t key);
+
+    /*!
+     * \brief getStats - provide the counters of the waiting lane
+     * \return copy of the counters
+     */
+    Stats getStats();
+
+private:
+    GnssEpochBarrier();
+    GnssEpochBarrier(GnssEpochBarrier const&) = delete;
+    GnssEpochBarrier &operator=(GnssEpochBarrier const&) = delete;
+
+    struct LaneState {
+        bool active = false;
+        bool delivered = false;
+        int64_t lastKey = 0;
+    };
+
+    /*!
+     * \brief keyDiff - signed difference of two keys, day rollover is taken into account
+     */
+    static int64_t keyDiff(int64_t a, int64_t b);
+
+    /*!
+     * \brief isHeld - check if the lane waits for the other one under the current policy
+     */
+    bool isHeld(Lane lane) const;
+
+    /*!
+     * \brief isReleased - check if the lane may deliver the epoch, called with mLock held
+     */
+    bool isReleased(Lane lane, int64_t key) const;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    Policy mPolicy = Policy::MEAS_FIRST;
+    std::chrono::milliseconds mMaxDelay;
+    LaneState mLanes[static_cast<size_t>(Lane::LanesCount)];
+    Stats mStats;
+};
+
+#endif // __GNSSEPOCHBARRIER_H__
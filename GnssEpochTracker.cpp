@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasEpochTracker"
+#define LOG_NDEBUG 1
+
+#include <inttypes.h>
+#include <log/log.h>
+
+#include "GnssEpochTracker.h"
+
+GnssEpochTracker::GnssEpochTracker(int64_t deadlineMs) :
+    mDeadlineMs(deadlineMs)
+{
+}
+
+bool GnssEpochTracker::isNewEpoch(int64_t tag) const
+{
+    return (tag >= 0 && tag != mTag);
+}
+
+void GnssEpochTracker::open(int64_t tag)
+{
+    ALOGV("[%s, line %d] tag %" PRId64 ", seen 0x%x", __func__, __LINE__, tag, mSeen);
+
+    if (mSeen != 0) {
+        mExpected = mSeen;
+    }
+
+    mTag = tag;
+    mSeen = 0;
+    mParts = 0;
+    mPublished = false;
+}
+
+void GnssEpochTracker::addPart(uint32_t part, int64_t nowMs)
+{
+    mSeen |= part;
+    if (mPublished) {
+        ALOGV("[%s, line %d] part 0x%x after publish", __func__, __LINE__, part);
+        return;
+    }
+
+    if (mParts == 0) {
+        mStartMs = nowMs;
+    }
+
+    mParts |= part;
+}
+
+bool GnssEpochTracker::hasPart(uint32_t part) const
+{
+    return (mSeen & part) != 0;
+}
+
+bool GnssEpochTracker::isPending() const
+{
+    return mParts != 0;
+}
+
+bool GnssEpochTracker::isComplete() const
+{
+    return !mPublished && mExpected != 0 && (mSeen & mExpected) == mExpected;
+}
+
+bool GnssEpochTracker::isExpired(int64_t nowMs) const
+{
+    return isPending() && (nowMs - mStartMs) >= mDeadlineMs;
+}
+
+int64_t GnssEpochTracker::getRemainingMs(int64_t nowMs) const
+{
+    if (!isPending()) {
+        return -1;
+    }
+
+    int64_t remaining = mDeadlineMs - (nowMs - mStartMs);
+    return remaining > 0 ? remaining : 0;
+}
+
+void GnssEpochTracker::close()
+{
+    mParts = 0;
+    mPublished = true;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSEPOCHTRACKER_H__
+#define __GNSSEPOCHTRACKER_H__
+
+#include <cstdint>
+
+/*!
+ * \brief GnssEpochTracker - collects the parts (sentences, talkers) of one navigation epoch
+ * \brief an epoch is delimited by its time tag, the set of expected parts is learned
+ * \brief from the parts observed in the previous epoch
+ */
+class GnssEpochTracker
+{
+public:
+    /*!
+     * \brief GnssEpochTracker - constructor
+     * \param deadlineMs - maximum time a pending epoch waits for missing parts
+     */
+    explicit GnssEpochTracker(int64_t deadlineMs);
+    ~GnssEpochTracker() {}
+
+    /*!
+     * \brief isNewEpoch - check if the time tag belongs to a different epoch
+     * \param tag - epoch time tag, negative if unknown
+     * \return true if tag is known and differs from the current one
+     */
+    bool isNewEpoch(int64_t tag) const;
+
+    /*!
+     * \brief open - start a new epoch, learn expected parts from the previous one
+     * \param tag - epoch time tag, negative if unknown
+     */
+    void open(int64_t tag);
+
+    /*!
+     * \brief addPart - mark the part as received in the current epoch
+     * \brief a part received after close is only learned, the epoch is not published again
+     * \param part - part bit
+     * \param nowMs - current monotonic time
+     */
+    void addPart(uint32_t part, int64_t nowMs);
+
+    /*!
+     * \brief hasPart - check if the part was already received in the current epoch
+     * \param part - part bit
+     * \return true if received
+     */
+    bool hasPart(uint32_t part) const;
+
+    /*!
+     * \brief isPending - check if there are received parts not yet published
+     * \return true if pending
+     */
+    bool isPending() const;
+
+    /*!
+     * \brief isComplete - check if all expected parts are received
+     * \return true if complete, false if incomplete, published or nothing is expected yet
+     */
+    bool isComplete() const;
+
+    /*!
+     * \brief isExpired - check if the pending epoch reached its deadline
+     * \param nowMs - current monotonic time
+     * \return true if expired
+     */
+    bool isExpired(int64_t nowMs) const;
+
+    /*!
+     * \brief getRemainingMs - time left until the deadline of the pending epoch
+     * \param nowMs - current monotonic time
+     * \return remaining time, negative if nothing is pending
+     */
+    int64_t getRemainingMs(int64_t nowMs) const;
+
+    /*!
+     * \brief close - mark pending parts and the epoch as published
+     */
+    void close();
+
+    uint32_t getParts() const { return mParts; }
+    uint32_t getExpected() const { return mExpected; }
+    int64_t getTag() const { return mTag; }
+
+private:
+    const int64_t mDeadlineMs;
+    int64_t  mTag = -1;
+    int64_t  mStartMs = 0;
+    uint32_t mParts = 0;
+    uint32_t mSeen = 0;
+    uint32_t mExpected = 0;
+    bool     mPublished = false;
+};
+
+#endif // __GNSSEPOCHTRACKER_H__
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSFIXLATENCY_H__
+#define __GNSSFIXLATENCY_H__
+
+#include <atomic>
+#include <cstdint>
+
+/*!
+ * \brief GnssFixLatency - latency from the reception of a fix to posting its location
+ * \brief recorded by the parse threads or the reactor, reset and read by the binder thread
+ * \brief the counters are relaxed atomics, a read during a record may miss that one fix
+ */
+class GnssFixLatency
+{
+public:
+    struct Stats {
+        uint64_t count = 0;
+        int64_t  avgUs = 0;
+        int64_t  maxUs = 0;
+    };
+
+    /*!
+     * \brief Reset - clear the counters at the session start
+     */
+    void Reset()
+    {
+        mCount.store(0, std::memory_order_relaxed);
+        mTotalUs.store(0, std::memory_order_relaxed);
+        mMaxUs.store(0, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Record - account one posted fix
+     * \param receivedNs - reception time of the last frame of the fix, elapsed realtime
+     * \param nowNs - time the location is posted, elapsed realtime
+     */
+    void Record(int64_t receivedNs, int64_t nowNs)
+    {
+        if (receivedNs <= 0) {
+            return;
+        }
+
+        const int64_t latencyUs = (nowNs - receivedNs) / 1000;
+        mCount.fetch_add(1, std::memory_order_relaxed);
+        mTotalUs.fetch_add(latencyUs, std::memory_order_relaxed);
+
+        int64_t maxUs = mMaxUs.load(std::memory_order_relaxed);
+        while (latencyUs > maxUs &&
+               !mMaxUs.compare_exchange_weak(maxUs, latencyUs, std::memory_order_relaxed)) {
+        }
+    }
+
+    /*!
+     * \brief GetStats - counters of the current session
+     * \return number of fixes, average and maximum latency in microseconds
+     */
+    Stats GetStats() const
+    {
+        Stats stats;
+        stats.count = mCount.load(std::memory_order_relaxed);
+        const int64_t totalUs = mTotalUs.load(std::memory_order_relaxed);
+        stats.avgUs = (stats.count > 0) ? totalUs / static_cast<int64_t>(stats.count) : 0;
+        stats.maxUs = mMaxUs.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::atomic<uint64_t> mCount{0};
+    std::atomic<int64_t>  mTotalUs{0};
+    std::atomic<int64_t>  mMaxUs{0};
+};
+
+#endif // __GNSSFIXLATENCY_H__
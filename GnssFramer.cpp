@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasFramer"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <log/log.h>
+
+#include "GnssFramer.h"
+
+struct UbxClassLimit {
+    uint8_t  cl;
+    uint16_t maxPayloadLen;
+};
+
+// Longest payloads of the classes the HAL configures or polls,
+// repeated blocks are bounded by their 8-bit counters
+static const UbxClassLimit ubxClassLimits[] = {
+    {0x01, 3072},                          // NAV: NAV-SAT/NAV-SVINFO, 8 + 12 * 255
+    {0x02, GnssFramer::mMaxUbxPayloadLen}, // RXM: RXM-RAWX, 16 + 32 * 255
+    {0x05, 2},                             // ACK
+    {0x06, 2048},                          // CFG: CFG-GNSS, 4 + 8 * 255
+    {0x0A, 2048},                          // MON: MON-VER with extensions
+};
+
+static const uint16_t ubxDefaultMaxPayloadLen = 1024;
+
+GnssFramer::GnssFramer(Sink& sink) :
+    mSink(sink)
+{
+    ALOGV("[%s, line %d] Constructor", __func__, __LINE__);
+    SetAllUbxWanted(true);
+    SetAllNmeaWanted(true);
+}
+
+uint16_t GnssFramer::GetMaxPayloadLen(uint8_t cl)
+{
+    for (const UbxClassLimit& limit : ubxClassLimits) {
+        if (limit.cl == cl) {
+            return limit.maxPayloadLen;
+        }
+    }
+
+    return ubxDefaultMaxPayloadLen;
+}
+
+void GnssFramer::SetUbxWanted(uint8_t cl, uint8_t id, bool wanted)
+{
+    const size_t bit = (static_cast<size_t>(cl) << 8) | id;
+    const uint64_t mask = 1ull << (bit % mBitsPerWord);
+
+    if (wanted) {
+        mUbxWanted[bit / mBitsPerWord].fetch_or(mask, std::memory_order_relaxed);
+    } else {
+        mUbxWanted[bit / mBitsPerWord].fetch_and(~mask, std::memory_order_relaxed);
+    }
+}
+
+void GnssFramer::SetAllUbxWanted(bool wanted)
+{
+    for (auto& word : mUbxWanted) {
+        word.store(wanted ? UINT64_MAX : 0, std::memory_order_relaxed);
+    }
+}
+
+bool GnssFramer::IsUbxWanted(uint8_t cl, uint8_t id) const
+{
+    const size_t bit = (static_cast<size_t>(cl) << 8) | id;
+    return (mUbxWanted[bit / mBitsPerWord].load(std::memory_order_relaxed) >>
+            (bit % mBitsPerWord)) & 1;
+}
+
+bool GnssFramer::GetNmeaTypeIndex(const uint8_t* type, size_t& index)
+{
+    index = 0;
+    for (size_t i = 0; i < mNmeaTypeLen; i++) {
+        if (type[i] < 'A' || type[i] > 'Z') {
+            return false;
+        }
+        index = index * 26 + static_cast<size_t>(type[i] - 'A');
+    }
+
+    return true;
+}
+
+void GnssFramer::SetNmeaWanted(const char* type, bool wanted)
+{
+    size_t index;
+    if (strnlen(type, mNmeaTypeLen) < mNmeaTypeLen ||
+            !GetNmeaTypeIndex(reinterpret_cast<const uint8_t*>(type), index)) {
+        ALOGW("[%s, line %d] Invalid NMEA type %s", __func__, __LINE__, type);
+        return;
+    }
+
+    const uint64_t mask = 1ull << (index % mBitsPerWord);
+    if (wanted) {
+        mNmeaWanted[index / mBitsPerWord].fetch_or(mask, std::memory_order_relaxed);
+    } else {
+        mNmeaWanted[index / mBitsPerWord].fetch_and(~mask, std::memory_order_relaxed);
+    }
+}
+
+void GnssFramer::SetAllNmeaWanted(bool wanted)
+{
+    for (auto& word : mNmeaWanted) {
+        word.store(wanted ? UINT64_MAX : 0, std::memory_order_relaxed);
+    }
+}
+
+bool GnssFramer::IsNmeaWanted(const char* type) const
+{
+    size_t index;
+    if (strnlen(type, mNmeaTypeLen) < mNmeaTypeLen ||
+            !GetNmeaTypeIndex(reinterpret_cast<const uint8_t*>(type), index)) {
+        return true;
+    }
+
+    return (mNmeaWanted[index / mBitsPerWord].load(std::memory_order_relaxed) >>
+            (index % mBitsPerWord)) & 1;
+}
+
+void GnssFramer::CountSkipped(uint32_t key)
+{
+    mSkipped++;
+
+    for (size_t i = 0; i < mSkippedTypesCount; i++) {
+        if (mSkippedTypes[i].key == key) {
+            mSkippedTypes[i].count++;
+            return;
+        }
+    }
+
+    if (mSkippedTypesCount < mMaxSkippedTypes) {
+        mSkippedTypes[mSkippedTypesCount++] = {key, 1};
+    } else {
+        mSkippedOther++;
+    }
+}
+
+uint64_t GnssFramer::GetSkippedCount(uint32_t key) const
+{
+    for (size_t i = 0; i < mSkippedTypesCount; i++) {
+        if (mSkippedTypes[i].key == key) {
+            return mSkippedTypes[i].count;
+        }
+    }
+
+    return 0;
+}
+
+uint64_t GnssFramer::GetUbxSkippedCount(uint8_t cl, uint8_t id) const
+{
+    return GetSkippedCount((static_cast<uint32_t>(cl) << 8) | id);
+}
+
+uint64_t GnssFramer::GetNmeaSkippedCount(const char* type) const
+{
+    size_t index;
+    if (strnlen(type, mNmeaTypeLen) < mNmeaTypeLen ||
+            !GetNmeaTypeIndex(reinterpret_cast<const uint8_t*>(type), index)) {
+        return 0;
+    }
+
+    return GetSkippedCount(mNmeaKeyFlag | static_cast<uint32_t>(index));
+}
+
+void GnssFramer::LogSkippedCounters() const
+{
+    ALOGI("Framer skipped %" PRIu64 " unwanted frames", mSkipped);
+
+    for (size_t i = 0; i < mSkippedTypesCount; i++) {
+        const uint32_t key = mSkippedTypes[i].key;
+
+        if (key & mNmeaKeyFlag) {
+            const uint32_t index = key & ~mNmeaKeyFlag;
+            ALOGI("  NMEA %c%c%c: %" PRIu64, 'A' + index / (26 * 26), 'A' + index / 26 % 26,
+                  'A' + index % 26, mSkippedTypes[i].count);
+        } else {
+            ALOGI("  UBX %02X %02X: %" PRIu64, key >> 8, key & 0xFF, mSkippedTypes[i].count);
+        }
+    }
+
+    if (mSkippedOther > 0) {
+        ALOGI("  other: %" PRIu64, mSkippedOther);
+    }
+}
+
+void GnssFramer::Fletcher8(const uint8_t* data, size_t len, uint8_t& ckA, uint8_t& ckB)
+{
+    uint32_t a = ckA;
+    uint32_t b = ckB;
+
+    // For a chunk x[0..n): A' = A + sum(x[i]), B' = B + n * A + sum((n - i) * x[i]),
+    // both sums are plain reductions the compiler can vectorize
+    while (len > 0) {
+        const size_t n = std::min(len, mFletcherChunk);
+        uint32_t sum = 0;
+        uint32_t weighted = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            sum += data[i];
+            weighted += static_cast<uint32_t>(n - i) * data[i];
+        }
+
+        b = (b + static_cast<uint32_t>(n) * a + weighted) & 0xFF;
+        a = (a + sum) & 0xFF;
+        data += n;
+        len -= n;
+    }
+
+    ckA = static_cast<uint8_t>(a);
+    ckB = static_cast<uint8_t>(b);
+}
+
+void GnssFramer::Push(const uint8_t* data, size_t len)
+{
+    while (len > 0) {
+        if (mSkipMode != SkipMode::NONE) {
+            const size_t used = SkipInput(data, len);
+            data += used;
+            len -= used;
+            continue;
+        }
+
+        const size_t n = std::min(len, mBufferSize - mLen);
+        if (n == 0) {
+            // cannot happen, a full buffer always holds a complete or an invalid frame
+            ALOGE("[%s, line %d] Framer buffer overflow", __func__, __LINE__);
+            mDiscardedBytes += mLen;
+            Reset();
+            continue;
+        }
+
+        memcpy(&mBuffer[mLen], data, n);
+        mLen += n;
+        data += n;
+        len -= n;
+
+        Scan();
+    }
+}
+
+void GnssFramer::Reset()
+{
+    mLen = 0;
+    mScanned = 0;
+    mCkA = 0;
+    mCkB = 0;
+    mSkipMode = SkipMode::NONE;
+}
+
+void GnssFramer::Consume(size_t len)
+{
+    mLen -= len;
+    memmove(mBuffer, &mBuffer[len], mLen);
+    mScanned = 0;
+    mCkA = 0;
+    mCkB = 0;
+}
+
+void GnssFramer::SkipToFrameStart(size_t from)
+{
+    size_t pos = from;
+    size_t discarded = 0;
+
+    for (; pos < mLen; pos++) {
+        const uint8_t ch = mBuffer[pos];
+        if (ch == '$' || ch == mUbxSync1) {
+            break;
+        }
+
+        // line endings between sentences are not garbage
+        if (ch != '\r' && ch != '\n') {
+            discarded++;
+        }
+    }
+
+    mDiscardedBytes += discarded;
+    Consume(pos);
+}
+
+void GnssFramer::Resync()
+{
+    ALOGV("[%s, line %d] Resync after %02X", __func__, __LINE__, mBuffer[0]);
+    mResyncs++;
+    mDiscardedBytes++;
+    SkipToFrameStart(1);
+}
+
+bool GnssFramer::ScanUbx()
+{
+    if (mLen < 2) {
+        return false;
+    }
+
+    if (mBuffer[1] != mUbxSync2) {
+        Resync();
+        return true;
+    }
+
+    if (mLen < mUbxHeaderSize) {
+        return false;
+    }
+
+    const uint8_t cl = mBuffer[2];
+    const uint8_t id = mBuffer[3];
+    const uint16_t payloadLen = static_cast<uint16_t>(mBuffer[4] | (mBuffer[5] << 8));
+
+    if (payloadLen > GetMaxPayloadLen(cl)) {
+        ALOGW("[%s, line %d] UBX class %02X length %u exceeds limit", __func__, __LINE__,
+              cl, payloadLen);
+        mLengthErrors++;
+        Resync();
+        return true;
+    }
+
+    // checksum covers class, id, length and payload, continue from the last call
+    const size_t checksumEnd = mUbxHeaderSize + payloadLen;
+    const size_t checksumFrom = std::max(mScanned, static_cast<size_t>(2));
+    const size_t checksumTo = std::min(mLen, checksumEnd);
+    if (checksumTo > checksumFrom) {
+        Fletcher8(&mBuffer[checksumFrom], checksumTo - checksumFrom, mCkA, mCkB);
+        mScanned = checksumTo;
+    }
+
+    // unwanted frames are buffered as well, the header is not trusted before the checksum
+    if (mLen < checksumEnd + mUbxChecksumSize) {
+        return false;
+    }
+
+    if (mBuffer[checksumEnd] != mCkA || mBuffer[checksumEnd + 1] != mCkB) {
+        ALOGW("[%s, line %d] UBX %02X %02X checksum fail %02X%02X/%02X%02X", __func__, __LINE__,
+              cl, id, mBuffer[checksumEnd], mBuffer[checksumEnd + 1], mCkA, mCkB);
+        mChecksumErrors++;
+        Resync();
+        return true;
+    }
+
+    if (IsUbxWanted(cl, id)) {
+        mUbxFrames++;
+        mSink.OnUbxFrame(cl, id, &mBuffer[mUbxHeaderSize], payloadLen);
+    } else {
+        CountSkipped((static_cast<uint32_t>(cl) << 8) | id);
+    }
+
+    Consume(checksumEnd + mUbxChecksumSize);
+
+    return true;
+}
+
+bool GnssFramer::ScanNmea()
+{
+    const size_t scanTo = std::min(mLen, mMaxNmeaLen + 1);
+    size_t typeIndex;
+    bool wanted = true;
+
+    // proprietary sentences ($P...) are not filtered
+    if (mLen >= mNmeaHeaderSize && mBuffer[1] != 'P' &&
+            GetNmeaTypeIndex(&mBuffer[mNmeaHeaderSize - mNmeaTypeLen], typeIndex)) {
+        wanted = (mNmeaWanted[typeIndex / mBitsPerWord].load(std::memory_order_relaxed) >>
+                  (typeIndex % mBitsPerWord)) & 1;
+    }
+
+    for (size_t pos = std::max(mScanned, static_cast<size_t>(1)); pos < scanTo; pos++) {
+        const uint8_t ch = mBuffer[pos];
+
+        if (ch == '\r' || ch == '\n') {
+            if (wanted) {
+                mNmeaFrames++;
+                mSink.OnNmeaFrame(reinterpret_cast<const char*>(mBuffer), pos);
+            } else {
+                CountSkipped(mNmeaKeyFlag | static_cast<uint32_t>(typeIndex));
+            }
+            Consume(pos + 1);
+            return true;
+        }
+
+        if (ch == '$') {
+            // missed end of the sentence, restart from the new one
+            mDiscardedBytes += pos;
+            Consume(pos);
+            return true;
+        }
+    }
+
+    if (mLen > mMaxNmeaLen) {
+        ALOGW("[%s, line %d] NMEA sentence is too long", __func__, __LINE__);
+        mLengthErrors++;
+        Resync();
+        return true;
+    }
+
+    if (!wanted) {
+        // unwanted sentence, the rest of it is dropped straight from the input
+        mSkipMode = SkipMode::NMEA;
+        mSkipKey = mNmeaKeyFlag | static_cast<uint32_t>(typeIndex);
+        mSkipRemaining = mMaxNmeaLen + 1 - mLen;
+        Consume(mLen);
+        return false;
+    }
+
+    mScanned = mLen;
+    return false;
+}
+
+size_t GnssFramer::SkipInput(const uint8_t* data, size_t len)
+{
+    // NMEA sentence ends with CR LF, the start of a new frame ends it as well
+    const size_t limit = std::min(len, mSkipRemaining);
+    for (size_t pos = 0; pos < limit; pos++) {
+        const uint8_t ch = data[pos];
+
+        if (ch == '\r' || ch == '\n') {
+            CountSkipped(mSkipKey);
+            mSkipMode = SkipMode::NONE;
+            return pos + 1;
+        }
+
+        if (ch == '$' || ch == mUbxSync1) {
+            CountSkipped(mSkipKey);
+            mSkipMode = SkipMode::NONE;
+            return pos;
+        }
+    }
+
+    mSkipRemaining -= limit;
+    if (mSkipRemaining == 0) {
+        // too long, the rest of it is discarded as garbage by the scanner
+        mLengthErrors++;
+        mSkipMode = SkipMode::NONE;
+    }
+
+    return limit;
+}
+
+void GnssFramer::Scan()
+{
+    bool more = true;
+
+    while (more && mLen > 0) {
+        if (mBuffer[0] == mUbxSync1) {
+            more = ScanUbx();
+        } else if (mBuffer[0] == '$') {
+            more = ScanNmea();
+        } else {
+            SkipToFrameStart(0);
+        }
+    }
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSFRAMER_H__
+#define __GNSSFRAMER_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * \brief GnssFramer - splits the receiver byte stream into NMEA sentences and UBX frames
+ * \brief UBX length is validated against the per-class maximum and the Fletcher-8 checksum
+ * \brief is computed while the frame is received, a corrupted frame is dropped and the
+ * \brief stream is rescanned from the byte after its sync for the next frame start
+ * \brief unwanted UBX frames are buffered and verified like wanted ones, only their delivery
+ * \brief is skipped, so a corrupted header is resynced; unwanted NMEA sentences are dropped
+ * \brief straight from the input, they end at the next CR LF or frame start
+ */
+class GnssFramer
+{
+public:
+    /*!
+     * \brief Sink - receiver of complete and validated frames
+     */
+    class Sink
+    {
+    public:
+        virtual ~Sink() {}
+
+        /*!
+         * \brief OnNmeaFrame - NMEA sentence received
+         * \param sentence - sentence starting with '$', without CR LF, not null terminated
+         * \param len - sentence length in bytes
+         */
+        virtual void OnNmeaFrame(const char* sentence, size_t len) = 0;
+
+        /*!
+         * \brief OnUbxFrame - UBX frame with valid checksum received
+         * \param cl - message class
+         * \param id - message id
+         * \param payload - pointer to the payload, valid during the call only
+         * \param len - payload length in bytes
+         */
+        virtual void OnUbxFrame(uint8_t cl, uint8_t id, const uint8_t* payload, uint16_t len) = 0;
+    };
+
+    static constexpr uint16_t mMaxUbxPayloadLen = 8176;
+    static constexpr size_t   mMaxNmeaLen = 127;
+
+    explicit GnssFramer(Sink& sink);
+    ~GnssFramer() {}
+
+    /*!
+     * \brief Push - feed bytes read from the receiver, frames are delivered to the sink
+     * \param data - received bytes
+     * \param len - number of received bytes
+     */
+    void Push(const uint8_t* data, size_t len);
+
+    /*!
+     * \brief Reset - drop the partially received frame, counters are kept
+     */
+    void Reset();
+
+    /*!
+     * \brief GetMaxPayloadLen - provide the largest valid payload length of the UBX class
+     * \param cl - message class
+     * \return maximum payload length in bytes
+     */
+    static uint16_t GetMaxPayloadLen(uint8_t cl);
+
+    /*!
+     * \brief SetUbxWanted - select if the UBX message is delivered, all are wanted initially
+     * \brief may be called from any thread
+     * \param cl - message class
+     * \param id - message id
+     * \param wanted - true to deliver, false to skip
+     */
+    void SetUbxWanted(uint8_t cl, uint8_t id, bool wanted);
+
+    /*!
+     * \brief SetAllUbxWanted - select if all UBX messages are delivered
+     * \param wanted - true to deliver, false to skip
+     */
+    void SetAllUbxWanted(bool wanted);
+
+    /*!
+     * \brief SetNmeaWanted - select if the NMEA sentence type is delivered, all are wanted initially
+     * \brief proprietary sentences ($P...) are always delivered, may be called from any thread
+     * \param type - sentence formatter, e.g. "GLL"
+     * \param wanted - true to deliver, false to skip
+     */
+    void SetNmeaWanted(const char* type, bool wanted);
+
+    /*!
+     * \brief SetAllNmeaWanted - select if all NMEA sentence types are delivered
+     * \param wanted - true to deliver, false to skip
+     */
+    void SetAllNmeaWanted(bool wanted);
+
+    bool IsUbxWanted(uint8_t cl, uint8_t id) const;
+    bool IsNmeaWanted(const char* type) const;
+
+    /*!
+     * \brief GetUbxSkippedCount - number of skipped frames of the UBX message
+     */
+    uint64_t GetUbxSkippedCount(uint8_t cl, uint8_t id) const;
+
+    /*!
+     * \brief GetNmeaSkippedCount - number of skipped sentences of the type
+     */
+    uint64_t GetNmeaSkippedCount(const char* type) const;
+
+    /*!
+     * \brief LogSkippedCounters - print per type counters of skipped frames,
+     * \brief used to tune the receiver message rates
+     */
+    void LogSkippedCounters() const;
+
+    /*!
+     * \brief Fletcher8 - continue the UBX (8-bit Fletcher) checksum over the data
+     * \brief the data is summed in fixed size chunks without a dependency between bytes
+     * \param data - data to add
+     * \param len - data length in bytes
+     * \param ckA - first checksum byte, updated
+     * \param ckB - second checksum byte, updated
+     */
+    static void Fletcher8(const uint8_t* data, size_t len, uint8_t& ckA, uint8_t& ckB);
+
+    uint64_t GetUbxFrameCount() const { return mUbxFrames; }
+    uint64_t GetNmeaFrameCount() const { return mNmeaFrames; }
+    uint64_t GetChecksumErrorCount() const { return mChecksumErrors; }
+    uint64_t GetLengthErrorCount() const { return mLengthErrors; }
+    uint64_t GetResyncCount() const { return mResyncs; }
+    uint64_t GetDiscardedBytesCount() const { return mDiscardedBytes; }
+    uint64_t GetSkippedCount() const { return mSkipped; }
+
+private:
+    static constexpr uint8_t mUbxSync1 = 0xB5;
+    static constexpr uint8_t mUbxSync2 = 0x62;
+    static constexpr size_t  mUbxHeaderSize = 6;
+    static constexpr size_t  mUbxChecksumSize = 2;
+    static constexpr size_t  mFletcherChunk = 64;
+    static constexpr size_t  mBufferSize = mUbxHeaderSize + mMaxUbxPayloadLen + mUbxChecksumSize;
+    static constexpr size_t  mNmeaHeaderSize = 6;  // '$', talker, formatter
+    static constexpr size_t  mNmeaTypeLen = 3;
+    static constexpr size_t  mNmeaTypesCount = 26 * 26 * 26;
+    static constexpr size_t  mBitsPerWord = 64;
+    static constexpr size_t  mUbxWantedWords = 256 * 256 / mBitsPerWord;
+    static constexpr size_t  mNmeaWantedWords = (mNmeaTypesCount + mBitsPerWord - 1) / mBitsPerWord;
+    static constexpr size_t  mMaxSkippedTypes = 32;
+    static constexpr uint32_t mNmeaKeyFlag = 1u << 16;
+
+    enum class SkipMode {
+        NONE,
+        NMEA
+    };
+
+    struct SkippedType {
+        uint32_t key;
+        uint64_t count;
+    };
+
+    /*!
+     * \brief GetNmeaTypeIndex - index of the sentence formatter in the NMEA bitmap
+     * \param type - three upper case letters
+     * \param index - output index
+     * \return false if the formatter is not three upper case letters
+     */
+    static bool GetNmeaTypeIndex(const uint8_t* type, size_t& index);
+
+    /*!
+     * \brief CountSkipped - add skipped frame to its type counter
+     * \param key - (class << 8 | id) for UBX, mNmeaKeyFlag | type index for NMEA
+     */
+    void CountSkipped(uint32_t key);
+    uint64_t GetSkippedCount(uint32_t key) const;
+
+    /*!
+     * \brief SkipInput - drop the rest of an unwanted sentence directly from the input
+     * \param data - received bytes
+     * \param len - number of received bytes
+     * \return number of bytes used
+     */
+    size_t SkipInput(const uint8_t* data, size_t len);
+
+    /*!
+     * \brief Scan - deliver all complete frames from the buffer, keep the incomplete one
+     */
+    void Scan();
+
+    /*!
+     * \brief ScanUbx - handle the buffer starting with UBX sync
+     * \return true if the buffer was consumed and scanning continues, false if more data needed
+     */
+    bool ScanUbx();
+
+    /*!
+     * \brief ScanNmea - handle the buffer starting with '$'
+     * \return true if the buffer was consumed and scanning continues, false if more data needed
+     */
+    bool ScanNmea();
+
+    /*!
+     * \brief SkipToFrameStart - drop bytes until a possible frame start
+     * \param from - first byte which may start a frame
+     */
+    void SkipToFrameStart(size_t from);
+
+    /*!
+     * \brief Resync - drop the current frame start and rescan the bytes after it
+     */
+    void Resync();
+
+    /*!
+     * \brief Consume - remove bytes from the beginning of the buffer
+     * \param len - number of bytes
+     */
+    void Consume(size_t len);
+
+    Sink&    mSink;
+    uint8_t  mBuffer[mBufferSize];
+    size_t   mLen = 0;
+
+    // state of the frame at the beginning of the buffer
+    size_t   mScanned = 0;
+    uint8_t  mCkA = 0;
+    uint8_t  mCkB = 0;
+
+    uint64_t mUbxFrames = 0;
+    uint64_t mNmeaFrames = 0;
+    uint64_t mChecksumErrors = 0;
+    uint64_t mLengthErrors = 0;
+    uint64_t mResyncs = 0;
+    uint64_t mDiscardedBytes = 0;
+
+    std::atomic<uint64_t> mUbxWanted[mUbxWantedWords];
+    std::atomic<uint64_t> mNmeaWanted[mNmeaWantedWords];
+
+    // rest of the unwanted sentence which did not fit the buffer
+    SkipMode mSkipMode = SkipMode::NONE;
+    size_t   mSkipRemaining = 0;
+    uint32_t mSkipKey = 0;
+
+    uint64_t    mSkipped = 0;
+    uint64_t    mSkippedOther = 0;
+    SkippedType mSkippedTypes[mMaxSkippedTypes] = {};
+    size_t      mSkippedTypesCount = 0;
+};
+
+#endif // __GNSSFRAMER_H__
@@ -18,6 +18,8 @@
 #define GNSS_HW_H_
 
 #include <utils/RefBase.h>
+#include <sys/resource.h>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <string>
@@ -27,6 +29,16 @@
 #include <log/log.h>
 
 #include "circular_buffer.h"
+#include "GnssFramer.h"
+#include "GnssSvTable.h"
+#include "GnssEpochTracker.h"
+#include "GnssCallbackFilter.h"
+#include "GnssCallbackExecutor.h"
+#include "GnssReactor.h"
+#include "GnssSeqlock.h"
+#include "GnssFixLatency.h"
+#include "GnssNmeaPassthrough.h"
+#include "GnssNmeaGenerator.h"
 #include <android/hardware/gnss/1.0/IGnss.h>
 
 using namespace std::chrono_literals;
@@ -53,44 +65,78 @@ public:
     virtual bool setUpdatePeriod(int) = 0;
     virtual uint16_t GetYearOfHardware() = 0;
 
+    /*!
+     * \brief SetNavigationMessageEnabled - turn on/off the output of navigation message subframes
+     * \param enable - true to turn on, false to turn off
+     * \return true if the receiver supports navigation messages
+     */
+    virtual bool SetNavigationMessageEnabled(bool) { return false; }
+
     void setCallback(const android::sp<::IGnssCallback>& callback) {
         mGnssCb = callback;
     }
 
+    /*!
+     * \brief GetLocationSnapshot - provide a consistent copy of the last provided fix
+     * \brief lock-free, may be called from any thread
+     * \param location - output location
+     * \return false if no fix was provided yet
+     */
+    bool GetLocationSnapshot(GnssLocation& location) const { return mLocationSnapshot.load(location); }
+
+    /*!
+     * \brief GetSvStatusSnapshot - provide a consistent copy of the last provided SV status
+     * \brief lock-free, may be called from any thread
+     * \param svStatus - output SV status
+     * \return false if no SV status was provided yet
+     */
+    bool GetSvStatusSnapshot(IGnssCallback::GnssSvStatus& svStatus) const
+    {
+        return mSvStatusSnapshot.load(svStatus);
+    }
+
     std::atomic<bool>               mThreadExit;
     android::sp<IGnssCallback>      mGnssCb = nullptr;
 
+    bool                            mResetReceiverOnStart = false;
+
+protected:
+    // working copies of the parse thread, other threads read the snapshots
     GnssLocation                    mGnssLocation = {};
     IGnssCallback::GnssSvStatus     mSvStatus = {};
 
-    bool                            mResetReceiverOnStart = false;
+    GnssSeqlock<GnssLocation>                mLocationSnapshot;
+    GnssSeqlock<IGnssCallback::GnssSvStatus> mSvStatusSnapshot;
 
 private:
     std::thread         mThread;
 };
 
-class GnssHwTTY : public GnssHwIface
+class GnssHwTTY : public GnssHwIface, private GnssFramer::Sink, private GnssReactor::Handler
 {
-    enum class ReaderState {
-        WAITING,
-        CAPTURING_NMEA,
-        WAITING_UBX_SYNC2,
-        CAPTURING_UBX
-    };
-
     static const size_t mNmeaBufferSize = 128;
     static const size_t mUbxBufferSize  = 65536;
+    static const size_t mReadChunkSize  = 256;
 
     int          mFd;
     bool         mEnabled;
-    uint8_t      mReaderBuf[mUbxBufferSize];
-    size_t       mReaderBufPos = 0;
-    ReaderState  mReaderState  = ReaderState::WAITING;
+    GnssFramer   mFramer{*this};
 
     bool mIsKingfisher = false;
     bool mIsUbloxDevice = false;
     uint16_t mUbxGeneration = 0;
 
+    // UBX-only output: location comes from UBX-NAV-PVT instead of NMEA sentences
+    bool mUbxOnly = false;
+    // SV status comes from UBX-NAV-SAT/UBX-NAV-SVINFO instead of GSV and GSA
+    bool mUbxSvStatus = false;
+
+    // UBX-RXM-SFRBX output requested by the navigation message client,
+    // applied by the init thread if requested before the receiver is configured
+    std::mutex mNavMsgLock;
+    bool mNavMsgRequested = false;
+    bool mUbxInitDone = false;
+
     size_t mRmcFieldsNumber;
     size_t mGsaFieldsNumber;
 
@@ -100,12 +146,18 @@ class GnssHwTTY : public GnssHwIface
     uint16_t mYearOfHardware = 0; // for under 2016 year zero is legal value.
 
     struct NmeaBufferElement {
-        char data[mNmeaBufferSize];
+        char    data[mNmeaBufferSize];
+        int64_t timestampMs; // UTC time of reception
+        int64_t receivedNs;  // elapsed realtime of reception
     };
 
+    // validated UBX frame, sync and checksum are stripped by the framer
     struct UbxBufferElement {
-        uint8_t data[mUbxBufferSize];
-        size_t  len;
+        uint8_t  cl;
+        uint8_t  id;
+        uint16_t len;
+        int64_t  receivedNs; // elapsed realtime of reception
+        uint8_t  payload[GnssFramer::mMaxUbxPayloadLen];
     };
 
     CircularBuffer<NmeaBufferElement> *mNmeaBuffer;
@@ -115,6 +167,23 @@ class GnssHwTTY : public GnssHwIface
     std::thread mUbxThread;
     std::thread mHwInitThread;
 
+    // Reactor mode: one thread initializes the receiver, then reads the TTY,
+    // frames and parses inline, the epoch deadlines are served by its timer
+    bool mReactorMode = false;
+    std::unique_ptr<GnssReactor> mReactor;
+    std::thread mReactorThread;
+
+    // reception time of the frame being parsed, each one is owned by its parse thread,
+    // both are owned by the reactor thread in the reactor mode
+    int64_t mNmeaReceivedNs = 0;
+    int64_t mUbxReceivedNs = 0;
+
+    GnssFixLatency mFixLatency;
+
+    // process resource usage at the session start, compared on stop
+    struct rusage mSessionUsage = {};
+    int64_t mSessionStartNs = 0;
+
     std::atomic<bool> mHelpThreadExit;
 
     std::condition_variable mNmeaThreadCv;
@@ -139,9 +208,41 @@ class GnssHwTTY : public GnssHwIface
         COUNT         = 5,
         UNKNOWN       = 6
     };
-    std::vector<IGnssCallback::GnssSvInfo> mSatellites[static_cast<int>(SatelliteType::COUNT)];
+    GnssSvTable mSvTable;
+
+    // GLONASS SVID can be equal to zero, which is not acceptable by Android
+    // in this case we are supposed to report FCN (frequency channel number),
+    // we don't have a real one, so let's use a simulated one
+    int16_t mGlonassFakeFcn = 93;
+
+    // SV status is published once per navigation epoch, a missing GSV sentence
+    // may delay it for at most mEpochDeadlineMs
+    static const int64_t mEpochDeadlineMs = 800;
+    GnssEpochTracker mSvEpoch{mEpochDeadlineMs};
+
+    // Location is assembled from all sentences of the same fix time
+    // and published once per navigation epoch
+    enum class FixPart : uint32_t {
+        RMC  = 1 << 0,
+        GGA  = 1 << 1,
+        GSA  = 1 << 2,
+        PUBX = 1 << 3
+    };
+    GnssEpochTracker mFixEpoch{mEpochDeadlineMs};
+    GnssLocation mPendingLocation;
+    bool mPendingFixValid = false;
+    uint8_t mPendingFixType = 0;
+    // reception time of the last sentence added to the pending fix
+    int64_t mPendingFixReceivedNs = 0;
+
+    GnssCallbackFilter mCallbackFilter{GnssCallbackFilter::readConfig()};
+
+    // location and SV status are delivered by the executor, parsing never waits for the client
+    GnssCallbackExecutor mCallbackExecutor;
 
-    std::vector<int64_t> mSatellitesUsedInFix[static_cast<int>(SatelliteType::COUNT)];
+    GnssNmeaPassthrough mNmeaPassthrough;
+    // NMEA for passthrough clients when the receiver outputs UBX only
+    GnssNmeaGenerator mNmeaGenerator{mNmeaPassthrough};
 
     enum class MajorGnssStatus {
         GPS_GLONASS,
@@ -155,42 +256,43 @@ class GnssHwTTY : public GnssHwIface
     bool CheckHwPropertyKf();
     void resetOnStart();
 
-    void ReaderPushChar(unsigned char ch);
+    void OnNmeaFrame(const char* sentence, size_t len) override;
+    void OnUbxFrame(uint8_t cl, uint8_t id, const uint8_t* payload, uint16_t len) override;
+    bool OnReadable(int fd) override;
+    void OnTimeout() override;
+    void ConfigureUbxFilter();
+    void UpdateNmeaFilter();
 
     void NMEA_Thread(void);
     int  NMEA_Checksum(const char* s);
     void NMEA_ReaderSplitMessage(std::string msg, std::vector<std::string> &out);
 
-    void NMEA_ReaderParse(char* msg);
+    void NMEA_ReaderParse(char* msg, int64_t timestampMs);
     void NMEA_ReaderParse_GxRMC(char* msg);
     void NMEA_ReaderParse_GxGGA(char* msg);
     void NMEA_ReaderParse_xxGSV(char* msg);
     void NMEA_ReaderParse_GxGSA(char* msg);
     void NMEA_ReaderParse_PUBX00(char* msg);
-
-    enum class UbxState {
-        SYNC1,
-        SYNC2,
-        CLASS,
-        ID,
-        LENGTH1,
-        LENGTH2,
-        PAYLOAD,
-        CHECKSUM1,
-        CHECKSUM2,
-        FINISH
-    };
-
-    const uint8_t mAckClass = 0x05;
-    const uint8_t mAckAckId = 0x01;
-    const uint8_t mAckNakId = 0x00;
+    bool NMEA_SetSvIdentity(SatelliteType type, int16_t nmeaSvid, IGnssCallback::GnssSvInfo& sv);
+    bool NMEA_IsSatelliteTypeAllowed(SatelliteType type);
+    static uint8_t NMEA_ConstellationMask(SatelliteType type);
+    static int64_t NMEA_TimeTag(const std::string& field);
+    void NMEA_StartEpoch(int64_t timeTag);
+    int64_t NMEA_CheckEpochDeadlines();
+    void NMEA_SendSvStatus();
+    void NMEA_CheckFixComplete();
+    void NMEA_AddFixPart(FixPart part);
+    void NMEA_ResetPendingFix();
+    void NMEA_PublishFix();
+    void ProvideLocation(int64_t receivedNs);
+    void ProvideSvStatus();
+    void LogSessionUsage();
+    void LogCallbackExecutorStats(GnssCallbackExecutor::Mailbox mailbox, const char* name);
 
     const uint8_t mUbxSync1               = 0xB5;
     const uint8_t mUbxSync2               = 0x62;
     const size_t  mUbxLengthFirstByteNo   = 4;
     const size_t  mUbxLengthSecondByteNo  = 5;
-    const size_t  mUbxPacketSizeNoPayload = 8;
-    const size_t  mUbxFirstPayloadOffset  = 6;
 
     const int64_t mUbxTimeoutMs = 5000;
     const size_t  mUbxRetriesCnt = 5;
@@ -204,23 +306,8 @@ class GnssHwTTY : public GnssHwIface
     };
 
     struct UbxMachine {
-        UbxState    state;
-        uint8_t     rx_class;
-        uint8_t     rx_id;
-        uint16_t    rx_payload_len;
-        uint16_t    rx_payload_ptr;
-        uint8_t     rx_checksum_a; // checksum that we get in the message itself
-        uint8_t     rx_checksum_b; // checksum that we get in the message itself
-        uint8_t     rx_exp_checksum_a; // checksum that we calculate ourselfs (expected checksum) to test the received data checksum (first part)
-        uint8_t     rx_exp_checksum_b; // checksum that we calculate ourselfs (expected checksum) to test the received data checksum (second part)
-
         uint8_t     tx_class;
         uint8_t     tx_id;
-
-        size_t      buffer_ptr;
-
-        bool        rx_timedout;
-        uint8_t*    msg_payload;
     } mUM;
 
     struct UbxStateQueueElement {
@@ -237,6 +324,8 @@ protected:
     bool StartSalvatorProcedure();
 
     void SelectParser(uint8_t cl, uint8_t id, const uint8_t* data, uint16_t dataLen);
+    void UBX_NavPvtParse(const uint8_t* data, uint16_t dataLen);
+    void UBX_NavSatParse(uint8_t id, const uint8_t* data, uint16_t dataLen);
     void RunWorkerThreads();
     void JoinWorkerThreads();
 
@@ -246,6 +335,7 @@ protected:
     void SetNMEA23();
     void SetNMEA41();
     void PollCommonMessages();
+    void SetUbxOnlyOutput();
     void PollMonVer();
     void PollMonVerRepeated();
     void PrepareGnssConfig(char* propSecmajor, char* propSbas, uint8_t* ubxCfgGnss, const size_t& cfgSize);
@@ -253,15 +343,16 @@ protected:
 
     void InitUblox7Gen();
     void InitUblox8Gen();
+    void ApplyNavigationMessageOutput();
 
+    void GnssHwUbxInit(void);
     void GnssHwUbxInitThread(void);
+    void ReactorThread(void);
+    void ArmEpochTimeout(void);
     void UBX_Thread(void);
-    void UBX_Reset();
-    void UBX_ChecksumReset();
-    void UBX_ChecksumAdd(uint8_t ch);
-    void UBX_ReaderParse(UbxBufferElement* ubx);
     void UBX_Send(const uint8_t* msg, size_t len);
     void UBX_SendRepeatedWithAck(const uint8_t* msg, size_t len);
+    bool UBX_TrySendWithAck(const uint8_t* msg, size_t len);
     void UBX_Expect(UbxRxState astate, const char* errormsg); // Expect state (non blocking)
     bool UBX_Wait(UbxRxState astate, const char* errormsg, int64_t timeoutMs);   // Wait state (blocking)
     bool UBX_Wait_ACK(const uint8_t* msg);
@@ -286,6 +377,7 @@ public:
     bool setUpdatePeriod(int) override;
 
     uint16_t GetYearOfHardware() override;
+    bool SetNavigationMessageEnabled(bool enable) override;
     void GnssHwHandleThread(void) final;
 };
 
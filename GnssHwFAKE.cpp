@@ -28,6 +28,7 @@
 #include <android/hardware/gnss/1.0/IGnss.h>
 
 #include "GnssHw.h"
+#include "GnssThreadPolicy.h"
 
 #define EARTH_RADIUS            6373000 // in meters
 #define PI                      3.141592653589793
@@ -110,6 +111,7 @@ bool GnssHwFAKE::stop(void)
 void GnssHwFAKE::GnssHwHandleThread(void)
 {
     ALOGD("GnssFakeHandleThread() ->");
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Ingest, "gnss_fake");
 
     size_t pt_idx = 0;
     GnssLocation location;
@@ -174,6 +176,7 @@ void GnssHwFAKE::GnssHwHandleThread(void)
             }
 
             location.timestamp = time(NULL) * 1000; // timestamp of the event in milliseconds, time(NULL) returns seconds, therefore we need to convert
+            mLocationSnapshot.store(location);
 
             auto ret = mGnssCb->gnssLocationCb(location);
             if (!ret.isOk()) {
@@ -38,12 +38,18 @@
 #include <cutils/properties.h>
 
 #include "GnssHw.h"
-#include "GnssMeasToLocSync.h"
+#include "GnssEpochBarrier.h"
 #include "GnssRxmMeasxParser.h"
+#include "GnssRxmRawxParser.h"
 #include "GnssNavClockParser.h"
 #include "GnssNavTimeGPSParser.h"
 #include "GnssNavStatusParser.h"
+#include "GnssNavPvtParser.h"
+#include "GnssNavSatParser.h"
 #include "GnssMeasQueue.h"
+#include "GnssNavMsgQueue.h"
+#include "GnssUbxRegistry.h"
+#include "GnssThreadPolicy.h"
 #include "UsbHandler.h"
 
 
@@ -56,16 +62,65 @@ static const uint16_t ublox8 = 0x01a8;
 static const uint8_t classUbxNav = 0x01;
 static const uint8_t classUbxRxm = 0x02;
 static const uint8_t classNmeaCfg = 0xF0;
+static const uint8_t classPubxCfg = 0xF1;
 static const uint8_t classUbxMon = 0x0A;
+static const uint8_t classUbxAck = 0x05;
 
 static const uint8_t idClock = 0x22;
 static const uint8_t idMeasx = 0x14;
+static const uint8_t idRawx = 0x15;
+static const uint8_t idSfrbx = 0x13;
 static const uint8_t idTimeGps = 0x20;
 static const uint8_t idStatus = 0x03;
+static const uint8_t idPvt = 0x07;
+static const uint8_t idSvInfo = 0x30;
+static const uint8_t idSat = 0x35;
+static const uint8_t idGGA = 0x00;
+static const uint8_t idGLL = 0x01;
+static const uint8_t idGSA = 0x02;
+static const uint8_t idGSV = 0x03;
 static const uint8_t idRMC = 0x04;
+static const uint8_t idVTG = 0x05;
 static const uint8_t idVer = 0x04;
+static const uint8_t idAck = 0x01;
+static const uint8_t idNak = 0x00;
+
+// Routes of the received UBX messages, see SelectParser
+enum UbxRoute : uint8_t {
+    routeUnknown = UbxDispatchTable<1>::unknownRoute,
+    routeRxmMeasx,
+    routeRxmRawx,
+    routeRxmSfrbx,
+    routeNavClock,
+    routeNavTimeGps,
+    routeNavStatus,
+    routeNavPvt,
+    routeNavSat,
+    routeAckAck,
+    routeAckNak,
+    routeMonVer,
+};
+
+static constexpr UbxMessageEntry ubxMessages[] = {
+    {classUbxRxm, idMeasx, routeRxmMeasx},
+    {classUbxRxm, idRawx, routeRxmRawx},
+    {classUbxRxm, idSfrbx, routeRxmSfrbx},
+    {classUbxNav, idClock, routeNavClock},
+    {classUbxNav, idTimeGps, routeNavTimeGps},
+    {classUbxNav, idStatus, routeNavStatus},
+    {classUbxNav, idPvt, routeNavPvt},
+    {classUbxNav, idSat, routeNavSat},
+    {classUbxNav, idSvInfo, routeNavSat},
+    {classUbxAck, idAck, routeAckAck},
+    {classUbxAck, idNak, routeAckNak},
+    {classUbxMon, idVer, routeMonVer},
+};
+
+typedef UbxDispatchTable<4> UbxDispatch; // RXM, NAV, ACK, MON
+static constexpr UbxDispatch ubxDispatch(ubxMessages);
 
 static const uint8_t defaultRate = 0x01;
+static const uint8_t disabledRate = 0x00;
 static const uint8_t rateRMC = 0x01;
 
 // According to u-blox M8 Receiver Description - Manual, UBX-13003221, R16 (5.11.2018),  32.2.14 RMC, p. 124
@@ -117,6 +172,12 @@ static bool DoubleCmp(double a, double b, double epsilon = 0.001)
     return std::fabs(a - b) < epsilon;
 }
 
+static inline int64_t NowUtcMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 template <typename mPtr>
 static inline void CheckNotNull(mPtr val, const char* msg)
 {
@@ -244,6 +305,12 @@ GnssHwTTY::GnssHwTTY(int fd) :
     mUbxAckReceived(0)
 {
     memset(&mGnssLocation, 0, sizeof(GnssLocation));
+    memset(&mPendingLocation, 0, sizeof(GnssLocation));
+    mUbxOnly = property_get_bool("ro.boot.gps.ubx_only", false);
+    mUbxSvStatus = mUbxOnly || property_get_bool("ro.boot.gps.ubx_sat", false);
+    mReactorMode = property_get_bool("ro.boot.gps.reactor", false);
+    ConfigureUbxFilter();
+    UpdateNmeaFilter();
     memset(&mSvStatus, 0, sizeof(IGnssCallback::GnssSvStatus));
     mNmeaBuffer     = new(std::nothrow) CircularBuffer<NmeaBufferElement   >(32, sizeof(NmeaBufferElement));
     mUbxBuffer      = new(std::nothrow) CircularBuffer<UbxBufferElement    >(32, sizeof(UbxBufferElement));
@@ -264,6 +331,23 @@ GnssHwTTY::GnssHwTTY(int fd) :
 
 void GnssHwTTY::RunWorkerThreads()
 {
+    if (mReactorMode && !mReactorThread.joinable()) {
+        mReactor.reset(new GnssReactor(*this));
+        if (mReactor->IsValid()) {
+            ALOGI("Reactor mode");
+            mReactorThread = std::thread(&GnssHwTTY::ReactorThread, this);
+            return;
+        }
+
+        ALOGE("[%s, line %d] Event loop is not available, use worker threads", __func__, __LINE__);
+        mReactorMode = false;
+        mReactor.reset();
+    }
+
+    if (mReactorMode) {
+        return;
+    }
+
     if (!mHwInitThread.joinable()) {
         mHwInitThread = std::thread(&GnssHwTTY::GnssHwUbxInitThread, this);
     }
@@ -305,6 +389,14 @@ bool GnssHwTTY::start(void)
     }
 
     ALOGD("Start HW");
+    getrusage(RUSAGE_SELF, &mSessionUsage);
+    mSessionStartNs = android::elapsedRealtimeNano();
+    mFixLatency.Reset();
+    mCallbackFilter.Reset();
+    mCallbackExecutor.SetCallback(mGnssCb);
+    mNmeaPassthrough.SetCallback(mGnssCb);
+    UpdateNmeaFilter();
+    GnssEpochBarrier::getInstance().setLaneActive(GnssEpochBarrier::Lane::Location, true);
     if (mIsKingfisher) {
         mEnabled = true;
     } else {
@@ -322,6 +414,30 @@ bool GnssHwTTY::stop(void)
 {
     ALOGD("Stop HW");
     mEnabled = false;
+    ALOGI("Callbacks saved by filter: SV status %" PRIu64 ", location %" PRIu64,
+          mCallbackFilter.GetSavedSvStatusCount(), mCallbackFilter.GetSavedLocationCount());
+    ALOGI("NMEA passthrough: forwarded %" PRIu64 ", filtered %" PRIu64 ", rate limited %" PRIu64,
+          mNmeaPassthrough.GetForwardedCount(), mNmeaPassthrough.GetFilteredCount(),
+          mNmeaPassthrough.GetRateLimitedCount());
+    ALOGI("Framer: UBX %" PRIu64 ", NMEA %" PRIu64 ", checksum errors %" PRIu64
+          ", length errors %" PRIu64 ", resyncs %" PRIu64 ", discarded bytes %" PRIu64,
+          mFramer.GetUbxFrameCount(), mFramer.GetNmeaFrameCount(),
+          mFramer.GetChecksumErrorCount(), mFramer.GetLengthErrorCount(),
+          mFramer.GetResyncCount(), mFramer.GetDiscardedBytesCount());
+    mFramer.LogSkippedCounters();
+
+    GnssEpochBarrier& barrier = GnssEpochBarrier::getInstance();
+    const GnssEpochBarrier::Stats barrierStats = barrier.getStats();
+    barrier.setLaneActive(GnssEpochBarrier::Lane::Location, false);
+    ALOGI("Epoch barrier: in order %" PRIu64 ", late %" PRIu64 ", dropped %" PRIu64,
+          barrierStats.inOrder, barrierStats.late, barrierStats.dropped);
+
+    // pending values of the session must not be delivered after its end
+    mCallbackExecutor.Clear();
+    LogCallbackExecutorStats(GnssCallbackExecutor::Mailbox::Location, "location");
+    LogCallbackExecutorStats(GnssCallbackExecutor::Mailbox::SvStatus, "SV status");
+    LogSessionUsage();
+
     if (mGnssCb != nullptr) {
         mGnssCb->gnssStatusCb(IGnssCallback::GnssStatusValue::SESSION_END);
     }
@@ -420,6 +536,10 @@ void GnssHwTTY::JoinWorkerThreads()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
+    if (mReactorThread.joinable()) {
+        mReactor->Stop();
+        mReactorThread.join();
+    }
     if (mHwInitThread.joinable()) {
         mHwInitThread.join();
     }
@@ -636,15 +756,48 @@ void GnssHwTTY::PollCommonMessages()
 
     UBX_SendRepeatedWithAck(ublox_nav5, sizeof(ublox_nav5));
 
-    UBX_SetMessageRate(0xF1, 0x00, 1, "Failed to enable PUBX,00 message"); // enable PUBX,00
-    UBX_SetMessageRate(0xF0, 0x01, 0, nullptr); // disable GLL
-    UBX_SetMessageRate(0xF0, 0x05, 0, nullptr); // disable VTG
+    if (mUbxOnly) {
+        SetUbxOnlyOutput();
+    } else {
+        UBX_SetMessageRate(0xF1, 0x00, 1, "Failed to enable PUBX,00 message"); // enable PUBX,00
+        UBX_SetMessageRate(0xF0, 0x01, 0, nullptr); // disable GLL
+        UBX_SetMessageRate(0xF0, 0x05, 0, nullptr); // disable VTG
+    }
 
     UBX_SetMessageRateCurrentPort(classUbxNav, idClock, defaultRate, "UBX-NAV-CLOCK config failed");
     UBX_SetMessageRateCurrentPort(classUbxNav, idTimeGps, defaultRate, "UBX-NAV-GPS-TIME config failed");
     UBX_SetMessageRateCurrentPort(classUbxNav, idStatus, defaultRate, "UBX-NAV-STATUS config failed");
 
-    UBX_SetMessageRate(classNmeaCfg, idRMC, rateRMC, nullptr); // reduce RMC rate
+    if (mUbxSvStatus) {
+        if (mUbxGeneration == ublox8) {
+            UBX_SetMessageRateCurrentPort(classUbxNav, idSat, defaultRate, "UBX-NAV-SAT config failed");
+        } else {
+            UBX_SetMessageRateCurrentPort(classUbxNav, idSvInfo, defaultRate, "UBX-NAV-SVINFO config failed");
+        }
+    }
+
+    if (!mUbxOnly) {
+        UBX_SetMessageRate(classNmeaCfg, idRMC, rateRMC, nullptr); // reduce RMC rate
+    }
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssHwTTY::SetUbxOnlyOutput()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    // Location sentences are replaced by UBX-NAV-PVT,
+    // satellite sentences by UBX-NAV-SAT/UBX-NAV-SVINFO
+    UBX_SetMessageRate(classNmeaCfg, idGGA, disabledRate, nullptr);
+    UBX_SetMessageRate(classNmeaCfg, idGLL, disabledRate, nullptr);
+    UBX_SetMessageRate(classNmeaCfg, idGSA, disabledRate, nullptr);
+    UBX_SetMessageRate(classNmeaCfg, idGSV, disabledRate, nullptr);
+    UBX_SetMessageRate(classNmeaCfg, idRMC, disabledRate, nullptr);
+    UBX_SetMessageRate(classNmeaCfg, idVTG, disabledRate, nullptr);
+    UBX_SetMessageRate(classPubxCfg, 0x00, disabledRate, nullptr); // PUBX,00
+
+    UBX_SetMessageRateCurrentPort(classUbxNav, idPvt, defaultRate, "UBX-NAV-PVT config failed");
 
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
@@ -688,9 +841,57 @@ void GnssHwTTY::InitUblox8Gen()
     ConfigGnssUblox8();
     PollCommonMessages();
 
+    // RAWX is available on timing and raw data firmware only, others reply with NAK
+    if (property_get_bool("ro.boot.gps.rawx", false)) {
+        const uint8_t msgCfgRawx[] = {0x06, 0x01, 0x03, 0x00, classUbxRxm, idRawx, defaultRate};
+        if (UBX_TrySendWithAck(msgCfgRawx, sizeof(msgCfgRawx))) {
+            ALOGI("UBX-RXM-RAWX enabled");
+            return;
+        }
+        ALOGW("UBX-RXM-RAWX is not supported, fall back to UBX-RXM-MEASX");
+    }
+
     UBX_SetMessageRateCurrentPort(classUbxRxm, idMeasx, defaultRate, "UBX-RXM-MEASX config failed");
 }
 
+void GnssHwTTY::ApplyNavigationMessageOutput()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::lock_guard<std::mutex> lock(mNavMsgLock);
+    mUbxInitDone = true;
+
+    // The reader thread is not running yet, so the ACK can be waited for here
+    if (mNavMsgRequested && mUbxGeneration == ublox8) {
+        const uint8_t msgCfgSfrbx[] = {0x06, 0x01, 0x03, 0x00, classUbxRxm, idSfrbx, defaultRate};
+        if (!UBX_TrySendWithAck(msgCfgSfrbx, sizeof(msgCfgSfrbx))) {
+            ALOGW("UBX-RXM-SFRBX is not supported");
+        }
+    }
+}
+
+bool GnssHwTTY::SetNavigationMessageEnabled(bool enable)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::lock_guard<std::mutex> lock(mNavMsgLock);
+    mNavMsgRequested = enable;
+
+    if (!mUbxInitDone) {
+        ALOGI("[%s, line %d] Receiver is not configured yet, UBX-RXM-SFRBX is deferred", __func__, __LINE__);
+        return true;
+    }
+
+    // UBX-RXM-SFRB of u-blox 7 has a different layout
+    if (mUbxGeneration != ublox8) {
+        return false;
+    }
+
+    // The reader thread owns the port now, the ACK is dropped by UBX_ACKParse as not expected
+    const uint8_t msgCfgSfrbx[] = {0x06, 0x01, 0x03, 0x00, classUbxRxm, idSfrbx,
+                                   enable ? defaultRate : disabledRate};
+    UBX_Send(msgCfgSfrbx, sizeof(msgCfgSfrbx));
+    return true;
+}
+
 void GnssHwTTY::PollMonVer()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
@@ -718,11 +919,11 @@ void GnssHwTTY::PollMonVerRepeated()
                    "UBX protocol failure (No MON-VER received even during retries, give up)");
 }
 
-void GnssHwTTY::GnssHwUbxInitThread(void)
+void GnssHwTTY::GnssHwUbxInit(void)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
     resetOnStart();
-    UBX_Reset();
+    mFramer.Reset();
     PollMonVerRepeated();
     switch (mUbxGeneration) {
     case ublox7: {
@@ -740,14 +941,73 @@ void GnssHwTTY::GnssHwUbxInitThread(void)
 
     }
 
+    ApplyNavigationMessageOutput();
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssHwTTY::GnssHwUbxInitThread(void)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Ingest, "gnss_init");
+    GnssHwUbxInit();
     this->SetUpHandleThread();
+}
+
+void GnssHwTTY::ReactorThread(void)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Ingest, "gnss_reactor");
+
+    // The configuration waits for ACKs reading the port directly, as the init thread does
+    GnssHwUbxInit();
 
+    if (mFd >= 0 && mReactor->AddFd(mFd)) {
+        ArmEpochTimeout();
+        mReactor->Run();
+    }
+
+    const GnssReactor::Stats stats = mReactor->GetStats();
+    ALOGI("Reactor: wakeups %" PRIu64 ", read %" PRIu64 ", timer %" PRIu64 ", control %" PRIu64
+          ", max handler %" PRId64 " us", stats.wakeups, stats.readEvents, stats.timerEvents,
+          stats.controlEvents, stats.maxHandlerUs);
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
 
+void GnssHwTTY::ArmEpochTimeout(void)
+{
+    mReactor->SetTimeout(NMEA_CheckEpochDeadlines());
+}
+
+bool GnssHwTTY::OnReadable(int fd)
+{
+    uint8_t chunk[mReadChunkSize];
+    ssize_t ret = read(fd, chunk, sizeof(chunk));
+
+    if (ret < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return true;
+    }
+
+    if (ret <= 0) {
+        ALOGE("TTY read error: %s", strerror(errno));
+        mFd = -1;
+        return false;
+    }
+
+    mFramer.Push(chunk, static_cast<size_t>(ret));
+    ArmEpochTimeout();
+    return true;
+}
+
+void GnssHwTTY::OnTimeout()
+{
+    ArmEpochTimeout();
+}
+
 void GnssHwTTY::GnssHwHandleThread(void)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Ingest, "gnss_ingest");
 
     while (!mThreadExit) {
         if (mFd == -1) {
@@ -756,15 +1016,15 @@ void GnssHwTTY::GnssHwHandleThread(void)
             continue;
         }
 
-        uint8_t ch;
-        ssize_t ret = read(mFd, &ch, sizeof(ch));
+        uint8_t chunk[mReadChunkSize];
+        ssize_t ret = read(mFd, chunk, sizeof(chunk));
 
         if (ret < 0 && errno == EAGAIN) {
             continue;
         }
 
         if (ret > 0) {
-            ReaderPushChar(ch);
+            mFramer.Push(chunk, static_cast<size_t>(ret));
         } else {
             ALOGE("TTY read error: %s", strerror(errno));
             mFd  = -1;
@@ -776,98 +1036,110 @@ void GnssHwTTY::GnssHwHandleThread(void)
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
 
-void GnssHwTTY::ReaderPushChar(unsigned char ch)
+void GnssHwTTY::ConfigureUbxFilter()
 {
-    if (mReaderBufPos >= sizeof(mReaderBuf)) {
-        mReaderBufPos = 0;
-        mReaderState = ReaderState::WAITING;
-    }
-
-    static uint16_t ubx_payload_len;
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (ch == '$' && mReaderState == ReaderState::WAITING) {
-        mReaderState = ReaderState::CAPTURING_NMEA;
-    }
-    else if (ch == mUbxSync1 && mReaderState == ReaderState::WAITING) {
-        mReaderState = ReaderState::WAITING_UBX_SYNC2;
-        ALOGV("UBX waiting sync2");
+    // UBX messages without a route would be dropped by SelectParser anyway
+    mFramer.SetAllUbxWanted(false);
+    for (const UbxMessageEntry& entry : ubxMessages) {
+        mFramer.SetUbxWanted(entry.msgClass, entry.msgId, true);
     }
-    else if (mReaderState == ReaderState::CAPTURING_NMEA) {
-        if (ch == '$') {
-            /* Missed end of message CR LF ? Reset the reader */
-            mReaderBufPos = 0;
-        } else if (ch == '\r' || ch == '\n') {
-            /* End of message */
-            mReaderBuf[mReaderBufPos] = 0;
+}
+
+void GnssHwTTY::UpdateNmeaFilter()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-            /* Parse NMEA */
-            mNmeaBuffer->put(mReaderBuf);
+    // Parsed types plus the types forwarded to the passthrough client. Each type
+    // is set once, the reader thread never sees a wanted type as unwanted.
+    static const char* const parsedTypes[] = {"RMC", "GGA", "GSA", "GSV"};
+    static const size_t svStatusTypesFirst = 2;
+    const size_t parsedCount = mUbxSvStatus ? svStatusTypesFirst :
+                               sizeof(parsedTypes) / sizeof(parsedTypes[0]);
+    const size_t typeOffset = 3;
+    const bool hasClient = mNmeaPassthrough.HasClient();
+    char type[] = "AAA";
+    char sentence[] = "$GPAAA,";
+
+    for (type[0] = 'A'; type[0] <= 'Z'; type[0]++) {
+        for (type[1] = 'A'; type[1] <= 'Z'; type[1]++) {
+            for (type[2] = 'A'; type[2] <= 'Z'; type[2]++) {
+                bool wanted = false;
+                for (size_t i = 0; i < parsedCount && !wanted; i++) {
+                    wanted = (0 == strcmp(type, parsedTypes[i]));
+                }
 
-            mNmeaThreadCv.notify_all();
+                if (!wanted && hasClient) {
+                    memcpy(&sentence[typeOffset], type, sizeof(type) - 1);
+                    wanted = mNmeaPassthrough.IsTypeAllowed(sentence);
+                }
 
-            /* Reset the reader  */
-            mReaderBufPos = 0;
-            mReaderState = ReaderState::WAITING;
-            return;
-        }
-    }
-    else if (mReaderState == ReaderState::WAITING_UBX_SYNC2) {
-        if (ch == mUbxSync2) {
-            ALOGV("UBX capturing");
-            mReaderState = ReaderState::CAPTURING_UBX;
+                mFramer.SetNmeaWanted(type, wanted);
+            }
         }
     }
-    else if (mReaderState == ReaderState::CAPTURING_UBX) {
-        if (mReaderBufPos == mUbxLengthFirstByteNo) {
-            ALOGV("UBX rx payload len byte1: %02X", ch);
-            ubx_payload_len += ch;
-        }
-        else if (mReaderBufPos == mUbxLengthSecondByteNo) {
-            ubx_payload_len += ch << 8;
-            ALOGV("UBX rx payload len byte2: %02X", ch);
-            ALOGV("UBX rx payload len: %d", ubx_payload_len);
-        }
+}
+
+void GnssHwTTY::OnNmeaFrame(const char* sentence, size_t len)
+{
+    NmeaBufferElement elem;
+    len = std::min(len, sizeof(elem.data) - 1);
+    memcpy(elem.data, sentence, len);
+    elem.data[len] = 0;
+    elem.timestampMs = NowUtcMs();
+    elem.receivedNs = android::elapsedRealtimeNano();
+
+    // The reactor parses inline, the location is only posted to the callback executor
+    if (mReactorMode) {
+        mNmeaReceivedNs = elem.receivedNs;
+        NMEA_ReaderParse(elem.data, elem.timestampMs);
+        return;
     }
 
-    ALOGV("[%s, line %d] waiting", __func__, __LINE__);
-    if (mReaderState != ReaderState::WAITING) {
-        mReaderBuf[mReaderBufPos++] = ch;
+    mNmeaBuffer->put(&elem);
+    mNmeaThreadCv.notify_all();
+}
 
-        if (mReaderState == ReaderState::CAPTURING_UBX &&
-                mReaderBufPos >= (ubx_payload_len + mUbxPacketSizeNoPayload)) {
+void GnssHwTTY::OnUbxFrame(uint8_t cl, uint8_t id, const uint8_t* payload, uint16_t len)
+{
+    ALOGV("[%s, line %d] UBX %02X %02X len %u", __func__, __LINE__, cl, id, len);
 
-            /* Parse UBX */
-            ALOGV("UBX rx putting buffer len: %zu", mReaderBufPos);
+    if (mReactorMode) {
+        mUbxReceivedNs = android::elapsedRealtimeNano();
+        SelectParser(cl, id, payload, len);
+        return;
+    }
 
-            UbxBufferElement elem;
-            elem.len = mReaderBufPos;
-            if (elem.len < (sizeof(UbxBufferElement) - sizeof(size_t))) {
-                ALOGV("[%s, line %d] add, notify all", __func__, __LINE__);
-                memcpy(&elem.data, mReaderBuf, elem.len);
-                mUbxBuffer->put(&elem);
-                mUbxThreadCv.notify_all();
-            } else {
-                ALOGE("Received UBX message that is too large for the buffer (%lu)", elem.len);
-            }
+    UbxBufferElement elem;
+    elem.cl = cl;
+    elem.id = id;
+    elem.len = len;
+    elem.receivedNs = android::elapsedRealtimeNano();
+    memcpy(elem.payload, payload, len);
 
-            /* Reset the reader  */
-            mReaderBufPos = 0;
-            mReaderState = ReaderState::WAITING;
-            ubx_payload_len = 0;
-        }
-    }
+    mUbxBuffer->put(&elem);
+    mUbxThreadCv.notify_all();
 }
 
 void GnssHwTTY::NMEA_Thread(void)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Parse, "gnss_nmea");
 
     while (!mHelpThreadExit) {
         if (!mNmeaBuffer->empty()) {
-            NMEA_ReaderParse(&(mNmeaBuffer->get()->data[0]));
+            NmeaBufferElement* elem = mNmeaBuffer->get();
+            mNmeaReceivedNs = elem->receivedNs;
+            NMEA_ReaderParse(&(elem->data[0]), elem->timestampMs);
         } else {
+            const int64_t timeoutMs = NMEA_CheckEpochDeadlines();
             std::unique_lock<std::mutex> lock(mNmeaThreadLock);
-            mNmeaThreadCv.wait(lock);
+            if (timeoutMs < 0) {
+                mNmeaThreadCv.wait(lock);
+            } else {
+                mNmeaThreadCv.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+            }
         }
     }
 
@@ -877,10 +1149,13 @@ void GnssHwTTY::NMEA_Thread(void)
 void GnssHwTTY::UBX_Thread(void)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Parse, "gnss_ubx");
 
     while (!mHelpThreadExit) {
         if (!mUbxBuffer->empty()) {
-            UBX_ReaderParse(mUbxBuffer->get());
+            UbxBufferElement* elem = mUbxBuffer->get();
+            mUbxReceivedNs = elem->receivedNs;
+            SelectParser(elem->cl, elem->id, elem->payload, elem->len);
         } else {
             std::unique_lock<std::mutex> lock(mUbxThreadLock);
             mUbxThreadCv.wait(lock);
@@ -922,7 +1197,7 @@ void GnssHwTTY::NMEA_ReaderSplitMessage(std::string msg, std::vector<std::string
     }
 }
 
-void GnssHwTTY::NMEA_ReaderParse(char *msg)
+void GnssHwTTY::NMEA_ReaderParse(char *msg, int64_t timestampMs)
 {
     int64_t crc = 0;
     char * p = strstr(msg, "*");
@@ -945,20 +1220,11 @@ void GnssHwTTY::NMEA_ReaderParse(char *msg)
         isNMEA = false;
     }
 
-    if (isNMEA) {
-        /* Push RAW NMEA message to system */
-        android::hardware::hidl_string nmeaString;
-        nmeaString.setToExternal(msg, strlen(msg));
-
-        if (mEnabled) {
-            if (mGnssCb != nullptr) {
-                auto ret = mGnssCb->gnssNmeaCb(time(nullptr), nmeaString);
-                if (!ret.isOk()) {
-                    ALOGE("Unable to invoke gnssNmeaCb");
-                    ALOGV("[%s, line %d] Unable to invoke gnssNmeaCb", __func__, __LINE__);
-                }
-            }
-        }
+    /* Push RAW NMEA message to system, the delivery is done off this thread */
+    if (mEnabled) {
+        *p = '*';
+        mNmeaPassthrough.Put(msg, timestampMs);
+        *p = '\0';
     }
 
     ALOGV("[%s, line %d] GPSRAW: %s", __func__, __LINE__, msg);
@@ -973,9 +1239,13 @@ void GnssHwTTY::NMEA_ReaderParse(char *msg)
     } else if (strncmp(msg + prefixOffset, "GGA", lenToCmp) == 0) {
         NMEA_ReaderParse_GxGGA(msg);
     } else if (strncmp(msg + prefixOffset, "GSA", lenToCmp) == 0) {
-        NMEA_ReaderParse_GxGSA(msg);
+        if (!mUbxSvStatus) {
+            NMEA_ReaderParse_GxGSA(msg);
+        }
     } else if (strncmp(msg + prefixOffset, "GSV", lenToCmp) == 0) {
-        NMEA_ReaderParse_xxGSV(msg);
+        if (!mUbxSvStatus) {
+            NMEA_ReaderParse_xxGSV(msg);
+        }
     } else if (isNMEA == false) {
         if (strncmp(msg + pubxPrefixOffset, "00", pubxLenToCmp) == 0) {
             NMEA_ReaderParse_PUBX00(msg);
@@ -1024,18 +1294,25 @@ void GnssHwTTY::NMEA_ReaderParse_GxRMC(char *msg)
         return;
     }
 
+    NMEA_StartEpoch(NMEA_TimeTag(rmc[1]));
+    NMEA_AddFixPart(FixPart::RMC);
+
     // Status A=active or V=Void
     if (rmc[2] != "A") {
         if (mEnabled) {
             ALOGD("GPRMC: No valid fix coordinates, wait...");
         }
 
-        /* Invalidate location data*/
-        memset(&mGnssLocation, 0, sizeof(GnssLocation));
+        /* Invalidate location data of this epoch */
+        mPendingFixValid = false;
+        NMEA_CheckFixComplete();
 
         return; /* Only when Active continue parse */
     }
 
+    GnssLocation& location = mPendingLocation;
+    mPendingFixValid = true;
+
     /* Parse time/date fields */
     memset(&t, 0, sizeof(struct tm));
 
@@ -1054,73 +1331,42 @@ void GnssHwTTY::NMEA_ReaderParse_GxRMC(char *msg)
         t.tm_year += 100;
     }
 
-    mGnssLocation.timestamp = mktime(&t) * 1000; // timestamp of the event in milliseconds, mktime(&t) returns seconds, therefore we need to convert
+    location.timestamp = static_cast<int64_t>(timegm(&t)) * 1000; // timestamp of the event in milliseconds, timegm(&t) returns seconds, therefore we need to convert
 
     /* Parse longtitude and latitude */
-    mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
 
     raw = atof(rmc[3].c_str()); // Latitude
     polarity = static_cast<double>(rmc[4] == "S" ? -1 : 1);
 
     degree = static_cast<int>(raw / 100);
     minutes = ((raw / 100) - degree) * 100;
-    mGnssLocation.latitudeDegrees = ((minutes / 60) + degree) * polarity;
+    location.latitudeDegrees = ((minutes / 60) + degree) * polarity;
 
     raw = atof(rmc[5].c_str()); // Longitude
     polarity = static_cast<double>(rmc[6] == "W" ? -1.f : 1.f);
 
     degree = static_cast<int>(raw / 100);
     minutes = ((raw / 100) - degree) * 100;
-    mGnssLocation.longitudeDegrees = ((minutes / 60) + degree) * polarity;
+    location.longitudeDegrees = ((minutes / 60) + degree) * polarity;
 
     // Speed over the ground in knots
     if (rmc[7].length() > 0) {
-        mGnssLocation.speedMetersPerSec = (static_cast<float>(atof(rmc[7].c_str())) * 1.852f) / 3.6f; // knots -> m/s
-        mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED);
-        mGnssLocation.speedAccuracyMetersPerSecond = mSpeedAcc;
-        mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED_ACCURACY);
-    } else {
-        mGnssLocation.speedMetersPerSec = 0.f;
-        mGnssLocation.gnssLocationFlags &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED);
-        mGnssLocation.speedAccuracyMetersPerSecond = 0.f;
-        mGnssLocation.gnssLocationFlags &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED_ACCURACY);
+        location.speedMetersPerSec = (static_cast<float>(atof(rmc[7].c_str())) * 1.852f) / 3.6f; // knots -> m/s
+        location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED);
+        location.speedAccuracyMetersPerSecond = mSpeedAcc;
+        location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED_ACCURACY);
     }
 
     // Track angle in degrees True
     if (rmc[8].length() > 0) {
-        mGnssLocation.bearingDegrees = static_cast<float>(atof(rmc[8].c_str()));
-        mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING);
-        mGnssLocation.bearingAccuracyDegrees = mBearingAcc;
-        mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING_ACCURACY);
-    } else {
-        mGnssLocation.bearingDegrees = 0.f;
-        mGnssLocation.gnssLocationFlags &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING);
-        mGnssLocation.bearingAccuracyDegrees = 0.f;
-        mGnssLocation.gnssLocationFlags &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING_ACCURACY);
+        location.bearingDegrees = static_cast<float>(atof(rmc[8].c_str()));
+        location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING);
+        location.bearingAccuracyDegrees = mBearingAcc;
+        location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING_ACCURACY);
     }
 
-    // For ublox devices location callback depends on speed, bearing and altitude existence
-    // Provide location only for 3D fix (has altitude)
-    // Provide location only if speed and bearing (course over ground) are provided simultaneously
-    bool hasSpeed = (mGnssLocation.gnssLocationFlags & GnssLocationFlags::HAS_SPEED);
-    bool hasBearing = (mGnssLocation.gnssLocationFlags & GnssLocationFlags::HAS_BEARING);
-    bool hasAltitude = (mGnssLocation.gnssLocationFlags & GnssLocationFlags::HAS_ALTITUDE);
-    bool provideLocation = ((!hasSpeed || (hasSpeed && hasBearing)) && hasAltitude);
-
-    mGnssLocation.speedAccuracyMetersPerSecond = mSpeedAcc;
-    mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED_ACCURACY);
-
-    GnssMeasToLocSync& syncInstance = GnssMeasToLocSync::getInstance();
-    if (mEnabled && provideLocation && syncInstance.WaitToSend()) {
-        ALOGV("[%s, line %d] Provide location callback", __func__, __LINE__);
-        if (mGnssCb != nullptr) {
-            ALOGD("Provide location callback");
-            auto ret = mGnssCb->gnssLocationCb(mGnssLocation);
-            if (!ret.isOk()) {
-                ALOGE("[%s, line %d]: Unable to invoke gnssLocationCb", __func__, __LINE__);
-            }
-        }
-    }
+    NMEA_CheckFixComplete();
 }
 
 void GnssHwTTY::NMEA_ReaderParse_GxGGA(char *msg)
@@ -1137,25 +1383,206 @@ void GnssHwTTY::NMEA_ReaderParse_GxGGA(char *msg)
         return;
     }
 
+    NMEA_StartEpoch(NMEA_TimeTag(gga[1]));
+    NMEA_AddFixPart(FixPart::GGA);
+
     // Altitude, Meters, above mean sea level
     if (gga[9].length() > 0) {
-        mGnssLocation.altitudeMeters = atof(gga[9].c_str());
-        mGnssLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_ALTITUDE);
-    } else {
-        mGnssLocation.altitudeMeters = 0;
-        mGnssLocation.gnssLocationFlags &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_ALTITUDE);
+        mPendingLocation.altitudeMeters = atof(gga[9].c_str());
+        mPendingLocation.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_ALTITUDE);
     }
+
+    NMEA_CheckFixComplete();
 }
 
-void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
+void GnssHwTTY::NMEA_CheckFixComplete()
+{
+    if (mFixEpoch.isComplete()) {
+        NMEA_PublishFix();
+    }
+}
+
+void GnssHwTTY::NMEA_AddFixPart(FixPart part)
+{
+    mFixEpoch.addPart(static_cast<uint32_t>(part), android::elapsedRealtime());
+    // the fix is complete with its last sentence, the latency is measured from it
+    mPendingFixReceivedNs = mNmeaReceivedNs;
+}
+
+void GnssHwTTY::NMEA_ResetPendingFix()
+{
+    memset(&mPendingLocation, 0, sizeof(GnssLocation));
+    mPendingFixValid = false;
+    mPendingFixType = 0;
+    mPendingFixReceivedNs = 0;
+}
+
+void GnssHwTTY::NMEA_PublishFix()
 {
     ALOGV("[%s, line %d] Entry", __func__ ,__LINE__);
 
+    const uint32_t parts = mFixEpoch.getParts();
+    const bool hasRmc = (parts & static_cast<uint32_t>(FixPart::RMC));
+    const bool hasGga = (parts & static_cast<uint32_t>(FixPart::GGA));
+    const bool hasGsa = (parts & static_cast<uint32_t>(FixPart::GSA));
+    const bool valid = hasRmc && mPendingFixValid;
+
+    if (parts != mFixEpoch.getExpected()) {
+        ALOGD("Fix epoch published with parts 0x%x of 0x%x", parts, mFixEpoch.getExpected());
+    }
+
+    mFixEpoch.close();
+
+    if (!valid) {
+        NMEA_ResetPendingFix();
+        return;
+    }
+
+    // For ublox devices location callback depends on speed, bearing and altitude existence
+    // Provide location only for 3D fix (has altitude), 3D fix is known either from GSA
+    // fix type or from GGA altitude, if both sentences are lost the fix is sent as is
+    // Provide location only if speed and bearing (course over ground) are provided simultaneously
+    bool hasSpeed = (mPendingLocation.gnssLocationFlags & GnssLocationFlags::HAS_SPEED);
+    bool hasBearing = (mPendingLocation.gnssLocationFlags & GnssLocationFlags::HAS_BEARING);
+    bool hasAltitude = (mPendingLocation.gnssLocationFlags & GnssLocationFlags::HAS_ALTITUDE);
+    bool is3dFix = hasGsa ? (mPendingFixType == 3) : (!hasGga || hasAltitude);
+    bool provideLocation = ((!hasSpeed || (hasSpeed && hasBearing)) && is3dFix);
+
+    mGnssLocation = mPendingLocation;
+    const int64_t receivedNs = mPendingFixReceivedNs;
+    NMEA_ResetPendingFix();
+
+    if (provideLocation) {
+        ProvideLocation(receivedNs);
+    }
+}
+
+void GnssHwTTY::ProvideLocation(int64_t receivedNs)
+{
+    mLocationSnapshot.store(mGnssLocation);
+
+    // The epoch barrier is waited on by the delivery thread of the executor,
+    // the parse thread or the reactor only posts the location
+    if (mEnabled && mGnssCb != nullptr &&
+        mCallbackFilter.ShouldSendLocation(mGnssLocation, android::elapsedRealtime())) {
+        ALOGV("[%s, line %d] Provide location callback", __func__, __LINE__);
+        mCallbackExecutor.PostLocation(mGnssLocation, GnssEpochBarrier::keyFromUtcMs(mGnssLocation.timestamp));
+
+        mFixLatency.Record(receivedNs, android::elapsedRealtimeNano());
+    }
+}
+
+bool GnssHwTTY::NMEA_SetSvIdentity(SatelliteType type, int16_t nmeaSvid, IGnssCallback::GnssSvInfo& sv)
+{
     const float L1BandFrequency = 1575.42f;
     const float B1BandFrequency = 1561.098f;
     const float L1GlonassBandFrequency = 1602.562f;
     const float scale = 1000000.0;
 
+    /**
+     * Pseudo-random number for the SV, or FCN/OSN number for Glonass. The
+     * distinction is made by looking at constellation field. Values must be
+     * in the range of:
+     *
+     * - GNSS:    1-32
+     * - SBAS:    120-151, 183-192
+     * - GLONASS: 1-24, the orbital slot number (OSN), if known.  Or, if not:
+     *            93-106, the frequency channel number (FCN) (-7 to +6) offset by
+     *            + 100
+     *            i.e. report an FCN of -7 as 93, FCN of 0 as 100, and FCN of +6
+     *            as 106.
+     * - QZSS:    193-200
+     * - Galileo: 1-36
+     * - Beidou:  1-37
+     */
+
+    sv.svid = nmeaSvid;
+
+    if ((sv.svid >= 1 && sv.svid <= 32) && (type == SatelliteType::GPS_SBAS_QZSS)) {
+        sv.constellation = GnssConstellationType::GPS;
+        sv.carrierFrequencyHz = (L1BandFrequency * scale);
+    }
+    else if ((sv.svid >= 1 && sv.svid <= 36) && (type == SatelliteType::GALILEO)) {
+        sv.constellation = GnssConstellationType::GALILEO;
+        sv.carrierFrequencyHz = (L1BandFrequency * scale);
+    }
+    else if (type == SatelliteType::GLONASS) {
+        sv.constellation = GnssConstellationType::GLONASS;
+        if (sv.svid != 0) {
+            sv.svid -= 64;
+        }
+        sv.carrierFrequencyHz = (L1GlonassBandFrequency * scale);
+    }
+    else if (type == SatelliteType::BEIDOU) {
+        sv.constellation = GnssConstellationType::BEIDOU;
+        sv.carrierFrequencyHz = (B1BandFrequency * scale);
+    }
+    else if ((sv.svid >=  33) && (sv.svid <=  64)) {
+        sv.constellation = GnssConstellationType::SBAS;
+        sv.svid += 87;
+        sv.carrierFrequencyHz = (L1BandFrequency * scale);
+    }
+    else if ((sv.svid >= 152) && (sv.svid <= 158)) {
+        sv.constellation = GnssConstellationType::SBAS;
+        sv.svid += 31;
+        sv.carrierFrequencyHz = (L1BandFrequency * scale);
+    }
+    else if ((sv.svid >= 193) && (sv.svid <= 197)) {
+        sv.constellation = GnssConstellationType::QZSS;
+        sv.carrierFrequencyHz = (L1BandFrequency * scale);
+    }
+    else {
+        if (type != SatelliteType::ANY) {
+            ALOGW("Unknown constellation type with Svid = %d", sv.svid);
+        }
+        sv.constellation = GnssConstellationType::UNKNOWN;
+        sv.carrierFrequencyHz = 0.f;
+        return false;
+    }
+
+    sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
+    return true;
+}
+
+uint8_t GnssHwTTY::NMEA_ConstellationMask(SatelliteType type)
+{
+    switch (type) {
+    case SatelliteType::GPS_SBAS_QZSS:
+        return GnssSvTable::constellationBit(GnssConstellationType::GPS) |
+               GnssSvTable::constellationBit(GnssConstellationType::SBAS) |
+               GnssSvTable::constellationBit(GnssConstellationType::QZSS);
+    case SatelliteType::GLONASS:
+        return GnssSvTable::constellationBit(GnssConstellationType::GLONASS);
+    case SatelliteType::GALILEO:
+        return GnssSvTable::constellationBit(GnssConstellationType::GALILEO);
+    case SatelliteType::BEIDOU:
+        return GnssSvTable::constellationBit(GnssConstellationType::BEIDOU);
+    default:
+        return 0xFF;
+    }
+}
+
+bool GnssHwTTY::NMEA_IsSatelliteTypeAllowed(SatelliteType type)
+{
+    // GPS is always enabled
+    // Only one secondary major GNSS can be enabled
+    // Make sure that GLONASS messages are not handled when BEIDOU is active and vice versa
+    switch (mMajorGnssStatus) {
+    case MajorGnssStatus::GPS_GLONASS:
+        return (type != SatelliteType::BEIDOU);
+    case MajorGnssStatus::GPS_BEIDOU:
+        return (type != SatelliteType::GLONASS);
+    case MajorGnssStatus::GPS_ONLY:
+        return (type != SatelliteType::BEIDOU && type != SatelliteType::GLONASS);
+    }
+
+    return true;
+}
+
+void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
+{
+    ALOGV("[%s, line %d] Entry", __func__ ,__LINE__);
+
     std::vector<std::string> gsv;
     NMEA_ReaderSplitMessage(std::string(msg), gsv);
 
@@ -1198,7 +1625,7 @@ void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
         return;
     }
 
-    std::vector<IGnssCallback::GnssSvInfo>* satelliteList = &mSatellites[static_cast<int>(currentSatelliteType)];
+    const uint8_t source = static_cast<uint8_t>(currentSatelliteType);
 
     if (gsv.size() % 4) { /* Ommited sattelite c_n0_dbhz param ? */
         gsv.push_back(std::string("0")); /* Append with zero */
@@ -1209,9 +1636,6 @@ void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
     int num_svs = std::atoi(gsv[3].c_str());      // number of satellites in sentences
     bool valid_msg = true;
     bool callback_ready = false;
-    static int glonass_fcn; // GLONASS SVID can be equal to zero, which is not acceptable by Android
-    // in this case we are supposed to report FCN (frequency channel number),
-    // we don't have a real one, so let's use a simulated one
 
     if ( sentence_idx <= 0 || sentence_idx > sentences || num_svs <= 0 ) {
         valid_msg = false;
@@ -1222,145 +1646,66 @@ void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
     }
 
     if (sentence_idx == 1) {
-        // GPS is always enabled
-        // Only one secondary major GNSS can be enabled
-        // Make sure that GLONASS messages are not handled when BEIDOU is active and vice versa
-        switch (mMajorGnssStatus) {
-        case MajorGnssStatus::GPS_GLONASS:
-            mSatellites[static_cast<int>(SatelliteType::BEIDOU)].clear();
-            mSatellitesUsedInFix[static_cast<int>(SatelliteType::BEIDOU)].clear();
-            if (currentSatelliteType == SatelliteType::BEIDOU) {
-                return;
+        for (SatelliteType type : {SatelliteType::GLONASS, SatelliteType::BEIDOU}) {
+            if (!NMEA_IsSatelliteTypeAllowed(type)) {
+                mSvTable.clearSource(static_cast<uint8_t>(type));
             }
-            break;
+        }
+    }
 
-        case MajorGnssStatus::GPS_BEIDOU:
-            mSatellites[static_cast<int>(SatelliteType::GLONASS)].clear();
-            mSatellitesUsedInFix[static_cast<int>(SatelliteType::GLONASS)].clear();
-            if (currentSatelliteType == SatelliteType::GLONASS) {
-                return;
-            }
-            break;
+    if (!NMEA_IsSatelliteTypeAllowed(currentSatelliteType)) {
+        return;
+    }
 
-        case MajorGnssStatus::GPS_ONLY:
-            mSatellites[static_cast<int>(SatelliteType::BEIDOU)].clear();
-            mSatellites[static_cast<int>(SatelliteType::GLONASS)].clear();
-            mSatellitesUsedInFix[static_cast<int>(SatelliteType::BEIDOU)].clear();
-            mSatellitesUsedInFix[static_cast<int>(SatelliteType::GLONASS)].clear();
-            break;
+    const uint32_t talkerPart = 1u << source;
+
+    if (sentence_idx == 1 && mSvEpoch.hasPart(talkerPart)) {
+        /* Talker starts over without a time tag in between, the previous epoch is over */
+        if (mSvEpoch.isPending()) {
+            NMEA_SendSvStatus();
         }
+        mSvEpoch.open(mSvEpoch.getTag());
+    }
 
-        satelliteList->clear();
+    if (sentence_idx == 1) {
+        mSvTable.clearSource(source);
 
         if (currentSatelliteType == SatelliteType::GLONASS) {
-            glonass_fcn = 93;
+            mGlonassFakeFcn = 93;
         }
     }
 
     if (valid_msg) {
         // Per one GPGSV message max 4 sattelite records
         size_t offset = static_cast<size_t>((sentence_idx - 1) * 4);
-        size_t parts = static_cast<size_t>(std::min((num_svs - static_cast<int>(offset)), 4));
+        size_t parts = static_cast<size_t>(std::max(std::min((num_svs - static_cast<int>(offset)), 4), 0));
 
         for (size_t part = 0; part < parts; part++) {
-            if ((offset + part) >= static_cast<int>(GnssMax::SVS_COUNT)) {
-                break; /* out of space */
+            size_t idx = 4 + (part * 4);
+            if ((idx + 3) >= gsv.size()) {
+                break; /* truncated sentence */
             }
 
-            IGnssCallback::GnssSvInfo sv;
-
+            IGnssCallback::GnssSvInfo sv = {};
             sv.svFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA);
 
-            size_t idx = 4 + (part * 4);
-
-            /**
-             * Pseudo-random number for the SV, or FCN/OSN number for Glonass. The
-             * distinction is made by looking at constellation field. Values must be
-             * in the range of:
-             *
-             * - GNSS:    1-32
-             * - SBAS:    120-151, 183-192
-             * - GLONASS: 1-24, the orbital slot number (OSN), if known.  Or, if not:
-             *            93-106, the frequency channel number (FCN) (-7 to +6) offset by
-             *            + 100
-             *            i.e. report an FCN of -7 as 93, FCN of 0 as 100, and FCN of +6
-             *            as 106.
-             * - QZSS:    193-200
-             * - Galileo: 1-36
-             * - Beidou:  1-37
-             */
-
-            sv.svid = static_cast<int16_t>(std::atoi(gsv[idx].c_str()));
-
-            std::vector<int64_t>* usedInFix = &mSatellitesUsedInFix[static_cast<int>(currentSatelliteType)];
-            for (auto it = usedInFix->begin(); it != usedInFix->end();) {
-                if (*it == sv.svid) {
-                    sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
-                    it = usedInFix->erase(it);
-                } else {
-                    it++;
-                }
-            }
+            NMEA_SetSvIdentity(currentSatelliteType,
+                               static_cast<int16_t>(std::atoi(gsv[idx].c_str())), sv);
 
-            if ((sv.svid >= 1 && sv.svid <= 32) && (currentSatelliteType == SatelliteType::GPS_SBAS_QZSS)) {
-                sv.constellation = GnssConstellationType::GPS;
-                sv.carrierFrequencyHz = (L1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if ((sv.svid >= 1 && sv.svid <= 36) && (currentSatelliteType == SatelliteType::GALILEO)) {
-                sv.constellation = GnssConstellationType::GALILEO;
-                sv.carrierFrequencyHz = (L1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if (currentSatelliteType == SatelliteType::GLONASS) {
-                sv.constellation = GnssConstellationType::GLONASS;
-                if (sv.svid != 0) {
-                    sv.svid -= 64;
-                } else {
-                    sv.svid = static_cast<int16_t>(glonass_fcn);
-                    glonass_fcn++;
-                    if (glonass_fcn >= 106) {
-                        ALOGW("Failed to generate a fake FCN for GLONASS satellite");
-                        glonass_fcn = 0;
-                    }
-                }
-                sv.carrierFrequencyHz = (L1GlonassBandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if (currentSatelliteType == SatelliteType::BEIDOU) {
-                sv.constellation = GnssConstellationType::BEIDOU;
-                sv.carrierFrequencyHz = (B1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if ((sv.svid >=  33) && (sv.svid <=  64)) {
-                sv.constellation = GnssConstellationType::SBAS;
-                sv.svid += 87;
-                sv.carrierFrequencyHz = (L1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if ((sv.svid >= 152) && (sv.svid <= 158)) {
-                sv.constellation = GnssConstellationType::SBAS;
-                sv.svid += 31;
-                sv.carrierFrequencyHz = (L1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else if ((sv.svid >= 193) && (sv.svid <= 197)) {
-                sv.constellation = GnssConstellationType::QZSS;
-                sv.carrierFrequencyHz = (L1BandFrequency * scale);
-                sv.svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
-            }
-            else {
-                if (currentSatelliteType != SatelliteType::ANY) {
-                    ALOGW("Unknown constellation type with Svid = %d", sv.svid);
+            if (sv.constellation == GnssConstellationType::GLONASS && sv.svid == 0) {
+                sv.svid = mGlonassFakeFcn;
+                mGlonassFakeFcn++;
+                if (mGlonassFakeFcn >= 106) {
+                    ALOGW("Failed to generate a fake FCN for GLONASS satellite");
+                    mGlonassFakeFcn = 0;
                 }
-                sv.constellation = GnssConstellationType::UNKNOWN;
             }
 
             sv.elevationDegrees = static_cast<float>(std::atof(gsv[idx + 1].c_str()));
             sv.azimuthDegrees = static_cast<float>(std::atof(gsv[idx + 2].c_str()));
             sv.cN0Dbhz = static_cast<float>(std::atof(gsv[idx + 3].c_str()));
 
-            satelliteList->push_back(sv);
+            mSvTable.update(sv, source);
 
             ALOGV("GPGSV: [%zu] svid=%d, elevation=%f, azimuth=%f, c_n0_dbhz=%f", offset + part,
                   sv.svid, sv.elevationDegrees, sv.azimuthDegrees, sv.cN0Dbhz);
@@ -1368,243 +1713,237 @@ void GnssHwTTY::NMEA_ReaderParse_xxGSV(char *msg)
     }
 
     if (callback_ready) {
-        unsigned int svCount = 0;
-        for (unsigned int satType = 0; satType < static_cast<int>(SatelliteType::COUNT); satType++) {
-            for (std::vector<IGnssCallback::GnssSvInfo>::size_type satNum = 0; satNum < mSatellites[satType].size(); satNum++) {
-                mSvStatus.gnssSvList[svCount++] = mSatellites[satType].at(satNum);
-
-                if (svCount >= static_cast<unsigned int>(GnssMax::SVS_COUNT)) {
-                    satType = static_cast<int>(SatelliteType::COUNT);
-                    satNum = mSatellites[satType].size();
-                }
-            }
-        }
-        mSvStatus.numSvs = svCount;
-
-        ALOGV("GPS SV: GPS/SBAS/QZSS: %lu | GLONASS: %lu | GALILEO: %lu | BEIDOU: %lu | UNKNOWN: %lu | total: %u",
-              mSatellites[0].size(), mSatellites[1].size(), mSatellites[2].size(), mSatellites[3].size(),
-              mSatellites[4].size(), svCount);
+        mSvEpoch.addPart(talkerPart, android::elapsedRealtime());
 
-        if (mEnabled) {
-            if (mGnssCb != nullptr) {
-                auto ret = mGnssCb->gnssSvStatusCb(mSvStatus);
-                if (!ret.isOk()) {
-                    ALOGE("[%s, line %d]: Unable to invoke gnssSvStatusCb", __func__, __LINE__);
-                }
-            }
+        if (mSvEpoch.isComplete()) {
+            NMEA_SendSvStatus();
         }
     }
 }
 
-void GnssHwTTY::NMEA_ReaderParse_GxGSA(char* msg)
+int64_t GnssHwTTY::NMEA_TimeTag(const std::string& field)
 {
-    ALOGV("[%s, line %d] Entry", __func__ ,__LINE__);
+    if (field.empty()) {
+        return -1;
+    }
 
-    std::vector<std::string> gsa;
-    NMEA_ReaderSplitMessage(std::string(msg), gsa);
+    // hhmmss.ss is used as is, it only has to differ between epochs
+    return std::llround(std::atof(field.c_str()) * 1000.0);
+}
 
-    /* GSA is expected to have 19 parts */
-    if (gsa.size() != mGsaFieldsNumber) {
-        ALOGD("Dropping GSA due to invalid size (%zu)", gsa.size());
-        return;
+void GnssHwTTY::NMEA_StartEpoch(int64_t timeTag)
+{
+    if (mFixEpoch.isNewEpoch(timeTag)) {
+        if (mFixEpoch.isPending()) {
+            ALOGV("[%s, line %d] Fix epoch closed by the next epoch, parts 0x%x of 0x%x", __func__, __LINE__,
+                  mFixEpoch.getParts(), mFixEpoch.getExpected());
+            NMEA_PublishFix();
+        }
+
+        mFixEpoch.open(timeTag);
+        NMEA_ResetPendingFix();
     }
 
-    std::vector<int64_t>* satelliteList = nullptr;
-    switch (gsa.back().c_str()[0]) {
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-        satelliteList = &mSatellitesUsedInFix[gsa.back().c_str()[0] - '1'];
-        break;
-    default:
-        ALOGI("Unknown GSA GNSS System ID");
+    if (!mSvEpoch.isNewEpoch(timeTag)) {
         return;
     }
 
-    satelliteList->clear();
-    for (std::vector<std::string>::size_type gsaPart = 3; gsaPart < 15; gsaPart++) {
-        if (gsa[gsaPart].length() > 0) {
-            satelliteList->push_back(strtol(gsa[gsaPart].c_str(), nullptr, 10));
-        } else {
-            break;
-        }
+    if (mSvEpoch.isPending()) {
+        ALOGV("[%s, line %d] SV epoch closed by the next epoch, parts 0x%x of 0x%x", __func__, __LINE__,
+              mSvEpoch.getParts(), mSvEpoch.getExpected());
+        NMEA_SendSvStatus();
     }
+
+    mSvEpoch.open(timeTag);
 }
 
-void GnssHwTTY::NMEA_ReaderParse_PUBX00(char *msg)
+int64_t GnssHwTTY::NMEA_CheckEpochDeadlines()
 {
-    std::vector<std::string> pubx;
-    NMEA_ReaderSplitMessage(std::string(msg), pubx);
+    const int64_t nowMs = android::elapsedRealtime();
 
-    /* PUBX,00 is expected to have 21 parts */
-    if ((pubx.size() != pubxFieldsNumber) ||
-            (pubx[0] != "$PUBX" && pubx[1] != "00")) {
-        ALOGD("Dropping PUBX due to invalid size (%lu)", pubx.size());
-        return;
+    if (mFixEpoch.isExpired(nowMs)) {
+        ALOGD("Fix epoch deadline reached, parts 0x%x of 0x%x", mFixEpoch.getParts(), mFixEpoch.getExpected());
+        NMEA_PublishFix();
     }
 
-    if (pubx[9].length() > 0) {
-        mGnssLocation.horizontalAccuracyMeters = strtof(pubx[9].c_str(), nullptr);
-        mGnssLocation.gnssLocationFlags       |= static_cast<uint16_t>(GnssLocationFlags::HAS_HORIZONTAL_ACCURACY);
-    } else {
-        mGnssLocation.horizontalAccuracyMeters = 0.f;
-        mGnssLocation.gnssLocationFlags       &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_HORIZONTAL_ACCURACY);
+    if (mSvEpoch.isExpired(nowMs)) {
+        ALOGD("SV epoch deadline reached, parts 0x%x of 0x%x", mSvEpoch.getParts(), mSvEpoch.getExpected());
+        NMEA_SendSvStatus();
     }
 
-    if (pubx[10].length() > 0) {
-        mGnssLocation.verticalAccuracyMeters = strtof(pubx[10].c_str(), nullptr);
-        mGnssLocation.gnssLocationFlags     |= static_cast<uint16_t>(GnssLocationFlags::HAS_VERTICAL_ACCURACY);
-    } else {
-        mGnssLocation.verticalAccuracyMeters = 0.f;
-        mGnssLocation.gnssLocationFlags     &= ~static_cast<uint16_t>(GnssLocationFlags::HAS_VERTICAL_ACCURACY);
+    const int64_t fixRemainingMs = mFixEpoch.getRemainingMs(nowMs);
+    const int64_t svRemainingMs = mSvEpoch.getRemainingMs(nowMs);
+
+    if (fixRemainingMs < 0) {
+        return svRemainingMs;
+    }
+
+    if (svRemainingMs < 0) {
+        return fixRemainingMs;
     }
+
+    return std::min(fixRemainingMs, svRemainingMs);
 }
 
-bool GnssHwTTY::setUpdatePeriod(int periodMs)
+void GnssHwTTY::NMEA_SendSvStatus()
 {
-    requestedUpdateIntervalUs = periodMs * 1000;
-    return true;
+    size_t svCount = mSvTable.fillSvStatus(mSvStatus);
+    mSvEpoch.close();
+
+    ALOGV("GPS SV: visible: %zu | reported: %zu", mSvTable.getVisibleCount(), svCount);
+
+    ProvideSvStatus();
 }
 
-void GnssHwTTY::UBX_Reset()
+void GnssHwTTY::LogCallbackExecutorStats(GnssCallbackExecutor::Mailbox mailbox, const char* name)
 {
-    mUM.state             = UbxState::SYNC1;
-    mUM.rx_class          = 0;
-    mUM.rx_id             = 0;
-    mUM.rx_payload_len    = 0;
-    mUM.rx_payload_ptr    = 0;
-    mUM.rx_checksum_a     = 0;
-    mUM.rx_checksum_b     = 0;
-    mUM.rx_exp_checksum_a = 0;
-    mUM.rx_exp_checksum_b = 0;
-    mUM.buffer_ptr        = 0;
-    mUM.rx_timedout       = false;
-    mUM.msg_payload       = nullptr;
+    const GnssCallbackExecutor::Stats stats = mCallbackExecutor.GetStats(mailbox);
+    ALOGI("Callback executor %s: posted %" PRIu64 ", delivered %" PRIu64 ", coalesced %" PRIu64
+          ", failed %" PRIu64 ", dropped %" PRIu64 ", max latency %lld us, max call %lld us", name,
+          stats.posted, stats.delivered, stats.coalesced, stats.failed, stats.dropped,
+          static_cast<long long>(stats.maxLatency.count()),
+          static_cast<long long>(stats.maxCallDuration.count()));
 }
 
-void GnssHwTTY::UBX_ChecksumAdd(uint8_t ch)
+void GnssHwTTY::LogSessionUsage()
 {
-    mUM.rx_checksum_a = static_cast<uint8_t>(mUM.rx_checksum_a + ch);
-    mUM.rx_checksum_b = static_cast<uint8_t>(mUM.rx_checksum_b + mUM.rx_checksum_a);
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+
+    auto toUs = [](const struct timeval& tv) {
+        return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+    };
+
+    const double seconds = (android::elapsedRealtimeNano() - mSessionStartNs) / 1e9;
+    const long switches = (usage.ru_nvcsw - mSessionUsage.ru_nvcsw) +
+                          (usage.ru_nivcsw - mSessionUsage.ru_nivcsw);
+    const int64_t cpuUs = toUs(usage.ru_utime) + toUs(usage.ru_stime) -
+                          toUs(mSessionUsage.ru_utime) - toUs(mSessionUsage.ru_stime);
+    const GnssFixLatency::Stats latency = mFixLatency.GetStats();
+
+    ALOGI("Session %.1f s, %s: context switches %.1f/s, CPU time %" PRId64 " us, "
+          "fixes %" PRIu64 ", fix latency avg %" PRId64 " us, max %" PRId64 " us", seconds,
+          mReactorMode ? "reactor" : "worker threads", (seconds > 0) ? switches / seconds : 0.0,
+          cpuUs, latency.count, latency.avgUs, latency.maxUs);
 }
 
-void GnssHwTTY::UBX_CriticalProtocolError(const char *errormsg)
+void GnssHwTTY::ProvideSvStatus()
 {
-    ALOGE("UBX Critical protocol error: %s", errormsg);
-    CHECK_EQ(0, 1) << "UBX Critical protocol error: " << errormsg;
+    mSvStatusSnapshot.store(mSvStatus);
+
+    if (mEnabled) {
+        if (mGnssCb != nullptr && mCallbackFilter.ShouldSendSvStatus(mSvStatus, android::elapsedRealtime())) {
+            mCallbackExecutor.PostSvStatus(mSvStatus);
+        }
+    }
 }
 
-void GnssHwTTY::UBX_ReaderParse(UbxBufferElement *ubx)
+void GnssHwTTY::NMEA_ReaderParse_GxGSA(char* msg)
 {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    ALOGV("[%s, line %d] Entry", __func__ ,__LINE__);
 
-    for (mUM.buffer_ptr = 0; mUM.buffer_ptr < ubx->len; mUM.buffer_ptr++) {
-        ALOGV("UBX parser state: %d (buffer ptr: %lu)", mUM.state, mUM.buffer_ptr);
-        switch (mUM.state) {
-        case UbxState::SYNC1:
-            ALOGV("[%s, line %d] Sync1", __func__, __LINE__);
-            if (ubx->data[mUM.buffer_ptr] == mUbxSync1) {
-                mUM.state = UbxState::SYNC2;
-            } else {
-                ALOGW("UBX parser error on state UbxState::SYNC1 (%02X)", ubx->data[mUM.buffer_ptr]);
-            }
-            break;
+    const size_t gsaFirstSvField = 3;
+    const size_t gsaLastSvField = 15;
 
-        case UbxState::SYNC2:
-            ALOGV("[%s, line %d] Sync2", __func__, __LINE__);
-            if (ubx->data[mUM.buffer_ptr] == mUbxSync2) {
-                mUM.state = UbxState::CLASS;
-            } else {
-                ALOGW("UBX parser error on state UbxState::SYNC2 (%02X)", ubx->data[mUM.buffer_ptr]);
-            }
-            break;
+    std::vector<std::string> gsa;
+    NMEA_ReaderSplitMessage(std::string(msg), gsa);
 
-        case UbxState::CLASS:
-            ALOGV("[%s, line %d] Class", __func__, __LINE__);
-            UBX_ChecksumAdd(ubx->data[mUM.buffer_ptr]);
-            mUM.rx_class = ubx->data[mUM.buffer_ptr];
-            mUM.state    = UbxState::ID;
-            break;
+    /* GSA is expected to have 19 parts */
+    if (gsa.size() != mGsaFieldsNumber) {
+        ALOGD("Dropping GSA due to invalid size (%zu)", gsa.size());
+        return;
+    }
 
-        case UbxState::ID:
-            ALOGV("[%s, line %d] Id", __func__, __LINE__);
-            UBX_ChecksumAdd(ubx->data[mUM.buffer_ptr]);
-            mUM.rx_id = ubx->data[mUM.buffer_ptr];
-            mUM.state = UbxState::LENGTH1;
+    /* NMEA 4.1 reports GNSS System ID as the last field, one GSA per system */
+    SatelliteType systemType = SatelliteType::ANY;
+    if (mGsaFieldsNumber == gsaFieldsNumberNMEAv41) {
+        switch (gsa.back().c_str()[0]) {
+        case '1':
+            systemType = SatelliteType::GPS_SBAS_QZSS;
             break;
-
-        case UbxState::LENGTH1:
-            ALOGV("[%s, line %d] Length1", __func__, __LINE__);
-            UBX_ChecksumAdd(ubx->data[mUM.buffer_ptr]);
-            mUM.rx_payload_len = ubx->data[mUM.buffer_ptr];
-            mUM.state          = UbxState::LENGTH2;
+        case '2':
+            systemType = SatelliteType::GLONASS;
             break;
-
-        case UbxState::LENGTH2:
-            ALOGV("[%s, line %d] Length2", __func__, __LINE__);
-            UBX_ChecksumAdd(ubx->data[mUM.buffer_ptr]);
-            mUM.rx_payload_len += ubx->data[mUM.buffer_ptr] << 8;
-            mUM.state           = UbxState::PAYLOAD;
-            ALOGV("UBX payload len: %d", mUM.rx_payload_len);
-            if (mUM.rx_payload_len == 0) {
-                mUM.state = UbxState::CHECKSUM1;
-            }
+        case '3':
+            systemType = SatelliteType::GALILEO;
             break;
-
-        case UbxState::PAYLOAD:
-            ALOGV("[%s, line %d] Payload", __func__, __LINE__);
-            UBX_ChecksumAdd(ubx->data[mUM.buffer_ptr]);
-            if (nullptr == mUM.msg_payload) {
-                mUM.msg_payload = &(ubx->data[mUM.buffer_ptr]);
-            }
-
-            mUM.rx_payload_ptr++;
-            if (mUM.rx_payload_ptr == mUM.rx_payload_len) {
-                mUM.state = UbxState::CHECKSUM1;
-            }
+        case '4':
+            systemType = SatelliteType::BEIDOU;
             break;
+        default:
+            ALOGI("Unknown GSA GNSS System ID");
+            return;
+        }
+    }
 
-        case UbxState::CHECKSUM1:
-            ALOGV("[%s, line %d] crc 1", __func__, __LINE__);
-            mUM.rx_exp_checksum_a = ubx->data[mUM.buffer_ptr];
-            mUM.state = UbxState::CHECKSUM2;
-            break;
+    mSvTable.clearUsedInFix(NMEA_ConstellationMask(systemType));
 
-        case UbxState::CHECKSUM2:
-            ALOGV("[%s, line %d] crc 2", __func__, __LINE__);
-            mUM.rx_exp_checksum_b = ubx->data[mUM.buffer_ptr];
-            mUM.state = UbxState::FINISH;
+    for (size_t gsaPart = gsaFirstSvField; gsaPart < gsaLastSvField; gsaPart++) {
+        if (gsa[gsaPart].length() == 0) {
             break;
+        }
 
-        case UbxState::FINISH:
-            ALOGW("UBX Unexpected FINISH state in parser");
-            break;
+        int16_t nmeaSvid = static_cast<int16_t>(strtol(gsa[gsaPart].c_str(), nullptr, 10));
+        SatelliteType svType = systemType;
+        if (svType == SatelliteType::ANY) {
+            /* NMEA 2.3 numbering: GLONASS 65-96, everything else reported by GP talker */
+            svType = (nmeaSvid >= 65 && nmeaSvid <= 96) ? SatelliteType::GLONASS :
+                                                         SatelliteType::GPS_SBAS_QZSS;
+        }
+
+        IGnssCallback::GnssSvInfo sv = {};
+        if (NMEA_SetSvIdentity(svType, nmeaSvid, sv)) {
+            mSvTable.setUsedInFix(sv.constellation, sv.svid);
         }
     }
 
-    if (mUM.state == UbxState::FINISH) {
-        ALOGV("[%s, line %d] GnssUbx received message CLASS: %02X ID: %02X, len = %u", __func__, __LINE__, mUM.rx_class, mUM.rx_id, mUM.rx_payload_len);
+    /* GSA carries no time, it belongs to the fix epoch opened by RMC/GGA */
+    if (mFixEpoch.isPending()) {
+        // Fix type: 1 = not available, 2 = 2D, 3 = 3D
+        mPendingFixType = static_cast<uint8_t>(strtoul(gsa[2].c_str(), nullptr, 10));
+        NMEA_AddFixPart(FixPart::GSA);
+        NMEA_CheckFixComplete();
+    }
+}
 
-        if (mUM.rx_exp_checksum_a != mUM.rx_checksum_a ||
-                mUM.rx_exp_checksum_b != mUM.rx_checksum_b) {
-            ALOGI("[%s, line %d] UBX parser checksum fail %02X%02X/%02X%02X", __func__, __LINE__, mUM.rx_exp_checksum_a, mUM.rx_exp_checksum_b,
-                  mUM.rx_checksum_a, mUM.rx_checksum_b);
-        } else {
-            ALOGV("[%s, line %d] UBX parser checksum ok", __func__, __LINE__);
-        }
+void GnssHwTTY::NMEA_ReaderParse_PUBX00(char *msg)
+{
+    std::vector<std::string> pubx;
+    NMEA_ReaderSplitMessage(std::string(msg), pubx);
+
+    /* PUBX,00 is expected to have 21 parts */
+    if ((pubx.size() != pubxFieldsNumber) ||
+            (pubx[0] != "$PUBX" && pubx[1] != "00")) {
+        ALOGD("Dropping PUBX due to invalid size (%lu)", pubx.size());
+        return;
+    }
 
-        SelectParser(mUM.rx_class, mUM.rx_id, mUM.msg_payload, mUM.rx_payload_len);
+    NMEA_StartEpoch(NMEA_TimeTag(pubx[2]));
+    NMEA_AddFixPart(FixPart::PUBX);
 
-    } else {
-        ALOGI("[%s, line %d] UBX message incomplete, dropping (state: %d, buf: %zu/%zu, buf[ptr]: %02X",__func__, __LINE__, static_cast<int>(mUM.state),
-              mUM.buffer_ptr, ubx->len, ubx->data[mUM.buffer_ptr]);
-        for (size_t i = 0; i < ubx->len; i++) {
-            ALOGD("[%s, line %d] UBX payload[%zu] = %02X", __func__, __LINE__, i, ubx->data[i]);
-        }
+    if (pubx[9].length() > 0) {
+        mPendingLocation.horizontalAccuracyMeters = strtof(pubx[9].c_str(), nullptr);
+        mPendingLocation.gnssLocationFlags       |= static_cast<uint16_t>(GnssLocationFlags::HAS_HORIZONTAL_ACCURACY);
     }
 
-    UBX_Reset();
+    if (pubx[10].length() > 0) {
+        mPendingLocation.verticalAccuracyMeters = strtof(pubx[10].c_str(), nullptr);
+        mPendingLocation.gnssLocationFlags     |= static_cast<uint16_t>(GnssLocationFlags::HAS_VERTICAL_ACCURACY);
+    }
+
+    NMEA_CheckFixComplete();
+}
+
+bool GnssHwTTY::setUpdatePeriod(int periodMs)
+{
+    requestedUpdateIntervalUs = periodMs * 1000;
+    return true;
+}
+
+void GnssHwTTY::UBX_CriticalProtocolError(const char *errormsg)
+{
+    ALOGE("UBX Critical protocol error: %s", errormsg);
+    CHECK_EQ(0, 1) << "UBX Critical protocol error: " << errormsg;
 }
 
 void GnssHwTTY::UBX_Send(const uint8_t* msg, size_t len)
@@ -1639,11 +1978,7 @@ void GnssHwTTY::UBX_Send(const uint8_t* msg, size_t len)
 
     tx_buffer[checksum_offset_a] = 0;
     tx_buffer[checksum_offset_b] = 0;
-
-    for (size_t i = 0; i < len; i++) {
-        tx_buffer[checksum_offset_a] = static_cast<uint8_t>(tx_buffer[checksum_offset_a] + msg[i]);
-        tx_buffer[checksum_offset_b] = static_cast<uint8_t>(tx_buffer[checksum_offset_b] + tx_buffer[checksum_offset_a]);
-    }
+    GnssFramer::Fletcher8(msg, len, tx_buffer[checksum_offset_a], tx_buffer[checksum_offset_b]);
 
     // class, id
     mUM.tx_class = msg[0];
@@ -1675,6 +2010,19 @@ void GnssHwTTY::UBX_SendRepeatedWithAck(const uint8_t* msg, size_t len)
                    "UBX protocol failure (No ACK received even during retries, give up)");
 }
 
+bool GnssHwTTY::UBX_TrySendWithAck(const uint8_t* msg, size_t len)
+{
+    for (auto i = 0; i < mUbxRetriesCnt; ++i) {
+        UBX_Send(msg, len);
+        if (UBX_Wait_ACK(msg)) {
+            return true;
+        }
+    }
+
+    ALOGW("[%s, line %d] No ACK for message class 0x%02x id 0x%02x", __func__, __LINE__, msg[0], msg[1]);
+    return false;
+}
+
 void GnssHwTTY::UBX_Expect(UbxRxState astate, const char* errormsg)
 {
     UbxStateQueueElement element;
@@ -1762,29 +2110,96 @@ void GnssHwTTY::SelectParser(uint8_t cl, uint8_t id, const uint8_t* data, uint16
 
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
 
-    if (cl == classUbxRxm && id == idMeasx) {
-        auto sp = std::make_shared<GnssRxmMeasxParser>(data, dataLen);
-        instance.push(sp);
-    } else if (cl == classUbxNav && id == idClock) {
-        auto sp = std::make_shared<GnssNavClockParser>(data, dataLen);
-        instance.push(sp);
-    } else if (cl == classUbxNav && id == idTimeGps) {
-        auto sp = std::make_shared<GnssNavTimeGPSParser>(data, dataLen);
-        instance.push(sp);
-    } else if (cl == classUbxNav && id == idStatus) {
-        auto sp = std::make_shared<GnssNavStatusParser>(data, dataLen);
-        instance.push(sp);
-    } else if (mAckClass == cl && mAckAckId == id) {
+    switch (ubxDispatch.find(UbxDispatch::key(cl, id))) {
+    case routeRxmMeasx:
+        instance.emplace<GnssRxmMeasxParser>(data, dataLen);
+        break;
+    case routeRxmRawx:
+        instance.emplace<GnssRxmRawxParser>(data, dataLen);
+        break;
+    case routeRxmSfrbx:
+        GnssNavMsgQueue::getInstance().push(data, dataLen);
+        break;
+    case routeNavClock:
+        instance.emplace<GnssNavClockParser>(data, dataLen);
+        break;
+    case routeNavTimeGps:
+        instance.emplace<GnssNavTimeGPSParser>(data, dataLen);
+        break;
+    case routeNavStatus:
+        instance.emplace<GnssNavStatusParser>(data, dataLen);
+        break;
+    case routeNavPvt:
+        UBX_NavPvtParse(data, dataLen);
+        break;
+    case routeNavSat:
+        UBX_NavSatParse(id, data, dataLen);
+        break;
+    case routeAckAck:
         UBX_ACKParse(data, dataLen);
-    } else if (mAckClass == cl && mAckNakId == id) {
+        break;
+    case routeAckNak:
         UBX_NACKParse(data, dataLen);
-    } else if (classUbxMon == cl && idVer == id) {
+        break;
+    case routeMonVer:
         UBX_MonVerParse(reinterpret_cast<const char*>(data), dataLen);
+        break;
+    default:
+        // not reached while ConfigureUbxFilter marks only routed messages as wanted
+        ALOGV("[%s, line %d] Unknown message class 0x%02x id 0x%02x", __func__, __LINE__, cl, id);
+        break;
     }
 
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
 
+void GnssHwTTY::UBX_NavPvtParse(const uint8_t* data, uint16_t dataLen)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    GnssNavPvtParser parser(data, dataLen);
+    if (!parser.getLocation(mGnssLocation)) {
+        ALOGV("[%s, line %d] No valid fix in NAV-PVT", __func__, __LINE__);
+        if (mUbxOnly && mEnabled) {
+            mNmeaGenerator.PutNoFix(parser.getUtcTimeMs(), NowUtcMs());
+        } else {
+            mNmeaGenerator.ClearFix();
+        }
+        return;
+    }
+
+    if (mUbxOnly && mEnabled) {
+        mNmeaGenerator.PutFix(mGnssLocation, parser.getAltitudeMslMeters(), parser.getPDop(),
+                              parser.getNumSv(), NowUtcMs());
+    }
+
+    ProvideLocation(mUbxReceivedNs);
+}
+
+void GnssHwTTY::UBX_NavSatParse(uint8_t id, const uint8_t* data, uint16_t dataLen)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mUbxSvStatus) {
+        return;
+    }
+
+    GnssNavSatParser parser(id == idSat ? GnssNavSatParser::Format::NavSat :
+                                          GnssNavSatParser::Format::NavSvInfo, data, dataLen);
+    if (!parser.getSvStatus(mSvStatus)) {
+        ALOGV("[%s, line %d] Invalid satellite message", __func__, __LINE__);
+        return;
+    }
+
+    ALOGV("GPS SV: reported: %u", mSvStatus.numSvs);
+
+    if (mUbxOnly && mEnabled) {
+        mNmeaGenerator.PutSvStatus(mSvStatus, NowUtcMs());
+    }
+
+    ProvideSvStatus();
+}
+
 void GnssHwTTY::UBX_ACKParse(const uint8_t* data, uint16_t dataLen)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
@@ -41,6 +41,13 @@ public:
      */
     virtual uint8_t retrieveSvInfo(MeasurementCb::GnssData &gnssData) = 0;
 
+    /*!
+     * \brief getEpoch - provide the measurement epoch the parsed message belongs to
+     * \param iTow - GPS time of week of the epoch in ms
+     * \return GnssIParserReturn::*Done part the message adds to the epoch, NotReady if none
+     */
+    virtual uint8_t getEpoch(uint32_t& iTow) { (void)iTow; return NotReady; }
+
     /*!
      * \brief dumpDebug - print some debug info or hexdump for concrete parser
      */
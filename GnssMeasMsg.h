@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSMEASMSG_H__
+#define __GNSSMEASMSG_H__
+
+#include <variant>
+
+#include "GnssIParser.h"
+#include "GnssNavClockParser.h"
+#include "GnssNavStatusParser.h"
+#include "GnssNavTimeGPSParser.h"
+#include "GnssRxmMeasxParser.h"
+#include "GnssRxmRawxParser.h"
+
+/*!
+ * \brief GnssMeasMsg - decoded measurement message carried by value, std::monostate if empty
+ */
+typedef std::variant<std::monostate, GnssRxmMeasxParser, GnssRxmRawxParser,
+                     GnssNavTimeGPSParser, GnssNavClockParser, GnssNavStatusParser> GnssMeasMsg;
+
+/*!
+ * \brief GnssMeasMsgRetrieve - visitor, fill the gnssData object with the data of the message
+ * \brief the parsers are visited by their final type, no virtual call is done
+ */
+struct GnssMeasMsgRetrieve {
+    MeasurementCb::GnssData& gnssData;
+
+    uint8_t operator()(std::monostate&) const { return GnssIParser::NotReady; }
+
+    template <typename Parser>
+    uint8_t operator()(Parser& parser) const { return parser.Parser::retrieveSvInfo(gnssData); }
+};
+
+/*!
+ * \brief GnssMeasMsgEpoch - visitor, provide iTOW and the epoch part of the message
+ */
+struct GnssMeasMsgEpoch {
+    uint32_t& iTow;
+
+    uint8_t operator()(std::monostate&) const { return GnssIParser::NotReady; }
+
+    template <typename Parser>
+    uint8_t operator()(Parser& parser) const { return parser.Parser::getEpoch(iTow); }
+};
+
+#endif // __GNSSMEASMSG_H__
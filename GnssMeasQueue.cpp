@@ -17,10 +17,15 @@
 #define LOG_TAG "GnssMeasQueue"
 #define LOG_NDEBUG 1
 
+#include <algorithm>
+#include <cstdlib>
 #include <log/log.h>
+#include <thread>
 
 #include "GnssMeasQueue.h"
 
+static const int64_t msInWeek = 604800000;
+
 GnssMeasQueue& GnssMeasQueue::getInstance() {
     static GnssMeasQueue instance;
     return instance;
@@ -29,65 +34,390 @@ GnssMeasQueue& GnssMeasQueue::getInstance() {
 GnssMeasQueue::GnssMeasQueue()
 {
     ALOGV("[%s, line %d] Constructor", __func__, __LINE__);
-    mQueue = std::make_unique<msgQueue>();
+    for (size_t i = 0; i < mMaxSize; ++i) {
+        mRing[i].sequence.store(i, std::memory_order_relaxed);
+    }
 }
 
-void GnssMeasQueue::push(std::shared_ptr<GnssIParser> sp)
+GnssMeasQueue::Cell* GnssMeasQueue::claimCell(size_t& pos)
 {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    std::lock_guard<std::mutex> lock(mLock);
-    if (mMaxSize > mQueue->size() && mState) {
-        mQueue->push(sp);
-        ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, mQueue->size());
+    pos = mEnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = mRing[pos % mMaxSize];
+        const size_t seq = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+        if (0 == dif) {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return &cell;
+            }
+            continue;
+        }
+
+        if (dif > 0) {
+            // another producer took the position
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (mDequeuePos.load(std::memory_order_relaxed) + mMaxSize > pos) {
+            // the cell is being consumed right now
+            std::this_thread::yield();
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        if (DropPolicy::DropNewest == mDropPolicy.load(std::memory_order_relaxed)) {
+            ALOGV("[%s, line %d] queue is full, newest dropped", __func__, __LINE__);
+            return nullptr;
+        }
+
+        ALOGV("[%s, line %d] queue is full, oldest dropped", __func__, __LINE__);
+        consumeCell([](Cell&) {});
+        pos = mEnqueuePos.load(std::memory_order_relaxed);
     }
 }
 
+void GnssMeasQueue::publishCell(Cell& cell, const size_t pos)
+{
+    cell.sequence.store(pos + 1, std::memory_order_release);
+    mPushed.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t size = pos + 1 - std::min(pos + 1, mDequeuePos.load(std::memory_order_relaxed));
+    size_t highWater = mHighWater.load(std::memory_order_relaxed);
+    while (size > highWater &&
+            !mHighWater.compare_exchange_weak(highWater, size, std::memory_order_relaxed)) {
+    }
 
-std::shared_ptr<GnssIParser> GnssMeasQueue::pop()
+    // pairs with the fence in waitLocked, either the consumer sees the message
+    // or the producer sees the consumer sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mWaiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mLock);
+        mCond.notify_one();
+    }
+}
+
+bool GnssMeasQueue::hasData()
+{
+    const size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+    return mRing[pos % mMaxSize].sequence.load(std::memory_order_acquire) == pos + 1;
+}
+
+void GnssMeasQueue::waitLocked(std::unique_lock<std::mutex>& lock, const Clock::time_point deadline)
+{
+    mWaiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto pred = [this] { return hasData() || mWakeUp; };
+    if (Clock::time_point::max() == deadline) {
+        mCond.wait(lock, pred);
+    } else {
+        mCond.wait_until(lock, deadline, pred);
+    }
+
+    mWaiting.store(false, std::memory_order_relaxed);
+}
+
+bool GnssMeasQueue::pop(GnssMeasMsg& msg)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    std::lock_guard<std::mutex> lock(mLock);
-    if (mQueue->empty()) {
-        ALOGV("[%s, line %d] return nullprt ", __func__, __LINE__);
-        return nullptr;
+    const size_t popped = drain([&msg](GnssMeasMsg& front, Clock::time_point) {
+        msg = std::move(front);
+        return false;
+    }, 1);
+
+    return 0 != popped;
+}
+
+bool GnssMeasQueue::waitAndPop(GnssMeasMsg& msg)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::unique_lock<std::mutex> lock(mLock);
+    while (!pop(msg)) {
+        if (mWakeUp) {
+            mWakeUp = false;
+            ALOGV("[%s, line %d] woken up", __func__, __LINE__);
+            return false;
+        }
+
+        waitLocked(lock, Clock::time_point::max());
     }
 
-    ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, mQueue->size());
-    auto val = mQueue->front();
-    mQueue->pop();
+    return true;
+}
 
-    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
-    return val;
+int32_t GnssMeasQueue::towDiff(const uint32_t a, const uint32_t b)
+{
+    int64_t diff = (static_cast<int64_t>(a) - static_cast<int64_t>(b)) % msInWeek;
+    if (diff >= msInWeek / 2) {
+        diff -= msInWeek;
+    } else if (diff < -msInWeek / 2) {
+        diff += msInWeek;
+    }
+
+    return static_cast<int32_t>(diff);
 }
 
-size_t GnssMeasQueue::getSize()
+bool GnssMeasQueue::addPart(GnssMeasMsg& msg, const Clock::time_point pushed)
+{
+    uint32_t iTow = 0;
+    const uint8_t part = std::visit(GnssMeasMsgEpoch{iTow}, msg);
+    if (GnssIParser::NotReady == part) {
+        ALOGV("[%s, line %d] message without epoch discarded", __func__, __LINE__);
+        mStats.discardedParts++;
+        return false;
+    }
+
+    Slot* target = nullptr;
+    Slot* oldest = nullptr;
+    for (auto& slot : mSlots) {
+        if (SlotState::Free == slot.state) {
+            if (nullptr == target) {
+                target = &slot;
+            }
+            continue;
+        }
+
+        if (std::abs(towDiff(iTow, slot.epoch.iTow)) <= static_cast<int32_t>(mITowToleranceMs)) {
+            target = &slot;
+            break;
+        }
+
+        if (SlotState::Pending == slot.state &&
+                (nullptr == oldest || slot.epoch.firstPush < oldest->epoch.firstPush)) {
+            oldest = &slot;
+        }
+    }
+
+    if (nullptr == target) {
+        if (nullptr == oldest) {
+            ALOGW("[%s, line %d] no slot for epoch %u", __func__, __LINE__, iTow);
+            mStats.discardedParts++;
+            return false;
+        }
+
+        ALOGV("[%s, line %d] epoch %u evicted", __func__, __LINE__, oldest->epoch.iTow);
+        mStats.droppedIncomplete++;
+        oldest->state = SlotState::Free;
+        target = oldest;
+    }
+
+    if (SlotState::Ready == target->state) {
+        ALOGV("[%s, line %d] late part %02X of epoch %u", __func__, __LINE__, part, iTow);
+        mStats.discardedParts++;
+        return false;
+    }
+
+    Epoch& epoch = target->epoch;
+    if (SlotState::Free == target->state) {
+        epoch = Epoch();
+        epoch.iTow = iTow;
+        epoch.firstPush = pushed;
+        target->state = SlotState::Pending;
+    } else if (epoch.flags & part) {
+        mStats.replacedParts++;
+    }
+
+    epoch.parts[__builtin_ctz(part)] = std::move(msg);
+    epoch.flags |= part;
+    if (GnssIParser::Ready != epoch.flags) {
+        return false;
+    }
+
+    // the parts of the older epochs are not expected anymore
+    for (auto& slot : mSlots) {
+        if (&slot != target && SlotState::Pending == slot.state &&
+                towDiff(slot.epoch.iTow, epoch.iTow) < 0) {
+            expireEpoch(slot, pushed);
+        }
+    }
+
+    epoch.latency = pushed - epoch.firstPush;
+    target->state = SlotState::Ready;
+    mStats.completed++;
+    mStats.lastLatency = epoch.latency;
+    mStats.maxLatency = std::max(mStats.maxLatency, epoch.latency);
+
+    return true;
+}
+
+void GnssMeasQueue::assembleEpochs()
+{
+    drain([this](GnssMeasMsg& msg, const Clock::time_point pushed) {
+        return !addPart(msg, pushed);
+    });
+}
+
+void GnssMeasQueue::expireEpoch(Slot& slot, const Clock::time_point now)
+{
+    if (IncompletePolicy::Emit == mIncompletePolicy && (slot.epoch.flags & GnssIParser::RxmDone)) {
+        ALOGV("[%s, line %d] epoch %u emitted incomplete %02X", __func__, __LINE__,
+              slot.epoch.iTow, slot.epoch.flags);
+        slot.epoch.latency = now - slot.epoch.firstPush;
+        slot.state = SlotState::Ready;
+        mStats.emittedIncomplete++;
+        return;
+    }
+
+    ALOGV("[%s, line %d] epoch %u dropped incomplete %02X", __func__, __LINE__,
+          slot.epoch.iTow, slot.epoch.flags);
+    slot.state = SlotState::Free;
+    slot.epoch = Epoch();
+    mStats.droppedIncomplete++;
+}
+
+GnssMeasQueue::Clock::time_point GnssMeasQueue::expireEpochs(const Clock::time_point now)
+{
+    Clock::time_point nearest = Clock::time_point::max();
+    for (auto& slot : mSlots) {
+        if (SlotState::Pending != slot.state) {
+            continue;
+        }
+
+        const Clock::time_point deadline = slot.epoch.firstPush + mEpochDeadline;
+        if (deadline <= now) {
+            expireEpoch(slot, now);
+        } else {
+            nearest = std::min(nearest, deadline);
+        }
+    }
+
+    return nearest;
+}
+
+bool GnssMeasQueue::takeReadyEpoch(Epoch& epoch)
+{
+    Slot* oldest = nullptr;
+    for (auto& slot : mSlots) {
+        if (SlotState::Ready == slot.state &&
+                (nullptr == oldest || slot.epoch.firstPush < oldest->epoch.firstPush)) {
+            oldest = &slot;
+        }
+    }
+
+    if (nullptr == oldest) {
+        return false;
+    }
+
+    epoch = std::move(oldest->epoch);
+    oldest->epoch = Epoch();
+    oldest->state = SlotState::Free;
+
+    return true;
+}
+
+void GnssMeasQueue::clearSlots()
+{
+    for (auto& slot : mSlots) {
+        slot.state = SlotState::Free;
+        slot.epoch = Epoch();
+    }
+}
+
+bool GnssMeasQueue::popEpoch(Epoch& epoch)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        assembleEpochs();
+        const Clock::time_point deadline = expireEpochs(Clock::now());
+        if (takeReadyEpoch(epoch)) {
+            ALOGV("[%s, line %d] epoch %u, parts %02X", __func__, __LINE__, epoch.iTow, epoch.flags);
+            return true;
+        }
+
+        if (mWakeUp) {
+            mWakeUp = false;
+            ALOGV("[%s, line %d] woken up", __func__, __LINE__);
+            return false;
+        }
+
+        waitLocked(lock, deadline);
+    }
+}
+
+void GnssMeasQueue::setEpochDeadline(const Clock::duration deadline)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mEpochDeadline = deadline;
+}
+
+void GnssMeasQueue::setIncompletePolicy(const IncompletePolicy policy)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    mIncompletePolicy = policy;
+}
+
+GnssMeasQueue::EpochStats GnssMeasQueue::getEpochStats()
+{
     std::lock_guard<std::mutex> lock(mLock);
-    ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, mQueue->size());
-    return mQueue->size();
+    return mStats;
+}
+
+void GnssMeasQueue::wakeUp()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mWakeUp = true;
+    }
+
+    mCond.notify_all();
+}
 
+size_t GnssMeasQueue::getSize()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    const size_t dequeuePos = mDequeuePos.load(std::memory_order_acquire);
+    const size_t enqueuePos = mEnqueuePos.load(std::memory_order_acquire);
+    const size_t size = std::min(enqueuePos - std::min(enqueuePos, dequeuePos), mMaxSize);
+    ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, size);
+    return size;
 }
 
 bool GnssMeasQueue::empty()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    std::lock_guard<std::mutex> lock(mLock);
-    ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, mQueue->size());
-    return mQueue->empty();
+    return 0 == getSize();
 }
 
+void GnssMeasQueue::setDropPolicy(const DropPolicy policy)
+{
+    mDropPolicy.store(policy, std::memory_order_relaxed);
+}
+
+GnssMeasQueue::QueueStats GnssMeasQueue::getQueueStats()
+{
+    QueueStats stats;
+    stats.pushed = mPushed.load(std::memory_order_relaxed);
+    stats.popped = mPopped.load(std::memory_order_relaxed);
+    stats.dropped = mDropped.load(std::memory_order_relaxed);
+    stats.highWater = mHighWater.load(std::memory_order_relaxed);
+    stats.size = getSize();
+    return stats;
+}
 
 void GnssMeasQueue::setState(const bool state)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    std::lock_guard<std::mutex> lock(mLock);
-    mState = state;
-    if (!state){
-        while(!mQueue->empty()) {
-            mQueue->pop();
-            ALOGV("[%s, line %d] size = %zu", __func__, __LINE__, mQueue->size());
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mState.store(state, std::memory_order_release);
+        if (state) {
+            // a wake up left from the previous session is not relevant anymore
+            mWakeUp = false;
+        } else {
+            while (consumeCell([](Cell&) {})) {
+            }
+            clearSlots();
+            mWakeUp = true;
         }
+        ALOGV("[%s, line %d] Exit, size = %zu", __func__, __LINE__, getSize());
+    }
+
+    if (!state) {
+        mCond.notify_all();
     }
-    ALOGV("[%s, line %d] Exit, size = %zu", __func__, __LINE__, mQueue->size());
 }
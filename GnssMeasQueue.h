@@ -17,16 +17,77 @@
 #ifndef __GNSSMEASQUEUE_H__
 #define __GNSSMEASQUEUE_H__
 
-#include <list>
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 
-#include "GnssIParser.h"
+#include "GnssMeasMsg.h"
 
 
 class GnssMeasQueue
 {
 public:
+    typedef std::chrono::steady_clock Clock;
+
+    static constexpr size_t mMaxSize = 100;
+    static constexpr size_t mPartsCount = 4;
+    static constexpr size_t mSlotsCount = 4;
+    static constexpr uint32_t mITowToleranceMs = 25;
+    static constexpr std::chrono::milliseconds mDefaultEpochDeadline{500};
+
+    /*!
+     * \brief DropPolicy - which message is dropped when a message is pushed to the full queue
+     */
+    enum class DropPolicy : uint8_t {
+        DropOldest,
+        DropNewest,
+    };
+
+    /*!
+     * \brief IncompletePolicy - what is done with an epoch which is not complete at its deadline,
+     * \brief an epoch is emitted incomplete only if it has the measurements part
+     */
+    enum class IncompletePolicy : uint8_t {
+        Drop,
+        Emit,
+    };
+
+    /*!
+     * \brief Epoch - parsed messages of one measurement epoch, indexed by the bit of their part
+     */
+    struct Epoch {
+        uint32_t iTow = 0;
+        uint8_t flags = GnssIParser::NotReady;
+        Clock::time_point firstPush;
+        Clock::duration latency = Clock::duration::zero();
+        GnssMeasMsg parts[mPartsCount];
+    };
+
+    /*!
+     * \brief EpochStats - counters of the epoch assembly
+     */
+    struct EpochStats {
+        uint64_t completed = 0;
+        uint64_t emittedIncomplete = 0;
+        uint64_t droppedIncomplete = 0;
+        uint64_t discardedParts = 0;
+        uint64_t replacedParts = 0;
+        Clock::duration lastLatency = Clock::duration::zero();
+        Clock::duration maxLatency = Clock::duration::zero();
+    };
+
+    /*!
+     * \brief QueueStats - counters of the message ring
+     */
+    struct QueueStats {
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        uint64_t dropped = 0;
+        size_t highWater = 0;
+        size_t size = 0;
+    };
+
     ~GnssMeasQueue() {}
 
     /*!
@@ -37,17 +98,108 @@ public:
     static GnssMeasQueue& getInstance();
 
     /*!
-     * \brief push -  add an object to the end of the queue
-     * \brief works only if mState is set as true
-     * \param object - a pointer to the new object
+     * \brief emplace - decode the message in place at the end of the queue and wake up the consumer
+     * \brief works only if mState is set as true, no memory is allocated and no lock is taken
+     * \brief unless the consumer sleeps, the full queue is handled by DropPolicy
+     * \param payload - UBX payload of the message
+     * \param payloadLen - length of the payload
+     */
+    template <typename Parser>
+    void emplace(const uint8_t* payload, uint16_t payloadLen)
+    {
+        if (!mState.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        size_t pos = 0;
+        Cell* cell = claimCell(pos);
+        if (nullptr == cell) {
+            return;
+        }
+
+        cell->msg.emplace<Parser>(payload, payloadLen);
+        cell->pushed = Clock::now();
+        publishCell(*cell, pos);
+    }
+
+    /*!
+     * \brief drain - consume the queued messages in one batch, in place
+     * \param consumer - called as consumer(msg, pushTime) for every message, returns false to stop
+     * \param maxCount - maximum number of messages to consume
+     * \return number of consumed messages
+     */
+    template <typename Consumer>
+    size_t drain(Consumer&& consumer, const size_t maxCount = mMaxSize)
+    {
+        size_t count = 0;
+        bool more = true;
+        while (more && count < maxCount && consumeCell([&consumer, &more](Cell& cell) {
+                    more = consumer(cell.msg, cell.pushed);
+                })) {
+            count++;
+        }
+
+        mPopped.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    /*!
+     * \brief pop - provide the first(front) message and remove it from the queue
+     * \param msg - output, the message
+     * \return true if there was a message, false if the queue is empty
+     */
+    bool pop(GnssMeasMsg& msg);
+
+    /*!
+     * \brief waitAndPop - wait without timeout for a message, provide it and remove it from the queue
+     * \param msg - output, the message
+     * \return true if msg was filled, false if the wait was interrupted by wakeUp or setState(false)
+     */
+    bool waitAndPop(GnssMeasMsg& msg);
+
+    /*!
+     * \brief popEpoch - wait for a measurement epoch, group the queued messages by their iTOW
+     * \brief an epoch is provided as soon as all its parts are present, an incomplete one
+     * \brief is handled by IncompletePolicy at its deadline or when a later epoch completes
+     * \param epoch - output, parsers of the epoch and its completion latency
+     * \return true if epoch was filled, false if the wait was interrupted by wakeUp or setState(false)
+     */
+    bool popEpoch(Epoch& epoch);
+
+    /*!
+     * \brief wakeUp - interrupt the wait of the consumer, e.g. to let it exit
+     */
+    void wakeUp();
+
+    /*!
+     * \brief setEpochDeadline - set the time an epoch waits for its missing parts
+     * \param deadline - time counted from the push of the first part of the epoch
+     */
+    void setEpochDeadline(const Clock::duration deadline);
+
+    /*!
+     * \brief setIncompletePolicy - set what is done with the epochs not complete at their deadline
+     * \param policy - Drop or Emit
+     */
+    void setIncompletePolicy(const IncompletePolicy policy);
+
+    /*!
+     * \brief getEpochStats - provide the counters of the epoch assembly
+     * \return copy of the counters
+     */
+    EpochStats getEpochStats();
+
+    /*!
+     * \brief setDropPolicy - set which message is dropped when the queue is full
+     * \param policy - DropOldest (default) or DropNewest
      */
-    void push(std::shared_ptr<GnssIParser> object);
+    void setDropPolicy(const DropPolicy policy);
 
     /*!
-     * \brief pop - provide the first(front) object and remove it from the queue
-     * \return - a pointer to the object
+     * \brief getQueueStats - provide the counters of the message ring
+     * \return copy of the counters
      */
-    std::shared_ptr<GnssIParser> pop();
+    QueueStats getQueueStats();
 
     /*!
      * \brief empty - denote if the queue is empty or not
@@ -75,12 +227,135 @@ private:
     GnssMeasQueue(GnssMeasQueue const&) = delete;
     GnssMeasQueue &operator=(GnssMeasQueue const&) = delete;
 
-    const size_t mMaxSize = 100;
-    bool mState = false;
+    enum class SlotState : uint8_t {
+        Free,
+        Pending,
+        Ready,
+    };
+
+    struct Slot {
+        SlotState state = SlotState::Free;
+        Epoch epoch;
+    };
+
+    /*!
+     * \brief towDiff - signed difference of two iTOW values, week rollover is taken into account
+     */
+    static int32_t towDiff(const uint32_t a, const uint32_t b);
+
+    /*!
+     * \brief assembleEpochs - move the queued messages to the epoch slots,
+     * \brief stops after the first epoch becomes complete
+     */
+    void assembleEpochs();
+
+    /*!
+     * \brief addPart - put the message to the slot of its epoch, take a free slot for a new epoch
+     * \return true if the epoch of the message became complete
+     */
+    bool addPart(GnssMeasMsg& msg, const Clock::time_point pushed);
 
-    typedef std::queue<std::shared_ptr<GnssIParser>, std::list<std::shared_ptr<GnssIParser>>> msgQueue;
-    std::unique_ptr<msgQueue> mQueue;
+    /*!
+     * \brief expireEpoch - apply IncompletePolicy to the pending slot
+     */
+    void expireEpoch(Slot& slot, const Clock::time_point now);
+
+    /*!
+     * \brief expireEpochs - expire the pending slots which reached their deadline
+     * \return the nearest deadline of the slots still pending, Clock::time_point::max() if none
+     */
+    Clock::time_point expireEpochs(const Clock::time_point now);
+
+    /*!
+     * \brief takeReadyEpoch - move the oldest ready epoch to the output and free its slot
+     * \return true if there was a ready epoch
+     */
+    bool takeReadyEpoch(Epoch& epoch);
+
+    void clearSlots();
+
+    /*!
+     * \brief Cell - element of the ring, sequence tells if the cell is free or published
+     * \brief for the current lap of the enqueue and dequeue positions
+     */
+    struct Cell {
+        std::atomic<size_t> sequence;
+        GnssMeasMsg msg;
+        Clock::time_point pushed;
+    };
+
+    /*!
+     * \brief claimCell - reserve the cell at the enqueue position, apply DropPolicy if full
+     * \param pos - output, enqueue position of the cell
+     * \return the cell, nullptr if the new message is dropped
+     */
+    Cell* claimCell(size_t& pos);
+
+    /*!
+     * \brief publishCell - make the claimed cell visible to the consumer, wake it up if it sleeps
+     */
+    void publishCell(Cell& cell, const size_t pos);
+
+    /*!
+     * \brief consumeCell - reserve the cell at the dequeue position, pass it to fn and free it
+     * \return true if a cell was consumed, false if the queue is empty
+     */
+    template <typename Fn>
+    bool consumeCell(Fn&& fn)
+    {
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = mRing[pos % mMaxSize];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (0 == dif) {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fn(cell);
+                    cell.sequence.store(pos + mMaxSize, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /*!
+     * \brief hasData - check if the cell at the dequeue position is published
+     */
+    bool hasData();
+
+    /*!
+     * \brief waitLocked - sleep until a message is published, wakeUp is called or the deadline
+     */
+    void waitLocked(std::unique_lock<std::mutex>& lock, const Clock::time_point deadline);
+
+    std::atomic<bool> mState{false};
+    std::atomic<DropPolicy> mDropPolicy{DropPolicy::DropOldest};
+
+    // bounded MPMC ring with per cell sequence numbers, producers never take mLock
+    Cell mRing[mMaxSize];
+    alignas(64) std::atomic<size_t> mEnqueuePos{0};
+    alignas(64) std::atomic<size_t> mDequeuePos{0};
+
+    std::atomic<uint64_t> mPushed{0};
+    std::atomic<uint64_t> mPopped{0};
+    std::atomic<uint64_t> mDropped{0};
+    std::atomic<size_t> mHighWater{0};
+
+    // mLock protects the consumer side: the wait, mWakeUp and the epoch slots
     std::mutex mLock;
+    std::condition_variable mCond;
+    std::atomic<bool> mWaiting{false};
+    bool mWakeUp = false;
+
+    Slot mSlots[mSlotsCount];
+    Clock::duration mEpochDeadline = mDefaultEpochDeadline;
+    IncompletePolicy mIncompletePolicy = IncompletePolicy::Drop;
+    EpochStats mStats;
 };
 
 #endif // __GNSSMEASQUEUE_H__
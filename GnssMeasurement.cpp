@@ -18,10 +18,11 @@
 
 #include <memory>
 
-#include "GnssMeasToLocSync.h"
+#include "GnssEpochBarrier.h"
 #include "GnssMeasurement.h"
 #include "GnssMeasQueue.h"
 #include "GnssIParser.h"
+#include "GnssThreadPolicy.h"
 
 namespace android {
 namespace hardware {
@@ -31,7 +32,6 @@ namespace renesas {
 
 static const bool on = true;
 static const bool off = false;
-static const int8_t measBeforeLocationEventsNum = 2; // value depends on CTS testGnssMeasurementWhenNoLocation
 
 sp<MeasurementCb> GnssMeasurementImpl::sGnssMeasurementsCbIface = nullptr;
 
@@ -49,8 +49,9 @@ Return<GnssMeasurementImpl::GnssMeasurementStatus> GnssMeasurementImpl::setCallb
         return GnssMeasurementStatus::ERROR_ALREADY_INIT;
     }
 
-    GnssMeasToLocSync& syncInstance = GnssMeasToLocSync::getInstance();
-    syncInstance.SetEventsToWait(measBeforeLocationEventsNum);
+    // locations are held until the measurements of their epoch are delivered,
+    // CTS testGnssMeasurementWhenNoLocation depends on it
+    GnssEpochBarrier::getInstance().setLaneActive(GnssEpochBarrier::Lane::Measurement, true);
 
     sGnssMeasurementsCbIface = callback;
     ALOGD("%s: GnssMeasurements initialized", __func__);
@@ -70,12 +71,11 @@ Return<void> GnssMeasurementImpl::close()
         return Void();
     }
 
-    GnssMeasToLocSync& syncInstance = GnssMeasToLocSync::getInstance();
-    syncInstance.SetEventsToWait(0);
+    GnssEpochBarrier::getInstance().setLaneActive(GnssEpochBarrier::Lane::Measurement, false);
 
     sGnssMeasurementsCbIface = nullptr;
     mThreadExit = true;
-    mCallbackCond.notify_one();
+    GnssMeasQueue::getInstance().wakeUp();
     if (mGnssMeasurementsCallbackThread.joinable()) {
         mGnssMeasurementsCallbackThread.join();
     }
@@ -87,33 +87,57 @@ Return<void> GnssMeasurementImpl::close()
 void GnssMeasurementImpl::callbackThread(void)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Callback, "gnss_meas_cb");
 
-    GnssMeasToLocSync& syncInstance = GnssMeasToLocSync::getInstance();
+    GnssEpochBarrier& barrier = GnssEpochBarrier::getInstance();
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(on);
+
+    // The queue groups the parts of one epoch by iTOW, so the clock and
+    // the measurements of every callback refer to the same instant
+    GnssMeasQueue::Epoch epoch;
     while (!mThreadExit) {
-        uint8_t flagReady = 0;
-        auto data = std::make_unique<MeasurementCb::GnssData> ();
-        while (!instance.empty()) {
-            auto parser = instance.pop();
-            if (nullptr == parser) {
-                ALOGV("[%s, line %d] parser is null", __func__, __LINE__);
-                continue;
-            }
-            flagReady |= parser->retrieveSvInfo(*data);
-
-            if (sGnssMeasurementsCbIface != nullptr && GnssIParser::Ready == flagReady) {
-                sGnssMeasurementsCbIface->GnssMeasurementCb(*data);
-                ALOGD("GNSS Measurements sent");
-                syncInstance.UpdateStatus((int8_t)-1);
-                break;
-            }
+        if (!instance.popEpoch(epoch)) {
+            ALOGV("[%s, line %d] woken up without data", __func__, __LINE__);
+            continue;
+        }
+
+        MeasurementCb::GnssData& data = mDataPool.acquire();
+        for (auto& part : epoch.parts) {
+            std::visit(GnssMeasMsgRetrieve{data}, part);
+        }
+        ALOGV("[%s, line %d] epoch %u, parts %02X, latency %lld us", __func__, __LINE__,
+              epoch.iTow, epoch.flags, static_cast<long long>(
+              std::chrono::duration_cast<std::chrono::microseconds>(epoch.latency).count()));
+
+        const bool hasLeapSecond = data.clock.gnssClockFlags &
+                static_cast<uint16_t>(MeasurementCb::GnssClockFlags::HAS_LEAP_SECOND);
+        const int64_t key = GnssEpochBarrier::keyFromGpsTow(epoch.iTow, hasLeapSecond ?
+                data.clock.leapSecond : GnssEpochBarrier::mDefaultLeapSeconds);
+
+        if (sGnssMeasurementsCbIface != nullptr &&
+                barrier.waitTurn(GnssEpochBarrier::Lane::Measurement, key)) {
+            sGnssMeasurementsCbIface->GnssMeasurementCb(data);
+            ALOGD("GNSS Measurements sent");
+            barrier.release(GnssEpochBarrier::Lane::Measurement, key);
         }
-        std::unique_lock<std::mutex> lock(mCallbackMutex);
-        mCallbackCond.wait_for(lock,
-                      std::chrono::seconds(1));
     }
 
+    const GnssMeasQueue::EpochStats stats = instance.getEpochStats();
+    ALOGI("[%s, line %d] epochs: completed %llu, emitted incomplete %llu, dropped incomplete %llu, "
+          "max latency %lld us", __func__, __LINE__,
+          static_cast<unsigned long long>(stats.completed),
+          static_cast<unsigned long long>(stats.emittedIncomplete),
+          static_cast<unsigned long long>(stats.droppedIncomplete),
+          static_cast<long long>(
+          std::chrono::duration_cast<std::chrono::microseconds>(stats.maxLatency).count()));
+
+    mDataPool.release();
+    const GnssDataPool::Stats poolStats = mDataPool.getStats();
+    ALOGI("[%s, line %d] GnssData: epochs %llu, heap allocations %llu", __func__, __LINE__,
+          static_cast<unsigned long long>(poolStats.acquired),
+          static_cast<unsigned long long>(poolStats.allocated));
+
     instance.setState(off);
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 }
@@ -23,6 +23,8 @@
 #include <thread>
 #include <utils/SystemClock.h>
 
+#include "GnssDataPool.h"
+
 namespace android {
 namespace hardware {
 namespace gnss {
@@ -51,11 +53,15 @@ struct GnssMeasurementImpl : public IGnssMeasurement {
     Return<void> close() override;
 
     void callbackThread(void);
+
+    /*!
+     * \brief getDataPoolStats - provide the counters of the GnssData buffer, e.g. for debug
+     */
+    GnssDataPool::Stats getDataPoolStats() const { return mDataPool.getStats(); }
 private:
     std::thread mGnssMeasurementsCallbackThread;
-    std::condition_variable mCallbackCond;
-    std::mutex mCallbackMutex;
     std::atomic<bool> mThreadExit;
+    GnssDataPool mDataPool;
     static ::android::sp<IGnssMeasurementCallback> sGnssMeasurementsCbIface;
 };
 
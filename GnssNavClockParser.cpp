@@ -21,16 +21,15 @@
 #include "GnssNavClockParser.h"
 
 
-// Using offsets according to the protocol description of UBX-NAV-CLOCK
-enum NavClockOffsets : uint8_t {
-    iTow = 0,
-    clockBias = 4,
-    clockDrift = 8,
-    timeAccuracy = 12,
-    freqAccuracyEstimate = 16,
-};
-
-static const uint16_t blockSize = 20;
+// Using fields according to the protocol description of UBX-NAV-CLOCK
+namespace UbxNavClock {
+typedef UbxField<uint32_t, 0> iTow;
+typedef UbxField<int32_t, 4> clockBias;
+typedef UbxField<int32_t, 8> clockDrift;
+typedef UbxField<uint32_t, 12> timeAccuracy;
+typedef UbxField<uint32_t, 16, std::ratio<1, 1000>> freqAccuracyEstimate; // ps/s to ns/s
+typedef UbxSchema<20, iTow, clockBias, clockDrift, timeAccuracy, freqAccuracyEstimate> Schema;
+}
 
 GnssNavClockParser::GnssNavClockParser(const uint8_t* payload, uint16_t payloadLen) :
     mPayload(payload),
@@ -45,11 +44,11 @@ void GnssNavClockParser::parseSingleBlock()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    data.iTow = getValue<uint32_t>(&mPayload[NavClockOffsets::iTow]);
-    data.clockBias = getValue<int32_t>(&mPayload[NavClockOffsets::clockBias]);
-    data.clockDrift = getValue<int32_t>(&mPayload[NavClockOffsets::clockDrift]);
-    data.timeAccuracy = getValue<uint32_t>(&mPayload[NavClockOffsets::timeAccuracy]);
-    data.freqAccuracyEstimate = getValue<uint32_t>(&mPayload[NavClockOffsets::freqAccuracyEstimate]);
+    data.iTow = load<UbxNavClock::iTow>(mPayload);
+    data.clockBias = load<UbxNavClock::clockBias>(mPayload);
+    data.clockDrift = load<UbxNavClock::clockDrift>(mPayload);
+    data.timeAccuracy = load<UbxNavClock::timeAccuracy>(mPayload);
+    data.freqAccuracyEstimate = load<UbxNavClock::freqAccuracyEstimate>(mPayload);
 
     mValid = true;
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
@@ -59,7 +58,7 @@ void GnssNavClockParser::parseNavClockMsg()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (nullptr == mPayload || mPayloadLen != blockSize) {
+    if (nullptr == mPayload || mPayloadLen != UbxNavClock::Schema::blockSize) {
         ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
         return;
     }
@@ -71,12 +70,10 @@ void GnssNavClockParser::parseNavClockMsg()
 void GnssNavClockParser::getGnssClock(MeasurementCb::GnssClock &instance)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    const double psToNsScale = 1000.0;
-
     instance.biasNs = static_cast<int64_t>(data.clockBias);
     instance.driftNsps = static_cast<double>(data.clockDrift);
     instance.biasUncertaintyNs = static_cast<double>(data.timeAccuracy);
-    instance.driftUncertaintyNsps = scaleDown(data.freqAccuracyEstimate, psToNsScale);
+    instance.driftUncertaintyNsps = scaleUp(data.freqAccuracyEstimate, UbxNavClock::freqAccuracyEstimate::scale);
     instance.hwClockDiscontinuityCount = 0;
 
     instance.gnssClockFlags |= static_cast<uint16_t>(MeasurementCb::GnssClockFlags::HAS_BIAS);
@@ -85,6 +82,13 @@ void GnssNavClockParser::getGnssClock(MeasurementCb::GnssClock &instance)
     instance.gnssClockFlags |= static_cast<uint16_t>(MeasurementCb::GnssClockFlags::HAS_DRIFT_UNCERTAINTY);
 }
 
+uint8_t GnssNavClockParser::getEpoch(uint32_t& iTow)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    iTow = data.iTow;
+    return mValid ? ClockDone : NotReady;
+}
+
 uint8_t GnssNavClockParser::retrieveSvInfo(MeasurementCb::GnssData &gnssData)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
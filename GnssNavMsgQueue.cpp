@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssNavMsgQueue"
+#define LOG_NDEBUG 1
+
+#include <cstring>
+#include <inttypes.h>
+#include <log/log.h>
+
+#include "GnssNavMsgQueue.h"
+
+GnssNavMsgQueue& GnssNavMsgQueue::getInstance()
+{
+    static GnssNavMsgQueue instance;
+    return instance;
+}
+
+bool GnssNavMsgQueue::push(const uint8_t* payload, uint16_t len)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    if (nullptr == payload || len > mMaxPayloadSize) {
+        ALOGV("[%s, line %d] Wrong input, len = %u", __func__, __LINE__, len);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!mState) {
+            return false;
+        }
+
+        if (mSize == mCapacity) {
+            ++mDroppedCount;
+            ALOGV("[%s, line %d] Queue is full, dropped %" PRIu64, __func__, __LINE__, mDroppedCount);
+            return false;
+        }
+
+        Element& element = mElements[(mHead + mSize) % mCapacity];
+        memcpy(element.data, payload, len);
+        element.len = len;
+        ++mSize;
+    }
+
+    mCond.notify_one();
+    return true;
+}
+
+bool GnssNavMsgQueue::pop(Element& element, std::chrono::milliseconds timeout)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    std::unique_lock<std::mutex> lock(mLock);
+    mCond.wait_for(lock, timeout, [this] { return mSize > 0 || !mState; });
+
+    if (mSize == 0) {
+        return false;
+    }
+
+    const Element& front = mElements[mHead];
+    memcpy(element.data, front.data, front.len);
+    element.len = front.len;
+    mHead = (mHead + 1) % mCapacity;
+    --mSize;
+
+    return true;
+}
+
+size_t GnssNavMsgQueue::getSize()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mSize;
+}
+
+uint64_t GnssNavMsgQueue::getDroppedCount()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mDroppedCount;
+}
+
+void GnssNavMsgQueue::setState(const bool state)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mState = state;
+        if (!state) {
+            mHead = 0;
+            mSize = 0;
+        }
+    }
+
+    mCond.notify_all();
+}
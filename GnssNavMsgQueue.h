@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSNAVMSGQUEUE_H__
+#define __GNSSNAVMSGQUEUE_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "GnssRxmSfrbxParser.h"
+
+/*!
+ * \brief GnssNavMsgQueue - FIFO of raw UBX-RXM-SFRBX payloads
+ * \brief the lane is separate from the measurement queue and has its own consumer thread,
+ * \brief so subframe traffic does not delay measurement and location delivery;
+ * \brief decoding is left to the consumer, the producer only copies the payload
+ */
+class GnssNavMsgQueue
+{
+public:
+    static const uint16_t mMaxPayloadSize =
+        GnssRxmSfrbxParser::mHeaderSize + GnssRxmSfrbxParser::mMaxWordsNum * sizeof(uint32_t);
+
+    struct Element {
+        uint16_t len;
+        uint8_t data[mMaxPayloadSize];
+    };
+
+    ~GnssNavMsgQueue() {}
+
+    /*!
+     * \brief getInstance - provide an instance of the single object, create if there is no object
+     * \return reference - to the queue
+     */
+    static GnssNavMsgQueue& getInstance();
+
+    /*!
+     * \brief push - copy the payload to the end of the queue and wake up the consumer
+     * \brief works only if the queue is on, the payload is dropped if the queue is full
+     * \param payload - a pointer to the payload of UBX-RXM-SFRBX
+     * \param len - length in bytes of payload
+     * \return true if the payload was queued
+     */
+    bool push(const uint8_t* payload, uint16_t len);
+
+    /*!
+     * \brief pop - wait for the first(front) element, copy and remove it from the queue
+     * \param element - reference to the output element
+     * \param timeout - maximal time to wait
+     * \return true if an element was provided, false on timeout or if the queue is off
+     */
+    bool pop(Element& element, std::chrono::milliseconds timeout);
+
+    /*!
+     * \brief getSize - provide the number of element in the queue
+     */
+    size_t getSize();
+
+    /*!
+     * \brief getDroppedCount - number of payloads dropped because the queue was full
+     */
+    uint64_t getDroppedCount();
+
+    /*!
+     * \brief setState - turn the queue on or off
+     * \brief clean up the queue and wake up the consumer if going to turn off
+     * \param state -- true to turn on, false to turn off
+     */
+    void setState(const bool state);
+
+private:
+    GnssNavMsgQueue() {}
+    GnssNavMsgQueue(GnssNavMsgQueue const&) = delete;
+    GnssNavMsgQueue &operator=(GnssNavMsgQueue const&) = delete;
+
+    // Up to 2 subframes per second per tracked SV
+    static const size_t mCapacity = 64;
+
+    Element mElements[mCapacity];
+    size_t mHead = 0;
+    size_t mSize = 0;
+    uint64_t mDroppedCount = 0;
+    bool mState = false;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+};
+
+#endif // __GNSSNAVMSGQUEUE_H__
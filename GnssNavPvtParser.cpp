@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssHALNavPvtParser"
+#define LOG_NDEBUG 1
+
+#include <ctime>
+#include <log/log.h>
+#include "GnssNavPvtParser.h"
+
+using ::android::hardware::gnss::V1_0::GnssLocation;
+using ::android::hardware::gnss::V1_0::GnssLocationFlags;
+
+// Using offsets according to the protocol description of UBX-NAV-PVT
+enum NavPvtOffsets : uint8_t {
+    iTow = 0,
+    year = 4,
+    month = 6,
+    day = 7,
+    hour = 8,
+    minute = 9,
+    second = 10,
+    valid = 11,
+    nano = 16,
+    fixType = 20,
+    flags = 21,
+    numSv = 23,
+    lon = 24,
+    lat = 28,
+    height = 32,
+    hMsl = 36,
+    hAcc = 40,
+    vAcc = 44,
+    gSpeed = 60,
+    headMot = 64,
+    sAcc = 68,
+    headAcc = 72,
+    pDop = 76,
+};
+
+// u-blox 7 sends 84 bytes, u-blox 8 appends headVeh, magDec and magAcc
+static const uint16_t blockSizeUblox7 = 84;
+static const uint16_t blockSizeUblox8 = 92;
+
+static const uint8_t validDateMask = 0x01;
+static const uint8_t validTimeMask = 0x02;
+static const uint8_t gnssFixOkMask = 0x01;
+
+static const uint8_t fixType3D = 3;
+static const uint8_t fixTypeGnssDeadReckoning = 4;
+
+static const double degScale = 1e-7;    // lon, lat: deg * 1e-7
+static const double headScale = 1e-5;   // headMot, headAcc: deg * 1e-5
+static const double mmToMeters = 1e-3;  // height, accuracies and speed: mm or mm/s
+
+GnssNavPvtParser::GnssNavPvtParser(const uint8_t* payload, uint16_t payloadLen) :
+    mPayload(payload),
+    mPayloadLen(payloadLen)
+{
+    parseNavPvtMsg();
+    mPayload = nullptr;
+    mPayloadLen = 0;
+}
+
+void GnssNavPvtParser::parseSingleBlock()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    data.iTow = loadLE<uint32_t>(&mPayload[NavPvtOffsets::iTow]);
+    data.year = loadLE<uint16_t>(&mPayload[NavPvtOffsets::year]);
+    data.month = loadLE<uint8_t>(&mPayload[NavPvtOffsets::month]);
+    data.day = loadLE<uint8_t>(&mPayload[NavPvtOffsets::day]);
+    data.hour = loadLE<uint8_t>(&mPayload[NavPvtOffsets::hour]);
+    data.minute = loadLE<uint8_t>(&mPayload[NavPvtOffsets::minute]);
+    data.second = loadLE<uint8_t>(&mPayload[NavPvtOffsets::second]);
+    data.valid = loadLE<uint8_t>(&mPayload[NavPvtOffsets::valid]);
+    data.nano = loadLE<int32_t>(&mPayload[NavPvtOffsets::nano]);
+    data.fixType = loadLE<uint8_t>(&mPayload[NavPvtOffsets::fixType]);
+    data.flags = loadLE<uint8_t>(&mPayload[NavPvtOffsets::flags]);
+    data.numSv = loadLE<uint8_t>(&mPayload[NavPvtOffsets::numSv]);
+    data.lon = loadLE<int32_t>(&mPayload[NavPvtOffsets::lon]);
+    data.lat = loadLE<int32_t>(&mPayload[NavPvtOffsets::lat]);
+    data.height = loadLE<int32_t>(&mPayload[NavPvtOffsets::height]);
+    data.hMsl = loadLE<int32_t>(&mPayload[NavPvtOffsets::hMsl]);
+    data.hAcc = loadLE<uint32_t>(&mPayload[NavPvtOffsets::hAcc]);
+    data.vAcc = loadLE<uint32_t>(&mPayload[NavPvtOffsets::vAcc]);
+    data.gSpeed = loadLE<int32_t>(&mPayload[NavPvtOffsets::gSpeed]);
+    data.headMot = loadLE<int32_t>(&mPayload[NavPvtOffsets::headMot]);
+    data.sAcc = loadLE<uint32_t>(&mPayload[NavPvtOffsets::sAcc]);
+    data.headAcc = loadLE<uint32_t>(&mPayload[NavPvtOffsets::headAcc]);
+    data.pDop = loadLE<uint16_t>(&mPayload[NavPvtOffsets::pDop]);
+
+    mValid = true;
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssNavPvtParser::parseNavPvtMsg()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (nullptr == mPayload ||
+            (mPayloadLen != blockSizeUblox7 && mPayloadLen != blockSizeUblox8)) {
+        ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
+        return;
+    }
+
+    parseSingleBlock();
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+int64_t GnssNavPvtParser::getTimestampMs()
+{
+    struct tm t = {};
+
+    t.tm_year = data.year - 1900;
+    t.tm_mon = data.month - 1;
+    t.tm_mday = data.day;
+    t.tm_hour = data.hour;
+    t.tm_min = data.minute;
+    t.tm_sec = data.second;
+
+    // nano is a signed fraction of the second in range -1e9..1e9
+    return static_cast<int64_t>(timegm(&t)) * 1000 + data.nano / 1000000;
+}
+
+int64_t GnssNavPvtParser::getUtcTimeMs()
+{
+    const uint8_t validDateTime = validDateMask | validTimeMask;
+    if (!mValid || (data.valid & validDateTime) != validDateTime) {
+        return -1;
+    }
+
+    return getTimestampMs();
+}
+
+bool GnssNavPvtParser::getLocation(GnssLocation &location)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mValid) {
+        return false;
+    }
+
+    const uint8_t validDateTime = validDateMask | validTimeMask;
+    if (!(data.flags & gnssFixOkMask) ||
+            (data.fixType != fixType3D && data.fixType != fixTypeGnssDeadReckoning) ||
+            (data.valid & validDateTime) != validDateTime) {
+        ALOGV("[%s, line %d] No valid 3D fix, fixType %u, flags 0x%x, valid 0x%x", __func__, __LINE__,
+              data.fixType, data.flags, data.valid);
+        return false;
+    }
+
+    location.gnssLocationFlags = 0;
+    location.timestamp = getTimestampMs();
+
+    location.latitudeDegrees = scaleUp(data.lat, degScale);
+    location.longitudeDegrees = scaleUp(data.lon, degScale);
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
+
+    location.altitudeMeters = scaleUp(data.height, mmToMeters);
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_ALTITUDE);
+
+    location.speedMetersPerSec = static_cast<float>(scaleUp(data.gSpeed, mmToMeters));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED);
+
+    location.bearingDegrees = static_cast<float>(scaleUp(data.headMot, headScale));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING);
+
+    location.horizontalAccuracyMeters = static_cast<float>(scaleUp(data.hAcc, mmToMeters));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_HORIZONTAL_ACCURACY);
+
+    location.verticalAccuracyMeters = static_cast<float>(scaleUp(data.vAcc, mmToMeters));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_VERTICAL_ACCURACY);
+
+    location.speedAccuracyMetersPerSecond = static_cast<float>(scaleUp(data.sAcc, mmToMeters));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_SPEED_ACCURACY);
+
+    location.bearingAccuracyDegrees = static_cast<float>(scaleUp(data.headAcc, headScale));
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_BEARING_ACCURACY);
+
+    return true;
+}
+
+uint8_t GnssNavPvtParser::retrieveSvInfo(__attribute__((unused)) MeasurementCb::GnssData &gnssData)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    return NotReady;
+}
+
+void GnssNavPvtParser::dumpDebug()
+{
+    hexdump("/data/app/NavPvtSample", (void*)&data, sizeof(data));
+    ALOGV("[%s, line %d] iTow %u, fixType %u, numSv %u, lat %d, lon %d, hAcc %u",
+          __func__, __LINE__, data.iTow, data.fixType, data.numSv, data.lat, data.lon, data.hAcc);
+}
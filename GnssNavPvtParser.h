@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __GNSSNAVPVTPARSER_H__
+#define __GNSSNAVPVTPARSER_H__
+
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/types.h>
+#include <android/hardware/gnss/1.0/IGnssMeasurementCallback.h>
+
+#include "GnssParserCommonImpl.h"
+
+/* From u-blox 8 / u-blox M8 Receiver Description - Manual
+ * 32.17.17 UBX-NAV-PVT (0x01 0x07)
+ * 32.17.17.1 Navigation Position Velocity Time Solution
+ * Message: UBX-NAV-PVT
+ * Description: Navigation Position Velocity Time Solution
+*/
+
+class GnssNavPvtParser : public GnssParserCommonImpl {
+public:
+    /*!
+     * \brief GnssNavPvtParser
+     * \param payload - a pointer to the payload of incoming message
+     * \param payloadLen - length in bytes of payload
+     */
+    GnssNavPvtParser(const uint8_t* payload, uint16_t payloadLen);
+    ~GnssNavPvtParser() override {}
+
+    /*!
+     * \brief retrieveSvInfo - NAV-PVT carries no measurement data
+     * \param gnssData - unused
+     * \return NotReady
+     */
+    uint8_t retrieveSvInfo(MeasurementCb::GnssData &gnssData) final;
+
+    /*!
+     * \brief getLocation - fill the location with the navigation solution
+     * \brief only a valid 3D fix with resolved UTC date and time is provided
+     * \param location - reference to the location object
+     * \return true on success, otherwise false
+     */
+    bool getLocation(::android::hardware::gnss::V1_0::GnssLocation &location);
+
+    /*!
+     * \brief getUtcTimeMs - UTC time of the epoch, known before the first fix as well
+     * \return milliseconds since the epoch, -1 if date or time is not valid
+     */
+    int64_t getUtcTimeMs();
+
+    /*!
+     * \brief getAltitudeMslMeters - height above mean sea level of the solution
+     */
+    double getAltitudeMslMeters() { return scaleUp(data.hMsl, 1e-3); }
+
+    /*!
+     * \brief getPDop - position dilution of precision of the solution
+     */
+    float getPDop() { return static_cast<float>(scaleUp(data.pDop, 1e-2)); }
+
+    /*!
+     * \brief getNumSv - number of SVs used in the solution
+     */
+    uint8_t getNumSv() { return data.numSv; }
+
+    /*!
+     * \brief dumpDebug - print log in logcat, and write dump to file
+     */
+    void dumpDebug() override;
+
+protected:
+    GnssNavPvtParser() : mPayload(nullptr) {}
+
+    /*!
+     * \brief parseNavPvtMsg - collect data from input message, set validity
+     */
+    void parseNavPvtMsg();
+
+    /*!
+     * \brief parseSingleBlock - parse incoming message of type ubx-nav-pvt
+     */
+    void parseSingleBlock();
+
+    /*!
+     * \brief getTimestampMs - compute UTC time of the solution in milliseconds
+     * \return milliseconds since the epoch
+     */
+    int64_t getTimestampMs();
+
+private:
+    typedef struct NavPvt {
+        uint32_t iTow;
+        uint16_t year;
+        uint8_t month;
+        uint8_t day;
+        uint8_t hour;
+        uint8_t minute;
+        uint8_t second;
+        uint8_t valid;
+        int32_t nano;
+        uint8_t fixType;
+        uint8_t flags;
+        uint8_t numSv;
+        int32_t lon;
+        int32_t lat;
+        int32_t height;
+        int32_t hMsl;
+        uint32_t hAcc;
+        uint32_t vAcc;
+        int32_t gSpeed;
+        int32_t headMot;
+        uint32_t sAcc;
+        uint32_t headAcc;
+        uint16_t pDop;
+    } navPvt_t;
+
+    const uint8_t* mPayload;
+    navPvt_t data = {};
+    uint16_t mPayloadLen = 0;
+
+    bool mValid = false;
+};
+
+#endif //__GNSSNAVPVTPARSER_H__
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssHALNavSatParser"
+#define LOG_NDEBUG 1
+
+#include <log/log.h>
+#include "GnssNavSatParser.h"
+
+using ::android::hardware::gnss::V1_0::GnssConstellationType;
+using ::android::hardware::gnss::V1_0::GnssMax;
+using ::android::hardware::gnss::V1_0::IGnssCallback;
+
+// Both messages have an 8 bytes header followed by 12 bytes blocks, one per SV
+static const uint16_t headerSize = 8;
+static const uint16_t blockSize = 12;
+
+enum NavSatOffsets : uint8_t {
+    iTow = 0,
+    version = 4,
+    numSvs = 5,
+    // repeated block
+    gnssId = 0,
+    svId = 1,
+    cno = 2,
+    elev = 3,
+    azim = 4,
+    flags = 8,
+};
+
+enum NavSvInfoOffsets : uint8_t {
+    svInfoITow = 0,
+    numCh = 4,
+    // repeated block
+    svInfoSvId = 1,
+    svInfoFlags = 2,
+    svInfoCno = 4,
+    svInfoElev = 5,
+    svInfoAzim = 6,
+};
+
+enum NavSatGnssId : uint8_t {
+    gnssIdGps = 0,
+    gnssIdSbas = 1,
+    gnssIdGalileo = 2,
+    gnssIdBeidou = 3,
+    gnssIdImes = 4,
+    gnssIdQzss = 5,
+    gnssIdGlonass = 6,
+};
+
+static const uint32_t navSatSvUsedMask = 1u << 3;
+static const uint32_t navSatEphAvailMask = 1u << 11;
+static const uint32_t navSatAlmAvailMask = 1u << 12;
+
+static const uint8_t svInfoSvUsedMask = 1u << 0;
+static const uint8_t svInfoOrbitEphMask = 1u << 3;
+static const uint8_t svInfoOrbitAlmMask = 1u << 5;
+
+static const uint8_t glonassUnknownSlot = 255;
+static const int16_t qzssSvidOffset = 192; // android QZSS svid range is 193-200
+
+// Carrier frequencies of the signals reported for the NMEA path as well
+static const float L1BandFrequencyHz = 1575.42e6f;
+static const float B1BandFrequencyHz = 1561.098e6f;
+static const float L1GlonassBandFrequencyHz = 1602.562e6f;
+
+GnssNavSatParser::GnssNavSatParser(Format format, const uint8_t* payload, uint16_t payloadLen) :
+    mFormat(format),
+    mPayload(payload),
+    mPayloadLen(payloadLen)
+{
+    parseNavSatMsg();
+}
+
+void GnssNavSatParser::parseNavSatMsg()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (nullptr == mPayload || mPayloadLen < headerSize) {
+        ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
+        return;
+    }
+
+    if (mFormat == Format::NavSat) {
+        mITow = loadLE<uint32_t>(&mPayload[NavSatOffsets::iTow]);
+        mNumBlocks = loadLE<uint8_t>(&mPayload[NavSatOffsets::numSvs]);
+    } else {
+        mITow = loadLE<uint32_t>(&mPayload[NavSvInfoOffsets::svInfoITow]);
+        mNumBlocks = loadLE<uint8_t>(&mPayload[NavSvInfoOffsets::numCh]);
+    }
+
+    if (mPayloadLen != headerSize + blockSize * mNumBlocks) {
+        ALOGV("[%s, line %d] Payload length %u does not match %u blocks", __func__, __LINE__,
+              mPayloadLen, mNumBlocks);
+        return;
+    }
+
+    mValid = true;
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+bool GnssNavSatParser::setSvIdentity(uint8_t gnssId, uint8_t svId, IGnssCallback::GnssSvInfo &sv)
+{
+    if (mFormat == Format::NavSvInfo) {
+        // u-blox 7 uses a single numbering space for all constellations
+        if (svId >= 1 && svId <= 32) {
+            gnssId = gnssIdGps;
+        } else if (svId >= 33 && svId <= 64) {
+            // B6..B37, B1..B5 are at 159..163
+            gnssId = gnssIdBeidou;
+            svId = static_cast<uint8_t>(svId - 27);
+        } else if (svId >= 65 && svId <= 96) {
+            gnssId = gnssIdGlonass;
+            svId = static_cast<uint8_t>(svId - 64);
+        } else if (svId >= 120 && svId <= 158) {
+            gnssId = gnssIdSbas;
+        } else if (svId >= 159 && svId <= 163) {
+            gnssId = gnssIdBeidou;
+            svId = static_cast<uint8_t>(svId - 158);
+        } else if (svId >= 193 && svId <= 197) {
+            gnssId = gnssIdQzss;
+            svId = static_cast<uint8_t>(svId - qzssSvidOffset);
+        } else if (svId >= 211 && svId <= 246) {
+            gnssId = gnssIdGalileo;
+            svId = static_cast<uint8_t>(svId - 210);
+        } else if (svId == glonassUnknownSlot) {
+            gnssId = gnssIdGlonass;
+        } else {
+            return false;
+        }
+    }
+
+    sv.svid = static_cast<int16_t>(svId);
+    sv.carrierFrequencyHz = L1BandFrequencyHz;
+
+    switch (gnssId) {
+    case gnssIdGps:
+        sv.constellation = GnssConstellationType::GPS;
+        break;
+    case gnssIdSbas:
+        sv.constellation = GnssConstellationType::SBAS;
+        break;
+    case gnssIdGalileo:
+        sv.constellation = GnssConstellationType::GALILEO;
+        break;
+    case gnssIdBeidou:
+        sv.constellation = GnssConstellationType::BEIDOU;
+        sv.carrierFrequencyHz = B1BandFrequencyHz;
+        break;
+    case gnssIdQzss:
+        sv.constellation = GnssConstellationType::QZSS;
+        sv.svid = static_cast<int16_t>(svId + qzssSvidOffset);
+        break;
+    case gnssIdGlonass:
+        // Android expects the slot number or FCN + 100, neither is known here
+        if (svId == glonassUnknownSlot) {
+            return false;
+        }
+        sv.constellation = GnssConstellationType::GLONASS;
+        sv.carrierFrequencyHz = L1GlonassBandFrequencyHz;
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool GnssNavSatParser::decodeBlock(const uint8_t* block, IGnssCallback::GnssSvInfo &sv)
+{
+    uint8_t svFlag = 0;
+
+    if (mFormat == Format::NavSat) {
+        if (!setSvIdentity(loadLE<uint8_t>(&block[NavSatOffsets::gnssId]),
+                           loadLE<uint8_t>(&block[NavSatOffsets::svId]), sv)) {
+            return false;
+        }
+
+        const uint32_t flags = loadLE<uint32_t>(&block[NavSatOffsets::flags]);
+        sv.cN0Dbhz = static_cast<float>(loadLE<uint8_t>(&block[NavSatOffsets::cno]));
+        sv.elevationDegrees = static_cast<float>(loadLE<int8_t>(&block[NavSatOffsets::elev]));
+        sv.azimuthDegrees = static_cast<float>(loadLE<int16_t>(&block[NavSatOffsets::azim]));
+
+        svFlag |= (flags & navSatEphAvailMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA) : 0;
+        svFlag |= (flags & navSatAlmAvailMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA) : 0;
+        svFlag |= (flags & navSatSvUsedMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX) : 0;
+    } else {
+        if (!setSvIdentity(0, loadLE<uint8_t>(&block[NavSvInfoOffsets::svInfoSvId]), sv)) {
+            return false;
+        }
+
+        const uint8_t flags = loadLE<uint8_t>(&block[NavSvInfoOffsets::svInfoFlags]);
+        sv.cN0Dbhz = static_cast<float>(loadLE<uint8_t>(&block[NavSvInfoOffsets::svInfoCno]));
+        sv.elevationDegrees = static_cast<float>(loadLE<int8_t>(&block[NavSvInfoOffsets::svInfoElev]));
+        sv.azimuthDegrees = static_cast<float>(loadLE<int16_t>(&block[NavSvInfoOffsets::svInfoAzim]));
+
+        svFlag |= (flags & svInfoOrbitEphMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA) : 0;
+        svFlag |= (flags & svInfoOrbitAlmMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA) : 0;
+        svFlag |= (flags & svInfoSvUsedMask) ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX) : 0;
+    }
+
+    svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
+    sv.svFlag = svFlag;
+
+    return true;
+}
+
+bool GnssNavSatParser::getSvStatus(IGnssCallback::GnssSvStatus &status)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mValid) {
+        return false;
+    }
+
+    const size_t maxSvs = static_cast<size_t>(GnssMax::SVS_COUNT);
+    size_t count = 0;
+    size_t weakest = 0;
+    bool weakestKnown = false;
+
+    for (size_t i = 0; i < mNumBlocks; i++) {
+        const uint8_t* block = &mPayload[headerSize + i * blockSize];
+
+        if (count < maxSvs) {
+            if (decodeBlock(block, status.gnssSvList[count])) {
+                count++;
+            }
+            continue;
+        }
+
+        // List is full, the new SV replaces the weakest one if it is stronger
+        IGnssCallback::GnssSvInfo sv = {};
+        if (!decodeBlock(block, sv)) {
+            continue;
+        }
+
+        if (!weakestKnown) {
+            weakest = 0;
+            for (size_t j = 1; j < maxSvs; j++) {
+                if (status.gnssSvList[j].cN0Dbhz < status.gnssSvList[weakest].cN0Dbhz) {
+                    weakest = j;
+                }
+            }
+            weakestKnown = true;
+        }
+
+        if (sv.cN0Dbhz > status.gnssSvList[weakest].cN0Dbhz) {
+            status.gnssSvList[weakest] = sv;
+            weakestKnown = false;
+        }
+    }
+
+    status.numSvs = static_cast<uint32_t>(count);
+
+    return true;
+}
+
+uint8_t GnssNavSatParser::retrieveSvInfo(__attribute__((unused)) MeasurementCb::GnssData &gnssData)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    return NotReady;
+}
+
+void GnssNavSatParser::dumpDebug()
+{
+    ALOGV("[%s, line %d] iTow %u, format %u, blocks %u, valid %d",
+          __func__, __LINE__, mITow, static_cast<uint8_t>(mFormat), mNumBlocks, mValid);
+}
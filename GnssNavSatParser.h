@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __GNSSNAVSATPARSER_H__
+#define __GNSSNAVSATPARSER_H__
+
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+#include "GnssParserCommonImpl.h"
+
+/* From u-blox 8 / u-blox M8 Receiver Description - Manual
+ * 32.17.20 UBX-NAV-SAT (0x01 0x35)
+ * Message: UBX-NAV-SAT
+ * Description: Satellite Information
+ *
+ * From u-blox 7 Receiver Description
+ * 35.18.19 UBX-NAV-SVINFO (0x01 0x30)
+ * Message: UBX-NAV-SVINFO
+ * Description: Space Vehicle Information
+*/
+
+class GnssNavSatParser : public GnssParserCommonImpl {
+public:
+    enum class Format : uint8_t {
+        NavSat,    // UBX-NAV-SAT, u-blox 8
+        NavSvInfo  // UBX-NAV-SVINFO, u-blox 7
+    };
+
+    /*!
+     * \brief GnssNavSatParser - validate the message, payload is decoded by getSvStatus
+     * \param format - message layout
+     * \param payload - a pointer to the payload of incoming message, must stay valid until getSvStatus
+     * \param payloadLen - length in bytes of payload
+     */
+    GnssNavSatParser(Format format, const uint8_t* payload, uint16_t payloadLen);
+    ~GnssNavSatParser() override {}
+
+    /*!
+     * \brief retrieveSvInfo - NAV-SAT carries no measurement data
+     * \param gnssData - unused
+     * \return NotReady
+     */
+    uint8_t retrieveSvInfo(MeasurementCb::GnssData &gnssData) final;
+
+    /*!
+     * \brief getSvStatus - decode the satellites straight into the callback structure
+     * \brief if more than GnssMax::SVS_COUNT SVs are reported the weakest by C/N0 are dropped,
+     * \brief GLONASS SVs with unknown slot number are skipped
+     * \param status - output structure
+     * \return true on success, otherwise false
+     */
+    bool getSvStatus(::android::hardware::gnss::V1_0::IGnssCallback::GnssSvStatus &status);
+
+    /*!
+     * \brief dumpDebug - print log in logcat
+     */
+    void dumpDebug() override;
+
+protected:
+    GnssNavSatParser() : mPayload(nullptr) {}
+
+    /*!
+     * \brief parseNavSatMsg - check the header and the length of incoming message, set validity
+     */
+    void parseNavSatMsg();
+
+    /*!
+     * \brief setSvIdentity - map u-blox gnssId/svId to android constellation and svid
+     * \param gnssId - u-blox GNSS identifier (NAV-SAT only)
+     * \param svId - u-blox satellite identifier
+     * \param sv - output SV record
+     * \return true if the SV is reportable, otherwise false
+     */
+    bool setSvIdentity(uint8_t gnssId, uint8_t svId,
+                       ::android::hardware::gnss::V1_0::IGnssCallback::GnssSvInfo &sv);
+
+    /*!
+     * \brief decodeBlock - decode a single repeated block
+     * \param block - a pointer to the block
+     * \param sv - output SV record
+     * \return true if the SV is reportable, otherwise false
+     */
+    bool decodeBlock(const uint8_t* block,
+                     ::android::hardware::gnss::V1_0::IGnssCallback::GnssSvInfo &sv);
+
+private:
+    Format mFormat = Format::NavSat;
+    const uint8_t* mPayload;
+    uint16_t mPayloadLen = 0;
+    uint32_t mITow = 0;
+    uint8_t mNumBlocks = 0;
+
+    bool mValid = false;
+};
+
+#endif //__GNSSNAVSATPARSER_H__
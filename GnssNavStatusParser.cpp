@@ -20,15 +20,15 @@
 #include <log/log.h>
 #include "GnssNavStatusParser.h"
 
-static const size_t blockSize = 16;
 static const int64_t msToNs = 1000000;
 static const uint16_t fullBiasFlag = static_cast<uint16_t>(MeasurementCb::GnssClockFlags::HAS_FULL_BIAS);
 
-// Using offsets according to the protocol description of UBX-NAV-STATUS
-enum NavStatusOffsets : uint8_t {
-    iTowOffset = 0,
-    msssOffset = 12,
-};
+// Using fields according to the protocol description of UBX-NAV-STATUS
+namespace UbxNavStatus {
+typedef UbxField<uint32_t, 0> iTow;
+typedef UbxField<uint32_t, 12> msss;
+typedef UbxSchema<16, iTow, msss> Schema;
+}
 
 GnssNavStatusParser::GnssNavStatusParser(const uint8_t* payload, uint16_t payloadLen) :
     mPayload(payload),
@@ -43,8 +43,8 @@ void GnssNavStatusParser::parseSingleBlock()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    data.iTow = getValue<uint32_t>(&mPayload[NavStatusOffsets::iTowOffset]);
-    data.msss = getValue<uint32_t>(&mPayload[NavStatusOffsets::msssOffset]);
+    data.iTow = load<UbxNavStatus::iTow>(mPayload);
+    data.msss = load<UbxNavStatus::msss>(mPayload);
 
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
@@ -53,7 +53,7 @@ void GnssNavStatusParser::parseNavStatusMsg()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (nullptr == mPayload || mPayloadLen != blockSize) {
+    if (nullptr == mPayload || mPayloadLen != UbxNavStatus::Schema::blockSize) {
         ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
         return;
     }
@@ -80,6 +80,13 @@ static bool hasFlagFullBias(const uint16_t flags)
     return (fullBiasFlag == (fullBiasFlag & flags));
 }
 
+uint8_t GnssNavStatusParser::getEpoch(uint32_t& iTow)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    iTow = data.iTow;
+    return mValid ? StatusDone : NotReady;
+}
+
 uint8_t GnssNavStatusParser::retrieveSvInfo(MeasurementCb::GnssData &gnssData)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
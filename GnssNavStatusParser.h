@@ -49,6 +49,13 @@ public:
      */
     uint8_t retrieveSvInfo(MeasurementCb::GnssData &gnssData) final;
 
+    /*!
+     * \brief getEpoch - provide iTOW of the message as its epoch
+     * \param iTow - GPS time of week in ms
+     * \return StatusDone if the object is valid, otherwise NotReady
+     */
+    uint8_t getEpoch(uint32_t& iTow) final;
+
     /*!
      * \brief dumpDebug - print log in logcat, and write dump to file
      */
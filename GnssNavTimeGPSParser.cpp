@@ -20,21 +20,21 @@
 #include <log/log.h>
 #include "GnssNavTimeGPSParser.h"
 
-static const size_t blockSize = 16;
 static const int64_t fullWeekMs = 604800000; // ms in week
 static const int64_t defaultRtcTime = 1;
 
 static bool isValidFlag(const uint8_t flags, const uint8_t expFlag);
 
-// Using offsets according to the protocol description of UBX-NAV-TIMEGPS
-enum NavTimeGpsOffsets : uint8_t {
-    iTowOffset = 0,
-    fTowOffset = 4,
-    weekOffset = 8,
-    leapSOffset = 10,
-    validOffset = 11,
-    tAccOffset = 12,
-};
+// Using fields according to the protocol description of UBX-NAV-TIMEGPS
+namespace UbxNavTimeGps {
+typedef UbxField<uint32_t, 0> iTow;
+typedef UbxField<int32_t, 4> fTow;
+typedef UbxField<int16_t, 8> week;
+typedef UbxField<int8_t, 10> leapS;
+typedef UbxField<uint8_t, 11> valid;
+typedef UbxField<uint32_t, 12> tAcc;
+typedef UbxSchema<16, iTow, fTow, week, leapS, valid, tAcc> Schema;
+}
 
 GnssNavTimeGPSParser::GnssNavTimeGPSParser(const uint8_t* payload, uint16_t payloadLen) :
     mPayload(payload),
@@ -49,12 +49,12 @@ void GnssNavTimeGPSParser::parseSingleBlock()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    data.iTow = getValue<uint32_t>(&mPayload[NavTimeGpsOffsets::iTowOffset]);
-    data.fTow = getValue<int32_t>(&mPayload[NavTimeGpsOffsets::fTowOffset]);
-    data.week = getValue<int16_t>(&mPayload[NavTimeGpsOffsets::weekOffset]);
-    data.leapS = static_cast<int8_t>(mPayload[NavTimeGpsOffsets::leapSOffset]);
-    data.valid = mPayload[NavTimeGpsOffsets::validOffset];
-    data.tAcc = getValue<uint32_t>(&mPayload[NavTimeGpsOffsets::tAccOffset]);
+    data.iTow = load<UbxNavTimeGps::iTow>(mPayload);
+    data.fTow = load<UbxNavTimeGps::fTow>(mPayload);
+    data.week = load<UbxNavTimeGps::week>(mPayload);
+    data.leapS = load<UbxNavTimeGps::leapS>(mPayload);
+    data.valid = load<UbxNavTimeGps::valid>(mPayload);
+    data.tAcc = load<UbxNavTimeGps::tAcc>(mPayload);
 
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
@@ -63,7 +63,7 @@ void GnssNavTimeGPSParser::parseNavTimeGPSMsg()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (nullptr == mPayload || mPayloadLen != blockSize) {
+    if (nullptr == mPayload || mPayloadLen != UbxNavTimeGps::Schema::blockSize) {
         ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
         return;
     }
@@ -91,6 +91,13 @@ bool GnssNavTimeGPSParser::setTimeNano()
     return true;
 }
 
+uint8_t GnssNavTimeGPSParser::getEpoch(uint32_t& iTow)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    iTow = data.iTow;
+    return mValid ? GPSTimeDone : NotReady;
+}
+
 uint8_t GnssNavTimeGPSParser::retrieveSvInfo(MeasurementCb::GnssData &gnssData)
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
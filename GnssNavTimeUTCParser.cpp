@@ -21,25 +21,26 @@
 #include <ctime>
 #include "GnssNavTimeUTCParser.h"
 
-static const uint16_t blockSize = 20;
 static const int xxCentury = 1900;
 static const int january = 1;
 static const int millenium = 100;  //xxCentury + millenium corresponds to 2000 year in tm.tm_year value range
 static const int64_t secondToNanoMultiplier = 1000 * 1000 * 1000;
 
-// Using offsets according to the protocol description of UBX-NAV-TIMEUTC
-enum NavTimeUTCOffsets : uint8_t {
-    iTow = 0,
-    timeAccuracy = 4,
-    nanoSecondFraction = 8,
-    year = 12,
-    month = 14,
-    day = 15,
-    hour = 16,
-    minute = 17,
-    second = 18,
-    flags = 19,
-};
+// Using fields according to the protocol description of UBX-NAV-TIMEUTC
+namespace UbxNavTimeUtc {
+typedef UbxField<uint32_t, 0> iTow;
+typedef UbxField<uint32_t, 4> timeAccuracy;
+typedef UbxField<int32_t, 8> nanoSecondFraction;
+typedef UbxField<uint16_t, 12> year;
+typedef UbxField<uint8_t, 14> month;
+typedef UbxField<uint8_t, 15> day;
+typedef UbxField<uint8_t, 16> hour;
+typedef UbxField<uint8_t, 17> minute;
+typedef UbxField<uint8_t, 18> second;
+typedef UbxField<uint8_t, 19> flags;
+typedef UbxSchema<20, iTow, timeAccuracy, nanoSecondFraction, year, month, day, hour, minute, second,
+                  flags> Schema;
+}
 
 GnssNavTimeUTCParser::GnssNavTimeUTCParser(const uint8_t* payload, uint16_t payloadLen) :
     mPayload(payload),
@@ -53,16 +54,16 @@ GnssNavTimeUTCParser::GnssNavTimeUTCParser(const uint8_t* payload, uint16_t payl
 void GnssNavTimeUTCParser::parseSingleBlock()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    data.iTow = getValue<uint32_t>(&mPayload[NavTimeUTCOffsets::iTow]);
-    data.timeAccuracy = getValue<uint32_t>(&mPayload[NavTimeUTCOffsets::timeAccuracy]);
-    data.nanoSecondFraction = getValue<int32_t>(&mPayload[NavTimeUTCOffsets::nanoSecondFraction]);
-    data.year = getValue<uint16_t>(&mPayload[NavTimeUTCOffsets::year]);
-    data.month = mPayload[NavTimeUTCOffsets::month];
-    data.day = mPayload[NavTimeUTCOffsets::day];
-    data.hour = mPayload[NavTimeUTCOffsets::hour];
-    data.minute = mPayload[NavTimeUTCOffsets::minute];
-    data.second = mPayload[NavTimeUTCOffsets::second];
-    data.flags = mPayload[NavTimeUTCOffsets::flags];
+    data.iTow = load<UbxNavTimeUtc::iTow>(mPayload);
+    data.timeAccuracy = load<UbxNavTimeUtc::timeAccuracy>(mPayload);
+    data.nanoSecondFraction = load<UbxNavTimeUtc::nanoSecondFraction>(mPayload);
+    data.year = load<UbxNavTimeUtc::year>(mPayload);
+    data.month = load<UbxNavTimeUtc::month>(mPayload);
+    data.day = load<UbxNavTimeUtc::day>(mPayload);
+    data.hour = load<UbxNavTimeUtc::hour>(mPayload);
+    data.minute = load<UbxNavTimeUtc::minute>(mPayload);
+    data.second = load<UbxNavTimeUtc::second>(mPayload);
+    data.flags = load<UbxNavTimeUtc::flags>(mPayload);
 
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
@@ -71,7 +72,7 @@ void GnssNavTimeUTCParser::parseNavTimeUTCMsg()
 {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (nullptr == mPayload || mPayloadLen != blockSize) {
+    if (nullptr == mPayload || mPayloadLen != UbxNavTimeUtc::Schema::blockSize) {
         ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
         return;
     }
@@ -57,7 +57,7 @@ public:
      */
     void dumpDebug() override;
 
-private:
+protected:
     typedef struct SingleBlock {
         uint32_t iTow;
         uint32_t timeAccuracy;
@@ -79,7 +79,6 @@ private:
 
     bool mValid = false;
 
-protected:
     GnssNavTimeUTCParser(){}
 
     /*!
@@ -16,9 +16,13 @@
 
 #define LOG_TAG "GnssRenesasHAL_GnssNavigationMessageInterface"
 
+#include <inttypes.h>
 #include <log/log.h>
 
 #include "GnssNavigationMessage.h"
+#include "GnssNavMsgQueue.h"
+#include "GnssRxmSfrbxParser.h"
+#include "GnssThreadPolicy.h"
 
 namespace android {
 namespace hardware {
@@ -26,20 +30,89 @@ namespace gnss {
 namespace V1_0 {
 namespace renesas {
 
-GnssNavigationMessage::GnssNavigationMessage() {}
+static const std::chrono::milliseconds popTimeout{1000};
+
+GnssNavigationMessage::GnssNavigationMessage(const sp<GnssHwIface>& hwIface) :
+    mHwIface(hwIface),
+    mThreadExit(false)
+{}
 
 // Methods from ::android::hardware::gnss::V1_0::IGnssNavigationMessage follow.
 Return<GnssNavigationMessage::GnssNavigationMessageStatus> GnssNavigationMessage::setCallback(
-        const sp<IGnssNavigationMessageCallback>&)  {
-    ALOGE("%s: Not implemented", __func__);
-    return GnssNavigationMessageStatus::ERROR_GENERIC;
+        const sp<IGnssNavigationMessageCallback>& callback)  {
+    if (mCallback != nullptr) {
+        ALOGE("%s: GnssNavigationMessage already init", __func__);
+        return GnssNavigationMessageStatus::ERROR_ALREADY_INIT;
+    }
+
+    if (callback == nullptr || mHwIface == nullptr) {
+        ALOGE("%s: invalid callback or HW interface", __func__);
+        return GnssNavigationMessageStatus::ERROR_GENERIC;
+    }
+
+    if (!mHwIface->SetNavigationMessageEnabled(true)) {
+        ALOGE("%s: navigation messages are not supported by the receiver", __func__);
+        return GnssNavigationMessageStatus::ERROR_GENERIC;
+    }
+
+    mCallback = callback;
+    GnssNavMsgQueue::getInstance().setState(true);
+
+    mThreadExit = false;
+    if (!mCallbackThread.joinable()) {
+        mCallbackThread = std::thread(&GnssNavigationMessage::callbackThread, this);
+    }
+
+    ALOGD("%s: GnssNavigationMessage initialized", __func__);
+    return GnssNavigationMessageStatus::SUCCESS;
 }
 
 Return<void> GnssNavigationMessage::close()  {
-    ALOGE("%s: Not implemented", __func__);
+    if (mCallback == nullptr) {
+        ALOGD("%s: called before setCallback", __func__);
+        return Void();
+    }
+
+    mHwIface->SetNavigationMessageEnabled(false);
+
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    mThreadExit = true;
+    queue.setState(false); // wakes up the callback thread
+    if (mCallbackThread.joinable()) {
+        mCallbackThread.join();
+    }
+
+    ALOGD("%s: GnssNavigationMessage closed, dropped %" PRIu64, __func__, queue.getDroppedCount());
+    mCallback = nullptr;
     return Void();
 }
 
+void GnssNavigationMessage::callbackThread(void)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Callback, "gnss_navmsg_cb");
+
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    GnssNavMsgQueue::Element element;
+    IGnssNavigationMessageCallback::GnssNavigationMessage message;
+
+    while (!mThreadExit) {
+        if (!queue.pop(element, popTimeout)) {
+            continue;
+        }
+
+        GnssRxmSfrbxParser parser(element.data, element.len);
+        if (parser.getNavigationMessage(message)) {
+            auto ret = mCallback->gnssNavigationMessageCb(message);
+            if (!ret.isOk()) {
+                ALOGE("%s: Unable to invoke callback", __func__);
+            }
+        }
+    }
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
 }  // namespace renesas
 }  // namespace V1_0
 }  // namespace gnss
@@ -19,6 +19,10 @@
 
 #include <android/hardware/gnss/1.0/IGnssNavigationMessage.h>
 #include <hidl/Status.h>
+#include <atomic>
+#include <thread>
+
+#include "GnssHw.h"
 
 namespace android {
 namespace hardware {
@@ -40,7 +44,7 @@ using ::android::sp;
  * implementation of the GNSS HAL.
  */
 struct GnssNavigationMessage : public IGnssNavigationMessage {
-    GnssNavigationMessage();
+    GnssNavigationMessage(const sp<GnssHwIface>& hwIface);
 
     /*
      * Methods from ::android::hardware::gnss::V1_0::IGnssNavigationMessage follow.
@@ -49,6 +53,13 @@ struct GnssNavigationMessage : public IGnssNavigationMessage {
     Return<GnssNavigationMessageStatus> setCallback(
         const sp<IGnssNavigationMessageCallback>& callback) override;
     Return<void> close() override;
+
+    void callbackThread(void);
+private:
+    sp<GnssHwIface> mHwIface;
+    std::thread mCallbackThread;
+    std::atomic<bool> mThreadExit;
+    sp<IGnssNavigationMessageCallback> mCallback;
 };
 
 }  // namespace renesas
@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssRenesasNmeaGenerator"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+#include <log/log.h>
+
+#include "GnssNmeaGenerator.h"
+
+const GnssNmeaGenerator::Talker GnssNmeaGenerator::mTalkers[GnssNmeaGenerator::mSystemsCount] = {
+    {"GP", 1}, // GPS, SBAS and QZSS
+    {"GL", 2},
+    {"GA", 3},
+    {"GB", 4},
+};
+
+static const double msToKnots = 3.6 / 1.852;
+static const int64_t minutesScale = 100000; // minutes are printed with 5 decimals
+
+GnssNmeaGenerator::GnssNmeaGenerator(GnssNmeaPassthrough& passthrough) :
+    mPassthrough(passthrough)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    mSentence[0] = '\0';
+}
+
+uint8_t GnssNmeaGenerator::Checksum(const char* sentence)
+{
+    uint8_t crc = 0;
+
+    for (const char* p = sentence + 1; *p != '\0' && *p != '*'; p++) {
+        crc ^= static_cast<uint8_t>(*p);
+    }
+
+    return crc;
+}
+
+int GnssNmeaGenerator::GetSystem(GnssConstellationType constellation)
+{
+    switch (constellation) {
+    case GnssConstellationType::GPS:
+    case GnssConstellationType::SBAS:
+    case GnssConstellationType::QZSS:
+        return 0;
+    case GnssConstellationType::GLONASS:
+        return 1;
+    case GnssConstellationType::GALILEO:
+        return 2;
+    case GnssConstellationType::BEIDOU:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+int GnssNmeaGenerator::GetNmeaSvid(const IGnssCallback::GnssSvInfo& sv)
+{
+    // u-blox NMEA 4.1 numbering, see u-blox 8 Receiver Description, Satellite Numbering
+    switch (sv.constellation) {
+    case GnssConstellationType::SBAS:
+        return sv.svid - 87;  // 120-151 -> 33-64
+    case GnssConstellationType::GLONASS:
+        return (sv.svid >= 1 && sv.svid <= 32) ? sv.svid + 64 : 0; // slot 1-32 -> 65-96
+    default:
+        return sv.svid;
+    }
+}
+
+void GnssNmeaGenerator::Begin(const char* talker, const char* formatter)
+{
+    mLen = 0;
+    Append("$%s%s", talker, formatter);
+}
+
+void GnssNmeaGenerator::Append(const char* format, ...)
+{
+    if (mLen >= mSentenceSize) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(mSentence + mLen, mSentenceSize - mLen, format, args);
+    va_end(args);
+
+    if (written > 0) {
+        mLen = std::min(mLen + static_cast<size_t>(written), mSentenceSize);
+    }
+}
+
+void GnssNmeaGenerator::AppendLatLon(double degrees, int degreeDigits, char positive, char negative)
+{
+    // Rounded in integer minutes * 1e5, so 59.999999' never prints as 60.00000'
+    const int64_t total = llround(std::fabs(degrees) * 60.0 * minutesScale);
+    const int64_t deg = total / (60 * minutesScale);
+    const int64_t min = total % (60 * minutesScale);
+
+    Append(",%0*" PRId64 "%02" PRId64 ".%05" PRId64 ",%c", degreeDigits, deg,
+           min / minutesScale, min % minutesScale, degrees < 0 ? negative : positive);
+}
+
+size_t GnssNmeaGenerator::Finish()
+{
+    if (mLen + sizeof("*XX") > mSentenceSize) {
+        ALOGW("[%s, line %d] Sentence truncated", __func__, __LINE__);
+        mLen = mSentenceSize - sizeof("*XX");
+        mSentence[mLen] = '\0';
+    }
+
+    Append("*%02X", Checksum(mSentence));
+    return mLen;
+}
+
+size_t GnssNmeaGenerator::FormatRMC(const GnssLocation& location)
+{
+    const time_t seconds = static_cast<time_t>(location.timestamp / 1000);
+    const int centiseconds = static_cast<int>((location.timestamp % 1000) / 10);
+    struct tm t = {};
+    gmtime_r(&seconds, &t);
+
+    Begin("GN", "RMC");
+    Append(",%02d%02d%02d.%02d,A", t.tm_hour, t.tm_min, t.tm_sec, centiseconds);
+    AppendLatLon(location.latitudeDegrees, 2, 'N', 'S');
+    AppendLatLon(location.longitudeDegrees, 3, 'E', 'W');
+
+    if (location.gnssLocationFlags & GnssLocationFlags::HAS_SPEED) {
+        Append(",%.3f", location.speedMetersPerSec * msToKnots);
+    } else {
+        Append(",");
+    }
+
+    if (location.gnssLocationFlags & GnssLocationFlags::HAS_BEARING) {
+        Append(",%.2f", location.bearingDegrees);
+    } else {
+        Append(",");
+    }
+
+    // date, magnetic variation, mode indicator A = autonomous, navigational status V = not provided
+    Append(",%02d%02d%02d,,,A,V", t.tm_mday, t.tm_mon + 1, t.tm_year % 100);
+
+    return Finish();
+}
+
+size_t GnssNmeaGenerator::FormatVoidRMC(int64_t utcMs)
+{
+    Begin("GN", "RMC");
+
+    if (utcMs >= 0) {
+        const time_t seconds = static_cast<time_t>(utcMs / 1000);
+        const int centiseconds = static_cast<int>((utcMs % 1000) / 10);
+        struct tm t = {};
+        gmtime_r(&seconds, &t);
+
+        Append(",%02d%02d%02d.%02d,V,,,,,,,%02d%02d%02d", t.tm_hour, t.tm_min, t.tm_sec, centiseconds,
+               t.tm_mday, t.tm_mon + 1, t.tm_year % 100);
+    } else {
+        Append(",,V,,,,,,,");
+    }
+
+    // magnetic variation, mode indicator N = data not valid, navigational status V
+    Append(",,,N,V");
+
+    return Finish();
+}
+
+size_t GnssNmeaGenerator::FormatGGA(const GnssLocation& location, double altitudeMslMeters, uint8_t numSv)
+{
+    const time_t seconds = static_cast<time_t>(location.timestamp / 1000);
+    const int centiseconds = static_cast<int>((location.timestamp % 1000) / 10);
+    struct tm t = {};
+    gmtime_r(&seconds, &t);
+
+    Begin("GN", "GGA");
+    Append(",%02d%02d%02d.%02d", t.tm_hour, t.tm_min, t.tm_sec, centiseconds);
+    AppendLatLon(location.latitudeDegrees, 2, 'N', 'S');
+    AppendLatLon(location.longitudeDegrees, 3, 'E', 'W');
+
+    // quality 1 = autonomous GNSS fix, HDOP is not provided by NAV-PVT
+    Append(",1,%02u,", numSv);
+
+    if (location.gnssLocationFlags & GnssLocationFlags::HAS_ALTITUDE) {
+        Append(",%.1f,M,%.1f,M,,", altitudeMslMeters, location.altitudeMeters - altitudeMslMeters);
+    } else {
+        Append(",%.1f,M,,M,,", altitudeMslMeters);
+    }
+
+    return Finish();
+}
+
+size_t GnssNmeaGenerator::FormatGSA(const IGnssCallback::GnssSvStatus& status, size_t system)
+{
+    const uint8_t usedInFix = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
+    size_t used = 0;
+
+    Begin("GN", "GSA");
+    Append(",A,%d", mHasFix ? 3 : 1);
+
+    for (uint32_t i = 0; i < status.numSvs && used < mGsaSvFields; i++) {
+        const IGnssCallback::GnssSvInfo& sv = status.gnssSvList[i];
+        if (!(sv.svFlag & usedInFix) || GetSystem(sv.constellation) != static_cast<int>(system)) {
+            continue;
+        }
+
+        const int svid = GetNmeaSvid(sv);
+        if (svid > 0) {
+            Append(",%02d", svid);
+            used++;
+        }
+    }
+
+    if (used == 0) {
+        return 0;
+    }
+
+    for (size_t i = used; i < mGsaSvFields; i++) {
+        Append(",");
+    }
+
+    if (mHasFix) {
+        Append(",%.2f,,,%u", mPDop, mTalkers[system].systemId);
+    } else {
+        Append(",,,,%u", mTalkers[system].systemId);
+    }
+
+    return Finish();
+}
+
+size_t GnssNmeaGenerator::SelectGSV(const IGnssCallback::GnssSvStatus& status, size_t system)
+{
+    mGroupCount = 0;
+
+    for (uint32_t i = 0; i < status.numSvs && i < static_cast<uint32_t>(GnssMax::SVS_COUNT); i++) {
+        const IGnssCallback::GnssSvInfo& sv = status.gnssSvList[i];
+        if (GetSystem(sv.constellation) == static_cast<int>(system) && GetNmeaSvid(sv) > 0) {
+            mGroup[mGroupCount++] = static_cast<uint8_t>(i);
+        }
+    }
+
+    return (mGroupCount + mGsvSvPerSentence - 1) / mGsvSvPerSentence;
+}
+
+size_t GnssNmeaGenerator::FormatGSV(const IGnssCallback::GnssSvStatus& status, size_t system, size_t sentence)
+{
+    const size_t sentences = (mGroupCount + mGsvSvPerSentence - 1) / mGsvSvPerSentence;
+    const size_t first = sentence * mGsvSvPerSentence;
+    const size_t last = std::min(first + mGsvSvPerSentence, mGroupCount);
+
+    Begin(mTalkers[system].talker, "GSV");
+    Append(",%zu,%zu,%02zu", sentences, sentence + 1, mGroupCount);
+
+    for (size_t i = first; i < last; i++) {
+        const IGnssCallback::GnssSvInfo& sv = status.gnssSvList[mGroup[i]];
+        Append(",%02d,%02d,%03d,", GetNmeaSvid(sv), static_cast<int>(lroundf(sv.elevationDegrees)),
+               static_cast<int>(lroundf(sv.azimuthDegrees)));
+        if (sv.cN0Dbhz > 0.f) {
+            Append("%02d", static_cast<int>(lroundf(sv.cN0Dbhz)));
+        }
+    }
+
+    return Finish();
+}
+
+void GnssNmeaGenerator::Send(int64_t timestampMs)
+{
+    mPassthrough.Put(mSentence, timestampMs);
+}
+
+void GnssNmeaGenerator::PutFix(const GnssLocation& location, double altitudeMslMeters, float pDop,
+                               uint8_t numSv, int64_t timestampMs)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    mHasFix = true;
+    mPDop = pDop;
+
+    if (!mPassthrough.HasClient()) {
+        return;
+    }
+
+    if (mPassthrough.IsTypeAllowed("$GNRMC")) {
+        FormatRMC(location);
+        Send(timestampMs);
+    }
+
+    if (mPassthrough.IsTypeAllowed("$GNGGA")) {
+        FormatGGA(location, altitudeMslMeters, numSv);
+        Send(timestampMs);
+    }
+}
+
+void GnssNmeaGenerator::ClearFix()
+{
+    mHasFix = false;
+    mPDop = 0.f;
+}
+
+void GnssNmeaGenerator::PutNoFix(int64_t utcMs, int64_t timestampMs)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    ClearFix();
+
+    if (!mPassthrough.HasClient() || !mPassthrough.IsTypeAllowed("$GNRMC")) {
+        return;
+    }
+
+    FormatVoidRMC(utcMs);
+    Send(timestampMs);
+}
+
+void GnssNmeaGenerator::PutSvStatus(const IGnssCallback::GnssSvStatus& status, int64_t timestampMs)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mPassthrough.HasClient()) {
+        return;
+    }
+
+    if (mPassthrough.IsTypeAllowed("$GNGSA")) {
+        for (size_t system = 0; system < mSystemsCount; system++) {
+            if (FormatGSA(status, system) > 0) {
+                Send(timestampMs);
+            }
+        }
+    }
+
+    if (mPassthrough.IsTypeAllowed("$GPGSV")) {
+        for (size_t system = 0; system < mSystemsCount; system++) {
+            const size_t sentences = SelectGSV(status, system);
+            for (size_t sentence = 0; sentence < sentences; sentence++) {
+                FormatGSV(status, system, sentence);
+                Send(timestampMs);
+            }
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __GNSSNMEAGENERATOR_H__
+#define __GNSSNMEAGENERATOR_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+#include "GnssNmeaPassthrough.h"
+
+using namespace android::hardware::gnss::V1_0;
+
+/*!
+ * \brief GnssNmeaGenerator - synthesises NMEA 4.1 sentences from decoded binary messages
+ * \brief used when the receiver does not output NMEA, sentences are formatted
+ * \brief into a preallocated buffer and handed to the passthrough only if there is a client
+ */
+class GnssNmeaGenerator
+{
+public:
+    /*!
+     * \brief GnssNmeaGenerator - constructor
+     * \param passthrough - delivery path of the generated sentences
+     */
+    explicit GnssNmeaGenerator(GnssNmeaPassthrough& passthrough);
+    ~GnssNmeaGenerator() {}
+
+    /*!
+     * \brief PutFix - generate RMC and GGA for the navigation solution
+     * \param location - valid 3D fix
+     * \param altitudeMslMeters - altitude above mean sea level
+     * \param pDop - position dilution of precision, used for the following GSA
+     * \param numSv - number of SVs used in the fix
+     * \param timestampMs - UTC time of reception in milliseconds
+     */
+    void PutFix(const GnssLocation& location, double altitudeMslMeters, float pDop,
+                uint8_t numSv, int64_t timestampMs);
+
+    /*!
+     * \brief ClearFix - the receiver has no fix, following GSA reports no fix
+     */
+    void ClearFix();
+
+    /*!
+     * \brief PutNoFix - the epoch has no fix, generate a void RMC so the stream never stalls
+     * \param utcMs - UTC time of the epoch in milliseconds, -1 if not known yet
+     * \param timestampMs - UTC time of reception in milliseconds
+     */
+    void PutNoFix(int64_t utcMs, int64_t timestampMs);
+
+    /*!
+     * \brief PutSvStatus - generate GSA and GSV for the satellites
+     * \param status - satellites of the epoch
+     * \param timestampMs - UTC time of reception in milliseconds
+     */
+    void PutSvStatus(const IGnssCallback::GnssSvStatus& status, int64_t timestampMs);
+
+    /*!
+     * \brief FormatRMC - format RMC sentence into the internal buffer
+     * \return length of the sentence
+     */
+    size_t FormatRMC(const GnssLocation& location);
+
+    /*!
+     * \brief FormatVoidRMC - format RMC sentence with status V into the internal buffer
+     * \param utcMs - UTC time of the epoch in milliseconds, -1 leaves time and date empty
+     * \return length of the sentence
+     */
+    size_t FormatVoidRMC(int64_t utcMs);
+
+    /*!
+     * \brief FormatGGA - format GGA sentence into the internal buffer
+     * \return length of the sentence
+     */
+    size_t FormatGGA(const GnssLocation& location, double altitudeMslMeters, uint8_t numSv);
+
+    /*!
+     * \brief FormatGSA - format GSA sentence of one GNSS system into the internal buffer
+     * \param status - satellites of the epoch
+     * \param system - talker index, see mTalkers
+     * \return length of the sentence, 0 if no SV of the system is used in fix
+     */
+    size_t FormatGSA(const IGnssCallback::GnssSvStatus& status, size_t system);
+
+    /*!
+     * \brief FormatGSV - format one GSV sentence of the group selected by SelectGSV
+     * \param status - satellites of the epoch
+     * \param system - talker index, see mTalkers
+     * \param sentence - zero based index of the sentence in the group
+     * \return length of the sentence
+     */
+    size_t FormatGSV(const IGnssCallback::GnssSvStatus& status, size_t system, size_t sentence);
+
+    /*!
+     * \brief SelectGSV - collect SVs of one GNSS system for FormatGSV
+     * \return number of GSV sentences of the group
+     */
+    size_t SelectGSV(const IGnssCallback::GnssSvStatus& status, size_t system);
+
+    const char* GetSentence() const { return mSentence; }
+
+    /*!
+     * \brief Checksum - XOR of all characters between '$' and '*'
+     * \param sentence - sentence starting with '$'
+     * \return checksum value
+     */
+    static uint8_t Checksum(const char* sentence);
+
+    static const size_t mSystemsCount = 4;
+
+private:
+    static constexpr size_t mSentenceSize = 128;
+    static constexpr size_t mGsaSvFields = 12;
+    static constexpr size_t mGsvSvPerSentence = 4;
+
+    struct Talker {
+        char    talker[3];
+        uint8_t systemId; // NMEA 4.1 GNSS System ID
+    };
+    static const Talker mTalkers[mSystemsCount];
+
+    static int GetSystem(GnssConstellationType constellation);
+    static int GetNmeaSvid(const IGnssCallback::GnssSvInfo& sv);
+
+    void Begin(const char* talker, const char* formatter);
+    void Append(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void AppendLatLon(double degrees, int degreeDigits, char positive, char negative);
+    size_t Finish();
+    void Send(int64_t timestampMs);
+
+    GnssNmeaPassthrough& mPassthrough;
+
+    char   mSentence[mSentenceSize];
+    size_t mLen = 0;
+
+    uint8_t mGroup[static_cast<size_t>(GnssMax::SVS_COUNT)];
+    size_t  mGroupCount = 0;
+
+    bool  mHasFix = false;
+    float mPDop = 0.f;
+};
+
+#endif // __GNSSNMEAGENERATOR_H__
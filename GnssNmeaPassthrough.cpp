@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasNmea"
+#define LOG_NDEBUG 1
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <log/log.h>
+#include <cutils/properties.h>
+#include <utils/SystemClock.h>
+
+#include "GnssNmeaPassthrough.h"
+#include "GnssThreadPolicy.h"
+
+static const size_t nmeaElementsCount = 64;
+
+std::string GnssNmeaPassthrough::GetAllowlistProp()
+{
+    char allowlist[PROPERTY_VALUE_MAX] = {};
+    // Comma separated list of TYPE[:minIntervalMs], e.g. "RMC,GGA,GSV:5000", or "all"
+    property_get("ro.boot.gps.nmea_types", allowlist, "all");
+    return std::string(allowlist);
+}
+
+GnssNmeaPassthrough::GnssNmeaPassthrough() :
+    GnssNmeaPassthrough(GetAllowlistProp().c_str(), property_get_bool("ro.boot.gps.nmea_coalesce", false))
+{
+}
+
+GnssNmeaPassthrough::GnssNmeaPassthrough(const char* allowlist, bool coalesce) :
+    mCoalesce(coalesce),
+    mBuffer(nmeaElementsCount, sizeof(Element)),
+    mThreadExit(false),
+    mHasClient(false),
+    mForwarded(0),
+    mFiltered(0),
+    mRateLimited(0)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    ParseAllowlist(allowlist);
+    ALOGI("NMEA passthrough: types %s, coalesce %d", allowlist, mCoalesce);
+
+    mThread = std::thread(&GnssNmeaPassthrough::DeliveryThread, this);
+}
+
+GnssNmeaPassthrough::~GnssNmeaPassthrough()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mThreadExit = true;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void GnssNmeaPassthrough::ParseAllowlist(const char* allowlist)
+{
+    mRulesCount = 0;
+    mAllowAll = (strcmp(allowlist, "all") == 0);
+    if (mAllowAll) {
+        return;
+    }
+
+    const char* p = allowlist;
+    while (*p != '\0' && mRulesCount < mMaxRules) {
+        TypeRule& rule = mRules[mRulesCount];
+        size_t len = strcspn(p, ",:");
+
+        if (len > 0 && len < mTypeSize) {
+            memcpy(rule.type, p, len);
+            rule.type[len] = '\0';
+            rule.minIntervalMs = 0;
+            rule.lastMs = 0;
+
+            if (p[len] == ':') {
+                rule.minIntervalMs = strtoll(p + len + 1, nullptr, 10);
+            }
+            mRulesCount++;
+        } else if (len > 0) {
+            ALOGW("Invalid NMEA type in allowlist: %.*s", static_cast<int>(len), p);
+        }
+
+        p += strcspn(p, ",");
+        if (*p == ',') {
+            p++;
+        }
+    }
+}
+
+bool GnssNmeaPassthrough::GetSentenceType(const char* sentence, char* type)
+{
+    const size_t talkerLen = 3; // '$' and two talker characters
+    const size_t formatterLen = 3;
+
+    if (sentence[0] != '$') {
+        return false;
+    }
+
+    if (sentence[1] == 'P') {
+        /* Proprietary sentence, type is the whole address field, e.g. PUBX */
+        size_t len = strcspn(sentence + 1, ",*");
+        if (len == 0 || len >= mTypeSize) {
+            return false;
+        }
+        memcpy(type, sentence + 1, len);
+        type[len] = '\0';
+        return true;
+    }
+
+    if (strnlen(sentence, talkerLen + formatterLen) < talkerLen + formatterLen) {
+        return false;
+    }
+
+    memcpy(type, sentence + talkerLen, formatterLen);
+    type[formatterLen] = '\0';
+    return true;
+}
+
+GnssNmeaPassthrough::TypeRule* GnssNmeaPassthrough::FindRule(const char* type)
+{
+    for (size_t i = 0; i < mRulesCount; i++) {
+        if (strcmp(mRules[i].type, type) == 0) {
+            return &mRules[i];
+        }
+    }
+
+    return nullptr;
+}
+
+const GnssNmeaPassthrough::TypeRule* GnssNmeaPassthrough::FindRule(const char* type) const
+{
+    return const_cast<GnssNmeaPassthrough*>(this)->FindRule(type);
+}
+
+bool GnssNmeaPassthrough::IsTypeAllowed(const char* sentence) const
+{
+    char type[mTypeSize];
+    if (!GetSentenceType(sentence, type)) {
+        return false;
+    }
+
+    if (mAllowAll) {
+        /* Proprietary sentences were never forwarded by default */
+        return type[0] != 'P';
+    }
+
+    return FindRule(type) != nullptr;
+}
+
+void GnssNmeaPassthrough::SetCallback(const android::sp<IGnssCallback>& callback)
+{
+    std::lock_guard<std::mutex> lock(mCallbackLock);
+    mCallback = callback;
+    mHasClient = (callback != nullptr);
+}
+
+void GnssNmeaPassthrough::Put(const char* sentence, int64_t timestampMs)
+{
+    char type[mTypeSize];
+
+    if (!mHasClient) {
+        return;
+    }
+
+    if (!GetSentenceType(sentence, type) || !IsTypeAllowed(sentence)) {
+        mFiltered++;
+        return;
+    }
+
+    TypeRule* rule = mAllowAll ? nullptr : FindRule(type);
+    if (rule != nullptr && rule->minIntervalMs > 0) {
+        const int64_t nowMs = android::elapsedRealtime();
+        if (rule->lastMs != 0 && (nowMs - rule->lastMs) < rule->minIntervalMs) {
+            mRateLimited++;
+            return;
+        }
+        rule->lastMs = nowMs;
+    }
+
+    Element elem;
+    strncpy(elem.data, sentence, sizeof(elem.data) - 1);
+    elem.data[sizeof(elem.data) - 1] = '\0';
+    elem.timestampMs = timestampMs;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mBuffer.put(&elem);
+    }
+    mCv.notify_one();
+}
+
+void GnssNmeaPassthrough::DeliveryThread()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Callback, "gnss_nmea_cb");
+
+    while (!mThreadExit) {
+        std::unique_lock<std::mutex> lock(mLock);
+        auto ready = [this] { return mThreadExit || !mBuffer.empty(); };
+
+        if (mBatchLen > 0) {
+            /* End of the epoch burst is detected by a gap in the sentence flow */
+            if (!mCv.wait_for(lock, std::chrono::milliseconds(mCoalesceGapMs), ready)) {
+                lock.unlock();
+                Flush();
+                continue;
+            }
+        } else {
+            mCv.wait(lock, ready);
+        }
+
+        Element elem;
+        bool hasElem = false;
+        Element* head = mBuffer.get();
+        if (head != nullptr) {
+            elem = *head;
+            hasElem = true;
+        }
+        lock.unlock();
+
+        if (hasElem) {
+            Deliver(elem);
+        }
+    }
+
+    Flush();
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssNmeaPassthrough::Deliver(const Element& elem)
+{
+    if (!mCoalesce) {
+        Send(elem.data, strlen(elem.data), elem.timestampMs);
+        return;
+    }
+
+    const char separator[] = "\r\n";
+    const size_t len = strlen(elem.data);
+    const size_t sepLen = (mBatchLen > 0) ? sizeof(separator) - 1 : 0;
+
+    if (mBatchLen + sepLen + len >= sizeof(mBatch)) {
+        Flush();
+        Deliver(elem);
+        return;
+    }
+
+    if (mBatchLen == 0) {
+        mBatchTimestampMs = elem.timestampMs;
+    }
+
+    memcpy(mBatch + mBatchLen, separator, sepLen);
+    mBatchLen += sepLen;
+    memcpy(mBatch + mBatchLen, elem.data, len);
+    mBatchLen += len;
+    mBatch[mBatchLen] = '\0';
+}
+
+void GnssNmeaPassthrough::Flush()
+{
+    if (mBatchLen == 0) {
+        return;
+    }
+
+    Send(mBatch, mBatchLen, mBatchTimestampMs);
+    mBatchLen = 0;
+}
+
+void GnssNmeaPassthrough::Send(const char* data, size_t len, int64_t timestampMs)
+{
+    android::sp<IGnssCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(mCallbackLock);
+        callback = mCallback;
+    }
+
+    if (callback == nullptr) {
+        return;
+    }
+
+    android::hardware::hidl_string nmeaString;
+    nmeaString.setToExternal(data, len);
+
+    auto ret = callback->gnssNmeaCb(timestampMs, nmeaString);
+    if (!ret.isOk()) {
+        ALOGE("[%s, line %d] Unable to invoke gnssNmeaCb", __func__, __LINE__);
+        return;
+    }
+
+    mForwarded++;
+}
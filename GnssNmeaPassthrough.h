@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSNMEAPASSTHROUGH_H__
+#define __GNSSNMEAPASSTHROUGH_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <utils/RefBase.h>
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+#include "circular_buffer.h"
+
+using namespace android::hardware::gnss::V1_0;
+
+/*!
+ * \brief GnssNmeaPassthrough - delivers NMEA sentences to gnssNmeaCb off the parse thread
+ * \brief sentences are filtered by type allowlist and per-type rate limit,
+ * \brief optionally the sentences of one epoch are coalesced into one callback
+ */
+class GnssNmeaPassthrough
+{
+public:
+    /*!
+     * \brief GnssNmeaPassthrough - constructor, configuration is read from system properties
+     */
+    GnssNmeaPassthrough();
+
+    /*!
+     * \brief GnssNmeaPassthrough - constructor
+     * \param allowlist - comma separated list of TYPE[:minIntervalMs], or "all"
+     * \param coalesce - deliver sentences of one epoch in a single callback
+     */
+    GnssNmeaPassthrough(const char* allowlist, bool coalesce);
+    ~GnssNmeaPassthrough();
+
+    /*!
+     * \brief SetCallback - set framework callback used for delivery
+     * \param callback - framework callback, nullptr to stop delivery
+     */
+    void SetCallback(const android::sp<IGnssCallback>& callback);
+
+    /*!
+     * \brief HasClient - check if there is a callback to deliver sentences to
+     * \return true if callback is set
+     */
+    bool HasClient() const { return mHasClient; }
+
+    /*!
+     * \brief IsTypeAllowed - check sentence type against the allowlist
+     * \param sentence - NMEA sentence starting with '$'
+     * \return true if the type is allowed
+     */
+    bool IsTypeAllowed(const char* sentence) const;
+
+    /*!
+     * \brief Put - queue sentence for delivery, called from the parse thread
+     * \param sentence - complete NMEA sentence including checksum
+     * \param timestampMs - UTC time of reception in milliseconds
+     */
+    void Put(const char* sentence, int64_t timestampMs);
+
+    uint64_t GetForwardedCount() const { return mForwarded; }
+    uint64_t GetFilteredCount() const { return mFiltered; }
+    uint64_t GetRateLimitedCount() const { return mRateLimited; }
+
+private:
+    static const size_t mSentenceSize = 128;
+    static const size_t mTypeSize = 6;
+    static const size_t mMaxRules = 16;
+    static const size_t mBatchSize = 2048;
+    static constexpr int64_t mCoalesceGapMs = 50;
+
+    struct Element {
+        char    data[mSentenceSize];
+        int64_t timestampMs;
+    };
+
+    struct TypeRule {
+        char    type[mTypeSize];
+        int64_t minIntervalMs;
+        int64_t lastMs;
+    };
+
+    static std::string GetAllowlistProp();
+    static bool GetSentenceType(const char* sentence, char* type);
+    void ParseAllowlist(const char* allowlist);
+    TypeRule* FindRule(const char* type);
+    const TypeRule* FindRule(const char* type) const;
+
+    void DeliveryThread();
+    void Deliver(const Element& elem);
+    void Flush();
+    void Send(const char* data, size_t len, int64_t timestampMs);
+
+    bool     mAllowAll = true;
+    bool     mCoalesce = false;
+    TypeRule mRules[mMaxRules];
+    size_t   mRulesCount = 0;
+
+    CircularBuffer<Element> mBuffer;
+    std::thread             mThread;
+    std::atomic<bool>       mThreadExit;
+    std::mutex              mLock;
+    std::condition_variable mCv;
+
+    mutable std::mutex         mCallbackLock;
+    android::sp<IGnssCallback> mCallback;
+    std::atomic<bool>          mHasClient;
+
+    char    mBatch[mBatchSize];
+    size_t  mBatchLen = 0;
+    int64_t mBatchTimestampMs = 0;
+
+    std::atomic<uint64_t> mForwarded;
+    std::atomic<uint64_t> mFiltered;
+    std::atomic<uint64_t> mRateLimited;
+};
+
+#endif // __GNSSNMEAPASSTHROUGH_H__
@@ -21,16 +21,6 @@
 
 #include "GnssParserCommonImpl.h"
 
-bool GnssParserCommonImpl::isBigEndian()
-{
-    union
-    {
-        uint32_t dec;
-        char literal[4];
-    } checker = {0x01020304};
-    return 0x01 == checker.literal[0] ? true : false;
-}
-
 void GnssParserCommonImpl::dumpDebug()
 {
     ALOGV("[%s, line %d]", __func__, __LINE__);
@@ -17,54 +17,13 @@
 #ifndef __GNSSPARSERCOMMONIMPL_H__
 #define __GNSSPARSERCOMMONIMPL_H__
 
+#include <cstring>
+#include <type_traits>
+
 #include "GnssIParser.h"
+#include "GnssUbxRegistry.h"
 
 class GnssParserCommonImpl : public GnssIParser {
-
-    /*!
-     * \brief isBigEndian - check if current system is big endian
-     * \return true if big endian
-     */
-    bool isBigEndian();
-
-    template <typename T>
-    T get(const uint8_t* ptr)
-    {
-        union
-        {
-            T out;
-            uint8_t in[sizeof(T)];
-        } result;
-
-        size_t sizeOfType = sizeof(T);
-        for(size_t i = 0; i < sizeOfType; ++i) {
-            result.in[i] = ptr[i];
-        }
-
-        return result.out;
-    }
-
-    template <typename T>
-    T convert(const uint8_t* ptr)
-    {
-        union
-        {
-            T out;
-            uint8_t in[sizeof(T)];
-        } result;
-
-        size_t reverseCounter = sizeof(T) - 1;
-        for (auto& byte : result.in) {
-            byte = ptr[reverseCounter];
-            --reverseCounter;
-            if (0 == reverseCounter) {
-                break;
-            }
-        }
-
-        return result.out;
-    }
-
 public:
     /*!
      * \brief retrieveSvInfo - provide data collected from parsed messages
@@ -136,9 +95,54 @@ protected:
     void hexdump(const char* file, void* ptr, size_t buflen);
 
     /*!
-     * \brief getValue
-     * \param ptr
-     * \return
+     * \brief byteSwap - reverse the byte order of the value
+     */
+    template <typename T>
+    static T byteSwap(T value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "arithmetic type is expected");
+
+        if constexpr (sizeof(T) == 1) {
+            return value;
+        } else {
+            typedef std::conditional_t<sizeof(T) == 2, uint16_t,
+                    std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>> Bits;
+            static_assert(sizeof(T) == sizeof(Bits), "unsupported type size");
+
+            Bits bits;
+            memcpy(&bits, &value, sizeof(bits));
+            if constexpr (sizeof(T) == 2) {
+                bits = __builtin_bswap16(bits);
+            } else if constexpr (sizeof(T) == 4) {
+                bits = __builtin_bswap32(bits);
+            } else {
+                bits = __builtin_bswap64(bits);
+            }
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    /*!
+     * \brief loadLE - read a little endian value from unaligned memory
+     * \brief memcpy is folded into a single load, the byte swap is compiled in on big endian targets only
+     * \param ptr - a pointer to the value, must not be null
+     */
+    template <typename T>
+    static T loadLE(const uint8_t* ptr)
+    {
+        T value;
+        memcpy(&value, ptr, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = byteSwap(value);
+#endif
+        return value;
+    }
+
+    /*!
+     * \brief getValue - read a little endian value, null safe version of loadLE
+     * \param ptr - a pointer to the value
+     * \return the value, 0 for null input
      */
     template <typename T>
     T getValue(const uint8_t* ptr)
@@ -147,11 +151,18 @@ protected:
             return 0;
         }
 
-        if (isBigEndian()) {
-            return convert<T>(ptr);
-        }
+        return loadLE<T>(ptr);
+    }
 
-        return get<T>(ptr);
+    /*!
+     * \brief load - read the field described by UbxField from the block
+     * \param block - a pointer to the beginning of the block, its length is checked against the schema
+     * \return raw value of the field
+     */
+    template <typename Field>
+    typename Field::type load(const uint8_t* block)
+    {
+        return loadLE<typename Field::type>(block + Field::offset);
     }
 };
 #endif // __GNSSPARSERCOMMONIMPL_H__
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasReactor"
+#define LOG_NDEBUG 1
+
+#include <chrono>
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <log/log.h>
+
+#include "GnssReactor.h"
+
+static const int64_t nsInMs = 1000000;
+static const int64_t nsInSec = 1000000000;
+
+GnssReactor::GnssReactor(Handler& handler) :
+    mHandler(handler),
+    mStop(false),
+    mWakeups(0),
+    mReadEvents(0),
+    mTimerEvents(0),
+    mControlEvents(0),
+    mMaxHandlerUs(0)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    mEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (!IsValid() || !AddFd(mTimerFd) || !AddFd(mEventFd)) {
+        ALOGE("[%s, line %d] Unable to create the event loop: %s", __func__, __LINE__, strerror(errno));
+    }
+}
+
+GnssReactor::~GnssReactor()
+{
+    const int fds[] = {mEventFd, mTimerFd, mEpollFd};
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool GnssReactor::AddFd(int fd)
+{
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        ALOGE("[%s, line %d] Unable to watch fd %d: %s", __func__, __LINE__, fd, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void GnssReactor::RemoveFd(int fd)
+{
+    epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void GnssReactor::SetTimeout(int64_t timeoutMs)
+{
+    struct itimerspec spec = {};
+    if (timeoutMs >= 0) {
+        // zero disarms the timer, an expired deadline fires as soon as possible
+        const int64_t timeoutNs = (timeoutMs > 0) ? timeoutMs * nsInMs : 1;
+        spec.it_value.tv_sec = static_cast<time_t>(timeoutNs / nsInSec);
+        spec.it_value.tv_nsec = static_cast<long>(timeoutNs % nsInSec);
+    }
+
+    if (timerfd_settime(mTimerFd, 0, &spec, nullptr) < 0) {
+        ALOGE("[%s, line %d] Unable to arm the timer: %s", __func__, __LINE__, strerror(errno));
+    }
+}
+
+void GnssReactor::Run()
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    struct epoll_event events[mMaxEvents];
+
+    while (!mStop) {
+        const int count = epoll_wait(mEpollFd, events, mMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ALOGE("[%s, line %d] epoll_wait failed: %s", __func__, __LINE__, strerror(errno));
+            break;
+        }
+
+        mWakeups++;
+        for (int i = 0; i < count; i++) {
+            const int fd = events[i].data.fd;
+            uint64_t value = 0;
+
+            if (fd == mEventFd) {
+                mControlEvents++;
+                (void)read(mEventFd, &value, sizeof(value));
+            } else if (!mStop) {
+                // the handler is not called after Stop
+                Dispatch(fd);
+            }
+        }
+    }
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+void GnssReactor::Dispatch(int fd)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if (fd == mTimerFd) {
+        uint64_t value = 0;
+        if (read(mTimerFd, &value, sizeof(value)) == sizeof(value)) {
+            mTimerEvents++;
+            mHandler.OnTimeout();
+        }
+    } else {
+        mReadEvents++;
+        if (!mHandler.OnReadable(fd)) {
+            RemoveFd(fd);
+        }
+    }
+
+    // every event of the loop waits for the slowest handler
+    const int64_t handlerUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    if (handlerUs > mMaxHandlerUs) {
+        mMaxHandlerUs = handlerUs;
+    }
+}
+
+void GnssReactor::Stop()
+{
+    const uint64_t value = 1;
+    mStop = true;
+    if (write(mEventFd, &value, sizeof(value)) < 0) {
+        ALOGE("[%s, line %d] Unable to wake up the loop: %s", __func__, __LINE__, strerror(errno));
+    }
+}
+
+GnssReactor::Stats GnssReactor::GetStats() const
+{
+    Stats stats;
+    stats.wakeups = mWakeups;
+    stats.readEvents = mReadEvents;
+    stats.timerEvents = mTimerEvents;
+    stats.controlEvents = mControlEvents;
+    stats.maxHandlerUs = mMaxHandlerUs;
+    return stats;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSREACTOR_H__
+#define __GNSSREACTOR_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * \brief GnssReactor - single thread event loop over epoll
+ * \brief the loop waits for readable descriptors, a timerfd for deadlines and retries
+ * \brief and an eventfd for control, the handler is called on the loop thread only
+ */
+class GnssReactor
+{
+public:
+    /*!
+     * \brief Handler - receiver of the loop events
+     * \brief handlers must not block, anything that waits is handed over to another
+     * \brief thread, e.g. the callback executor, maxHandlerUs shows when they do
+     */
+    class Handler
+    {
+    public:
+        virtual ~Handler() {}
+
+        /*!
+         * \brief OnReadable - the descriptor added by AddFd has data to read
+         * \param fd - the descriptor
+         * \return false to remove the descriptor from the loop, e.g. on read error
+         */
+        virtual bool OnReadable(int fd) = 0;
+
+        /*!
+         * \brief OnTimeout - the timeout armed by SetTimeout has expired
+         */
+        virtual void OnTimeout() = 0;
+    };
+
+    struct Stats {
+        uint64_t wakeups = 0;
+        uint64_t readEvents = 0;
+        uint64_t timerEvents = 0;
+        uint64_t controlEvents = 0;
+        int64_t maxHandlerUs = 0;
+    };
+
+    explicit GnssReactor(Handler& handler);
+    ~GnssReactor();
+
+    /*!
+     * \brief IsValid - check if the epoll, timer and control descriptors were created
+     * \return true if the loop can run
+     */
+    bool IsValid() const { return mEpollFd >= 0 && mTimerFd >= 0 && mEventFd >= 0; }
+
+    /*!
+     * \brief AddFd - watch the descriptor for readability
+     * \param fd - the descriptor
+     * \return true on success
+     */
+    bool AddFd(int fd);
+
+    /*!
+     * \brief RemoveFd - stop watching the descriptor
+     * \param fd - the descriptor
+     */
+    void RemoveFd(int fd);
+
+    /*!
+     * \brief SetTimeout - arm the one-shot timer, the previous timeout is replaced
+     * \param timeoutMs - time to OnTimeout in ms, negative to disarm
+     */
+    void SetTimeout(int64_t timeoutMs);
+
+    /*!
+     * \brief Run - dispatch events until Stop is called
+     */
+    void Run();
+
+    /*!
+     * \brief Stop - make Run return, may be called from any thread
+     */
+    void Stop();
+
+    /*!
+     * \brief GetStats - provide the loop counters
+     * \return copy of the counters
+     */
+    Stats GetStats() const;
+
+private:
+    static const size_t mMaxEvents = 4;
+
+    /*!
+     * \brief Dispatch - call the handler for the descriptor, track the handler duration
+     */
+    void Dispatch(int fd);
+
+    Handler& mHandler;
+    int mEpollFd = -1;
+    int mTimerFd = -1;
+    int mEventFd = -1;
+    std::atomic<bool> mStop;
+
+    std::atomic<uint64_t> mWakeups;
+    std::atomic<uint64_t> mReadEvents;
+    std::atomic<uint64_t> mTimerEvents;
+    std::atomic<uint64_t> mControlEvents;
+    std::atomic<int64_t>  mMaxHandlerUs;
+};
+
+#endif // __GNSSREACTOR_H__
@@ -20,12 +20,44 @@
 #include <log/log.h>
 #include "GnssRxmMeasxParser.h"
 
-static const uint8_t maxSvsNum = 64;
-static const uint16_t repeatedBlockSize = 24;
-static const uint16_t singleBlockSize = 44;
+// Using fields according to the protocol description of UBX-RXM-MEASX
+namespace UbxRxmMeasx {
+// first block
+typedef UbxField<uint8_t, 0> version;
+typedef UbxField<uint32_t, 4> gpsTOW;
+typedef UbxField<uint32_t, 8> glonassTOW;
+typedef UbxField<uint32_t, 12> bdsTOW;
+typedef UbxField<uint32_t, 20> qzssTOW;
+typedef UbxField<uint16_t, 24> gpsTOWacc;
+typedef UbxField<uint16_t, 26> glonassTOWacc;
+typedef UbxField<uint16_t, 28> bdsTOWacc;
+typedef UbxField<uint16_t, 32> qzssTOWacc;
+typedef UbxField<uint8_t, 34> numSvs;
+typedef UbxField<uint8_t, 35> TOWset;
+typedef UbxSchema<44, version, gpsTOW, glonassTOW, bdsTOW, qzssTOW, gpsTOWacc, glonassTOWacc,
+                  bdsTOWacc, qzssTOWacc, numSvs, TOWset> SingleBlock;
+
+// repeated block
+typedef UbxField<uint8_t, 0> gnssId;
+typedef UbxField<uint8_t, 1> svId;
+typedef UbxField<uint8_t, 2> cn0;
+typedef UbxField<uint8_t, 3> multipath;
+typedef UbxField<int32_t, 4, std::ratio<4, 100>> pseudorangeRate; // 0.04 m/s
+typedef UbxSchema<24, gnssId, svId, cn0, multipath, pseudorangeRate> RepeatedBlock;
+}
+
+static const uint16_t repeatedBlockSize = UbxRxmMeasx::RepeatedBlock::blockSize;
+static const uint16_t singleBlockSize = UbxRxmMeasx::SingleBlock::blockSize;
 static const int64_t towAccScaleDown = 16;
-static const double pseudorangeRateScaleUp = 0.04;
+static const double pseudorangeRateScaleUp = UbxRxmMeasx::pseudorangeRate::scale;
 static const int64_t msToNsMultiplier = 1000000;
+static const double pseudorangeRateUncertaintyMps = 0.075; // TODO: set real value, at moment it is pure magic.
+static const double carrierFrequencyScale = 1000000.0;
+static const float L1BandFrequency = 1575.42f;
+static const float B1BandFrequency = 1561.098f;
+static const float L1GlonassBandFrequency = 1602.562f;
+static const uint32_t towSyncState = MeasurementState::STATE_BIT_SYNC |
+                                     MeasurementState::STATE_SUBFRAME_SYNC;
 
 // Satellite vehicle numbering according to documentation
 static const uint8_t gpsFirst = 1;
@@ -45,27 +77,28 @@ static const uint8_t glonassFcnLast = 106;
 static const uint8_t glonassFirst = 1;
 static const uint8_t glonassLast = 24;
 
-// Using offsets according to the protocol description of UBX-RXM-MEASX
-enum RxmMeasxOffsets : uint8_t {
-    //first block offsets
-    version = 0,
-    gpsTOW = 4,
-    glonassTOW = 8,
-    bdsTOW = 12,
-    qzssTOW = 20,
-    gpsTOWacc = 24,
-    glonassTOWacc = 26,
-    bdsTOWacc = 28,
-    qzssTOWacc = 32,
-    numSvs = 34,
-    TOWset = 35,
-
-    //repeated block offsets
-    gnssIdOfst = 0,
-    svId = 1,
-    cn0 = 2,
-    multipath = 3,
-    pseudorangeRate = 4,
+
+static const uint32_t carrierFlag = static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_FREQUENCY);
+static const uint32_t towDecoded = static_cast<uint32_t>(MeasurementState::STATE_TOW_DECODED);
+static const uint32_t towKnown = static_cast<uint32_t>(MeasurementState::STATE_TOW_KNOWN);
+static const uint32_t towUnknown = static_cast<uint32_t>(MeasurementState::STATE_UNKNOWN);
+
+// Indexed by UbxGnssId, the last entry covers IMES and unknown ids
+const GnssRxmMeasxParser::gnssIdInfo_t GnssRxmMeasxParser::mGnssIdInfo[mGnssIdCount] = {
+    {CnstlType::GPS, static_cast<float>(L1BandFrequency * carrierFrequencyScale), carrierFlag,
+     towDecoded, TowGps, gpsFirst, gpsLast, gpsFirst, gpsLast},
+    {CnstlType::SBAS, static_cast<float>(L1BandFrequency * carrierFrequencyScale), carrierFlag,
+     towKnown, TowGps, sbasOneFirst, sbasOneLast, sbasTwoFirst, sbasTwoLast}, //TODO: find better TOW
+    {CnstlType::GALILEO, static_cast<float>(L1BandFrequency * carrierFrequencyScale), carrierFlag,
+     towKnown, TowGps, galileoFirst, galileoLast, galileoFirst, galileoLast}, //TODO: find better TOW
+    {CnstlType::BEIDOU, static_cast<float>(B1BandFrequency * carrierFrequencyScale), carrierFlag,
+     towDecoded, TowBds, bdFirst, bdLast, bdFirst, bdLast},
+    {CnstlType::UNKNOWN, 0.0f, 0, towUnknown, TowNone, 0, UINT8_MAX, 0, UINT8_MAX},
+    {CnstlType::QZSS, static_cast<float>(L1BandFrequency * carrierFrequencyScale), carrierFlag,
+     towDecoded, TowQzss, qzssFirst, qzssLast, qzssFirst, qzssLast},
+    {CnstlType::GLONASS, static_cast<float>(L1GlonassBandFrequency * carrierFrequencyScale),
+     carrierFlag, towDecoded, TowGlonass, glonassFirst, glonassLast, glonassFcnFirst, glonassFcnLast},
+    {CnstlType::UNKNOWN, 0.0f, 0, towUnknown, TowNone, 0, UINT8_MAX, 0, UINT8_MAX},
 };
 
 GnssRxmMeasxParser::GnssRxmMeasxParser(const uint8_t* payload,
@@ -77,37 +110,37 @@ GnssRxmMeasxParser::GnssRxmMeasxParser(const uint8_t* payload,
     mPayloadLen = 0;;
 }
 
-void GnssRxmMeasxParser::parseSingleBlock(const uint8_t* msg) {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-
-    if (nullptr != msg) {
-        meta.version = msg[RxmMeasxOffsets::version];
-        meta.numSvs = msg[RxmMeasxOffsets::numSvs];
-        meta.gpsTOW = getValue<uint32_t>(&msg[RxmMeasxOffsets::gpsTOW]);
-        meta.glonassTOW = getValue<uint32_t>(&msg[RxmMeasxOffsets::glonassTOW]);
-        meta.bdsTOW = getValue<uint32_t>(&msg[RxmMeasxOffsets::bdsTOW]);
-        meta.qzssTOW = getValue<uint32_t>(&msg[RxmMeasxOffsets::qzssTOW]);
-        meta.gpsTOWacc = getValue<uint16_t>(&msg[RxmMeasxOffsets::gpsTOWacc]);
-        meta.glonassTOWacc = getValue<uint16_t>(&msg[RxmMeasxOffsets::glonassTOWacc]);
-        meta.bdsTOWacc = getValue<uint16_t>(&msg[RxmMeasxOffsets::bdsTOWacc]);
-        meta.qzssTOWacc = getValue<uint16_t>(&msg[RxmMeasxOffsets::qzssTOWacc]);
-        meta.TOWset = msg[RxmMeasxOffsets::TOWset];
-        ALOGV("[%s, line %d] Exit", __func__, __LINE__);
-    }
+const GnssRxmMeasxParser::gnssIdInfo_t& GnssRxmMeasxParser::getGnssIdInfo(const uint8_t gnssId) {
+    return mGnssIdInfo[(gnssId < mGnssIdCount) ? gnssId : (mGnssIdCount - 1)];
 }
 
-void GnssRxmMeasxParser::parseRepeatedBlock(const uint8_t* msg) {
+void GnssRxmMeasxParser::parseSingleBlock(const uint8_t* msg) {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
     if (nullptr != msg) {
-        repeatedBlock_t block;
-        block.gnssId = msg[RxmMeasxOffsets::gnssIdOfst];
-        block.svId = msg[RxmMeasxOffsets::svId];
-        block.cn0 = msg[RxmMeasxOffsets::cn0];
-        block.multipath = msg[RxmMeasxOffsets::multipath];
-        block.pseudoRangeRate = getValue<int32_t>
-                                (&msg[RxmMeasxOffsets::pseudorangeRate]);
-        data.push_back(block);
+        meta.version = load<UbxRxmMeasx::version>(msg);
+        meta.numSvs = load<UbxRxmMeasx::numSvs>(msg);
+        meta.gpsTOW = load<UbxRxmMeasx::gpsTOW>(msg);
+        meta.glonassTOW = load<UbxRxmMeasx::glonassTOW>(msg);
+        meta.bdsTOW = load<UbxRxmMeasx::bdsTOW>(msg);
+        meta.qzssTOW = load<UbxRxmMeasx::qzssTOW>(msg);
+        meta.gpsTOWacc = load<UbxRxmMeasx::gpsTOWacc>(msg);
+        meta.glonassTOWacc = load<UbxRxmMeasx::glonassTOWacc>(msg);
+        meta.bdsTOWacc = load<UbxRxmMeasx::bdsTOWacc>(msg);
+        meta.qzssTOWacc = load<UbxRxmMeasx::qzssTOWacc>(msg);
+        meta.TOWset = load<UbxRxmMeasx::TOWset>(msg);
+
+        if (0 != meta.TOWset) {
+            mTow[TowGps] = meta.gpsTOW;
+            mTow[TowGlonass] = meta.glonassTOW;
+            mTow[TowBds] = meta.bdsTOW;
+            mTow[TowQzss] = meta.qzssTOW;
+            mTowAcc[TowGps] = meta.gpsTOWacc;
+            mTowAcc[TowGlonass] = meta.glonassTOWacc;
+            mTowAcc[TowBds] = meta.bdsTOWacc;
+            mTowAcc[TowQzss] = meta.qzssTOWacc;
+        }
+
         ALOGV("[%s, line %d] Exit", __func__, __LINE__);
     }
 }
@@ -121,16 +154,33 @@ void GnssRxmMeasxParser::parseRepeatedBlocks(const uint8_t* msg,
         return;
     }
 
-    uint16_t offset = 0;
+    const uint16_t blocksInMsg = msgLen / repeatedBlockSize;
+    const uint8_t count = static_cast<uint8_t>(
+                              (meta.numSvs < blocksInMsg) ? meta.numSvs : blocksInMsg);
 
-    for (uint8_t i = 0; i < meta.numSvs; i++) {
-        if (offset + repeatedBlockSize <= msgLen) {
-            parseRepeatedBlock(msg + offset);
-            offset += repeatedBlockSize;
-            mValid = true;
-        }
+    // One loop per field: fixed stride, no branches, the compiler is free to unroll/vectorize
+    for (uint8_t i = 0; i < count; i++) {
+        mGnssIds[i] = load<UbxRxmMeasx::gnssId>(msg + i * repeatedBlockSize);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        mSvIds[i] = load<UbxRxmMeasx::svId>(msg + i * repeatedBlockSize);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        mCn0[i] = load<UbxRxmMeasx::cn0>(msg + i * repeatedBlockSize);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        mMultipath[i] = load<UbxRxmMeasx::multipath>(msg + i * repeatedBlockSize);
     }
 
+    for (uint8_t i = 0; i < count; i++) {
+        mPseudorangeRate[i] = load<UbxRxmMeasx::pseudorangeRate>(msg + i * repeatedBlockSize);
+    }
+
+    mSvsCount = count;
+    mValid = (count > 0);
     ALOGV("[%s, line %d] Exit", __func__, __LINE__);
 }
 
@@ -138,7 +188,7 @@ void GnssRxmMeasxParser::parseRxmMeasMsg() {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
     if (nullptr == mPayload
-        || ((maxSvsNum * repeatedBlockSize) + singleBlockSize) < mPayloadLen) {
+        || ((mMaxSvsNum * repeatedBlockSize) + singleBlockSize) < mPayloadLen) {
         ALOGV("[%s, line %d] mPayload is null", __func__, __LINE__);
         return;
     }
@@ -146,7 +196,7 @@ void GnssRxmMeasxParser::parseRxmMeasMsg() {
     if (mPayloadLen >= singleBlockSize + repeatedBlockSize) {
         parseSingleBlock(mPayload);
 
-        if (meta.numSvs <= maxSvsNum) {
+        if (meta.numSvs <= mMaxSvsNum) {
             parseRepeatedBlocks(mPayload + singleBlockSize, mPayloadLen - singleBlockSize);
         }
 
@@ -155,227 +205,61 @@ void GnssRxmMeasxParser::parseRxmMeasMsg() {
 }
 
 CnstlType GnssRxmMeasxParser::getConstellationFromGnssId(const uint8_t gnssId) {
-    switch (gnssId) {
-    case UbxGnssId::GPS:
-        return CnstlType::GPS;
-
-    case UbxGnssId::GLONASS:
-        return CnstlType::GLONASS;
-
-    case UbxGnssId::GALILEO:
-        return CnstlType::GALILEO;
-
-    case UbxGnssId::QZSS:
-        return CnstlType::QZSS;
-
-    case UbxGnssId::BEIDOU:
-        return CnstlType::BEIDOU;
-
-    case UbxGnssId::SBAS:
-        return CnstlType::SBAS;
-
-    default:
-        return CnstlType::UNKNOWN;
-    }
-}
-
-uint32_t GnssRxmMeasxParser::getTOWforGnssId(const uint8_t gnssId) {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-
-    if (0 == meta.TOWset) {
-        mTOWstate = MeasurementState::STATE_UNKNOWN;
-        ALOGV("[%s, line %d] TOW unknown", __func__, __LINE__);
-        return 0;
-    }
-
-    uint32_t result = 0;
-    mTOWstate = MeasurementState::STATE_TOW_DECODED;
-
-    switch (gnssId) {
-    case UbxGnssId::GPS:
-        result = meta.gpsTOW;
-        break;
-
-    case UbxGnssId::GLONASS:
-        result = meta.glonassTOW;
-        break;
-
-    case UbxGnssId::QZSS:
-        result = meta.qzssTOW;
-        break;
-
-    case UbxGnssId::BEIDOU:
-        result = meta.bdsTOW;
-        break;
-
-    case UbxGnssId::SBAS:
-    case UbxGnssId::GALILEO:
-        mTOWstate = MeasurementState::STATE_TOW_KNOWN;
-        result = meta.gpsTOW; //TODO: find better solution
-        break;
-    }
-
-    if (0 == result) {
-        mTOWstate = MeasurementState::STATE_UNKNOWN;
-    } else {
-        mTOWstate = static_cast<MeasurementState>(mTOWstate |
-                    MeasurementState::STATE_BIT_SYNC | MeasurementState::STATE_SUBFRAME_SYNC);
-    }
-
-    return result;
-}
-
-int64_t GnssRxmMeasxParser::getTOWaccForGnssId(const uint8_t gnssId) {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-
-    if (0 == meta.TOWset || MeasurementState::STATE_UNKNOWN == mTOWstate) {
-        ALOGV("[%s, line %d] TOW unknown", __func__, __LINE__);
-        return 0;
-    }
-
-    uint16_t towAccMs  = 0;
-
-    switch (gnssId) {
-    case UbxGnssId::GPS:
-        towAccMs = meta.gpsTOWacc;
-        break;
-
-    case UbxGnssId::GLONASS:
-        towAccMs = meta.glonassTOWacc;
-        break;
-
-    case UbxGnssId::QZSS:
-        towAccMs = meta.qzssTOWacc;
-        break;
-
-    case UbxGnssId::BEIDOU:
-        towAccMs = meta.bdsTOWacc;
-        break;
-
-    case UbxGnssId::SBAS:
-    case UbxGnssId::GALILEO:
-        towAccMs = meta.gpsTOWacc; //TODO: find better solution
-        break;
-
-    default:
-        mTOWstate = MeasurementState::STATE_UNKNOWN;
-        return 0;
-    }
-
-    int64_t result = scaleUp(scaleDown(towAccMs, towAccScaleDown),
-                             msToNsMultiplier);
-    return ((result > 0) ? result : 1);
+    return getGnssIdInfo(gnssId).constellation;
 }
 
 uint8_t GnssRxmMeasxParser::getValidSvidForGnssId(const uint8_t gnssId,
         const uint8_t svid) {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    const gnssIdInfo_t& info = getGnssIdInfo(gnssId);
     uint8_t resultSvid = svid;
 
-    switch (gnssId) {
-    case UbxGnssId::GPS:
-        inRange(gpsFirst, gpsLast, resultSvid);
-        break;
-
-    case UbxGnssId::SBAS:
-        inRanges(sbasOneFirst, sbasOneLast, sbasTwoFirst, sbasTwoLast, resultSvid);
-        break;
-
-    case UbxGnssId::GALILEO:
-        inRange(galileoFirst, galileoLast, resultSvid);
-        break;
-
-    case UbxGnssId::QZSS:
-        inRange(qzssFirst, qzssLast, resultSvid);
-        break;
-
-    case UbxGnssId::BEIDOU:
-        inRange(bdFirst, bdLast, resultSvid);
-        break;
-
-    case UbxGnssId::GLONASS:
-        inRanges(glonassFirst, glonassLast, glonassFcnFirst, glonassFcnLast,
-                 resultSvid);
-        break;
-    }
+    inRanges(info.firstBegin, info.firstEnd, info.secondBegin, info.secondEnd, resultSvid);
 
     ALOGV("[%s, line %d] svid = %u", __func__, __LINE__, resultSvid);
     return resultSvid;
 }
 
-float GnssRxmMeasxParser::getCarrierFrequencyFromGnssId(const uint8_t gnssId) {
-    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    const float L1BandFrequency = 1575.42f;
-    const float B1BandFrequency = 1561.098f;
-    const float L1GlonassBandFrequency = 1602.562f;
-    const float scale = 1000000.0;
-
-    switch (gnssId) {
-    case UbxGnssId::GPS:
-    case UbxGnssId::SBAS:
-    case UbxGnssId::GALILEO:
-    case UbxGnssId::QZSS:
-        return scaleUp(L1BandFrequency, scale);
-
-    case UbxGnssId::BEIDOU:
-        return scaleUp(B1BandFrequency, scale);
-
-    case UbxGnssId::GLONASS:
-        return scaleUp(L1GlonassBandFrequency, scale);
-
-    default:
-        return 0;
-    }
-}
-
-void GnssRxmMeasxParser::getGnssMeasurement(MeasurementCb::GnssMeasurement&
-        instance,
-        const repeatedBlock_t& block) {
+uint8_t GnssRxmMeasxParser::getEpoch(uint32_t& iTow)
+{
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
-    instance.carrierFrequencyHz = getCarrierFrequencyFromGnssId(block.gnssId);
-    instance.flags = 0;
-
-    if (instance.carrierFrequencyHz > 0.0f) {
-        instance.flags = static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_FREQUENCY);
-    }
-
-    instance.svid = getValidSvidForGnssId(block.gnssId, block.svId);
-    instance.constellation = getConstellationFromGnssId(block.gnssId);
-    instance.receivedSvTimeInNs = scaleUp(getTOWforGnssId(block.gnssId),
-                                          msToNsMultiplier);
-    instance.receivedSvTimeUncertaintyInNs = getTOWaccForGnssId(block.gnssId);
-    instance.state = static_cast<uint32_t>(mTOWstate);
-    instance.cN0DbHz = static_cast<double>(block.cn0);
-    instance.multipathIndicator = (block.multipath == 0) ?
-                                  MultipathId::INDICATIOR_NOT_PRESENT : MultipathId::INDICATOR_PRESENT;
-    instance.pseudorangeRateMps = scaleUp(block.pseudoRangeRate,
-                                          pseudorangeRateScaleUp);
-    instance.pseudorangeRateUncertaintyMps =
-        0.075; // TODO: set real value, at moment it is pure magic.
-    instance.accumulatedDeltaRangeState = static_cast<uint16_t>
-                                          (AccumulatedDeltaRangeState::ADR_STATE_UNKNOWN);
-    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+    iTow = meta.gpsTOW;
+    return mValid ? RxmDone : NotReady;
 }
 
 uint8_t GnssRxmMeasxParser::retrieveSvInfo(MeasurementCb::GnssData& gnssData) {
     ALOGV("[%s, line %d] Entry", __func__, __LINE__);
 
-    if (mValid) {
-        uint32_t measurementCount = 0;
-
-        for (auto& block : data) {
-            if (measurementCount < maxSvsNum) {
-                getGnssMeasurement(gnssData.measurements[measurementCount], block);
-                ++measurementCount;
-            }
-        }
+    if (!mValid) {
+        return NotReady;
+    }
 
-        gnssData.measurementCount = measurementCount;
-        ALOGV("[%s, line %d] Exit Done", __func__, __LINE__);
-        return RxmDone;
+    for (uint8_t i = 0; i < mSvsCount; i++) {
+        const gnssIdInfo_t& info = getGnssIdInfo(mGnssIds[i]);
+        MeasurementCb::GnssMeasurement& instance = gnssData.measurements[i];
+        const uint32_t towMs = mTow[info.towSlot];
+        const int64_t towAccNs = scaleUp(scaleDown(mTowAcc[info.towSlot], towAccScaleDown),
+                                         msToNsMultiplier);
+
+        instance.carrierFrequencyHz = info.carrierFrequencyHz;
+        instance.flags = info.flags;
+        instance.svid = getValidSvidForGnssId(mGnssIds[i], mSvIds[i]);
+        instance.constellation = info.constellation;
+        instance.receivedSvTimeInNs = scaleUp(towMs, msToNsMultiplier);
+        instance.receivedSvTimeUncertaintyInNs = (0 == towMs) ? 0 : ((towAccNs > 0) ? towAccNs : 1);
+        instance.state = (0 == towMs) ? towUnknown : (info.towState | towSyncState);
+        instance.cN0DbHz = static_cast<double>(mCn0[i]);
+        instance.multipathIndicator = (0 == mMultipath[i]) ?
+                                      MultipathId::INDICATIOR_NOT_PRESENT : MultipathId::INDICATOR_PRESENT;
+        instance.pseudorangeRateMps = scaleUp(mPseudorangeRate[i], pseudorangeRateScaleUp);
+        instance.pseudorangeRateUncertaintyMps = pseudorangeRateUncertaintyMps;
+        instance.accumulatedDeltaRangeState = static_cast<uint16_t>
+                                              (AccumulatedDeltaRangeState::ADR_STATE_UNKNOWN);
     }
 
-    return NotReady;
+    gnssData.measurementCount = mSvsCount;
+    ALOGV("[%s, line %d] Exit Done", __func__, __LINE__);
+    return RxmDone;
 }
 
 void GnssRxmMeasxParser::dumpDebug() {
@@ -383,12 +267,11 @@ void GnssRxmMeasxParser::dumpDebug() {
     const char* file = "/data/app/RxmMeasxParser_dump";
     hexdump(file, (void*)&meta, sizeof(meta));
 
-    for (auto block : data) {
-        hexdump(file, (void*)&block, sizeof(repeatedBlock_t));
-        ALOGV("[%s, line %d] svid: %u, constel: %u, state: %u, cN0DbHz: %u, mpath: %u, pRangeRate: %f",
-              __func__, __LINE__, block.svId,
-              (uint16_t)getConstellationFromGnssId(block.gnssId),
-              (uint32_t)mTOWstate, block.cn0, (uint16_t)block.multipath,
-              scaleUp(block.pseudoRangeRate, pseudorangeRateScaleUp));
+    for (uint8_t i = 0; i < mSvsCount; i++) {
+        ALOGV("[%s, line %d] svid: %u, constel: %u, cN0DbHz: %u, mpath: %u, pRangeRate: %f",
+              __func__, __LINE__, mSvIds[i],
+              (uint16_t)getConstellationFromGnssId(mGnssIds[i]),
+              mCn0[i], (uint16_t)mMultipath[i],
+              scaleUp(mPseudorangeRate[i], pseudorangeRateScaleUp));
     }
 }
@@ -17,10 +17,7 @@
 #ifndef __GNSSRXMMEASXPARSER_H__
 #define __GNSSRXMMEASXPARSER_H__
 
-#include <vector>
 #include <cstdint>
-#include <list>
-#include <queue>
 
 #include <android/hardware/gnss/1.0/types.h>
 #include <android/hardware/gnss/1.0/IGnssMeasurementCallback.h>
@@ -52,6 +49,13 @@ public:
      */
     uint8_t retrieveSvInfo(MeasurementCb::GnssData& gnssData) final;
 
+    /*!
+     * \brief getEpoch - provide GPS measurement reference time as the epoch
+     * \param iTow - GPS time of week in ms
+     * \return RxmDone if the object is valid, otherwise NotReady
+     */
+    uint8_t getEpoch(uint32_t& iTow) final;
+
 
     /*!
      * \brief dumpDebug - print log in logcat, and write dump to file
@@ -74,18 +78,53 @@ private:
         uint8_t TOWset;
     } singleBlock_t;
 
-    typedef struct RepeatedBlock {
-        uint8_t gnssId;
-        uint8_t svId;
-        uint8_t cn0;
-        uint8_t multipath;
-        int32_t pseudoRangeRate;
-    } repeatedBlock_t;
+    /*!
+     * \brief TowSlot - index of the time of week reported for the constellation,
+     * \brief TowNone is always 0 and selects "TOW unknown"
+     */
+    enum TowSlot : uint8_t {
+        TowNone = 0,
+        TowGps,
+        TowGlonass,
+        TowBds,
+        TowQzss,
+        TowSlotsCount,
+    };
 
+    /*!
+     * \brief GnssIdInfo - per UbxGnssId properties, replaces the per SV switch statements
+     * \brief svid is valid if it belongs to [firstBegin, firstEnd] or [secondBegin, secondEnd],
+     * \brief otherwise it is replaced by secondBegin
+     */
+    typedef struct GnssIdInfo {
+        CnstlType constellation;
+        float carrierFrequencyHz;
+        uint32_t flags;
+        uint32_t towState;
+        uint8_t towSlot;
+        uint8_t firstBegin;
+        uint8_t firstEnd;
+        uint8_t secondBegin;
+        uint8_t secondEnd;
+    } gnssIdInfo_t;
+
+    static const uint8_t mMaxSvsNum = 64;
+    static const uint8_t mGnssIdCount = 8;
+    static const gnssIdInfo_t mGnssIdInfo[mGnssIdCount];
+
+    // Repeated blocks decoded field by field (structure of arrays)
+    uint8_t mGnssIds[mMaxSvsNum] = {};
+    uint8_t mSvIds[mMaxSvsNum] = {};
+    uint8_t mCn0[mMaxSvsNum] = {};
+    uint8_t mMultipath[mMaxSvsNum] = {};
+    int32_t mPseudorangeRate[mMaxSvsNum] = {};
+    uint8_t mSvsCount = 0;
+
+    // TOW and TOW accuracy in ms indexed by TowSlot, all zero if TOW is not set
+    uint32_t mTow[TowSlotsCount] = {};
+    uint16_t mTowAcc[TowSlotsCount] = {};
 
-    std::vector<repeatedBlock_t> data;
     const uint8_t* mPayload;
-    MeasurementState mTOWstate = MeasurementState::STATE_TOW_DECODED;
     singleBlock_t meta = {};
     uint16_t mPayloadLen = 0;
 
@@ -95,6 +134,13 @@ private:
      */
     bool mValid = false;
 
+    /*!
+     * \brief getGnssIdInfo - provide table entry of the constellation
+     * \param gnssId - constellation id of UbxGnssId enum, unknown ids share the last entry
+     * \return reference to the table entry
+     */
+    static const gnssIdInfo_t& getGnssIdInfo(const uint8_t gnssId);
+
 protected:
     enum UbxGnssId : uint8_t {
         GPS = 0,
@@ -119,35 +165,14 @@ protected:
      */
     void parseSingleBlock(const uint8_t* msg);
 
-    /*!
-     * \brief parseRepeatedBlock - parse concrete repeated block from the incoming message
-     * \param msg - a pointer to the beginning of the repeated block
-     */
-    void parseRepeatedBlock(const uint8_t* msg);
-
     /*!
      * \brief parseRepeatedBlocks - parse all repeated blocks from incoming message
+     * \brief each field is gathered for all SVs in its own loop
      * \param msg - a pointer to the beginning of the first repeated block
      * \param msgLen - length of the repeated blocks in bytes
      */
     void parseRepeatedBlocks(const uint8_t* msg, const uint16_t msgLen);
 
-    /*!
-     * \brief getTOWforGnssId - provide corresponding value (TOW) to the concrete constellation from meta private member
-     * \brief set mTOWstate GnssMS::STATE_TOW_KNOWN if requested constellation is GALILEO or SBAS
-     * \brief set mTOWstate GnssMS::STATE_UNKNOWN if requested constellation unknown
-     * \param gnssId - constellation id of UbxGnssId enum
-     * \return time of week (TOW) in ms for concrete constellation, otherwise 0  for unknown gnssId
-     */
-    uint32_t getTOWforGnssId(const uint8_t gnssId);
-
-    /*!
-     * \brief getTOWforGnssId - provide corresponding value (TOWacc)to the concrete constellation from meta private member
-     * \param gnssId - constellation id of UbxGnssId enum
-     * \return TOW accuracy in ns
-     */
-    int64_t getTOWaccForGnssId(const uint8_t gnssId);
-
     /*!
      * \brief getConstellationFromGnssId - convert UbxGnssId to GnssConstellationType
      * \param gnssId - index of constellation in means of UbxGnssId
@@ -163,22 +188,6 @@ protected:
      *         or frequency channel number for GLONASS
      */
     uint8_t getValidSvidForGnssId(const uint8_t gnssId, const uint8_t svid);
-
-    /*!
-     * \brief GnssRxmMeasxParser::getCarrierFrequencyFromGnssId - provide carrier frequency
-     * \brief carrier frequncy depends on setup of flags in ubx-cfg-gnss
-     * \param gnssId - index of constellation in means of UbxGnssId
-     * \return carrier frequency in Hz, 0 if unknown gnssId
-     */
-    float getCarrierFrequencyFromGnssId(const uint8_t gnssId);
-
-    /*!
-     * \brief getGnssMeasurement - provide collected data for each Satellite Vehicle
-     * \param instance - reference to the hidl_array of GnssMeasurement structures
-     * \param block - reference to the repeated block that corresponds to the concrete Satellite Vehicle
-     */
-    void getGnssMeasurement(MeasurementCb::GnssMeasurement& instance,
-                            const repeatedBlock_t& block);
 };
 
 #endif // __GNSSRXMMEASXPARSER_H__
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssHALRxmRawxParser"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <log/log.h>
+#include "GnssRxmRawxParser.h"
+
+typedef MeasurementCb::GnssMeasurementState MeasurementState;
+typedef MeasurementCb::GnssMultipathIndicator MultipathId;
+typedef MeasurementCb::GnssAccumulatedDeltaRangeState AccumulatedDeltaRangeState;
+typedef MeasurementCb::GnssMeasurementFlags MeasurementFlags;
+
+// Using offsets according to the protocol description of UBX-RXM-RAWX
+enum RxmRawxOffsets : uint8_t {
+    //first block offsets
+    rcvTow = 0,
+    week = 8,
+    leapS = 10,
+    numMeas = 11,
+
+    //repeated block offsets
+    prMes = 0,
+    cpMes = 8,
+    doMes = 16,
+    gnssIdOfst = 20,
+    svId = 21,
+    freqId = 23,
+    locktime = 24,
+    cno = 26,
+    prStdev = 27,
+    cpStdev = 28,
+    doStdev = 29,
+    trkStat = 30,
+};
+
+static const uint8_t trkStatPrValid = 0x01;
+static const uint8_t trkStatCpValid = 0x02;
+static const uint8_t stdevMask = 0x0f;
+
+static const double speedOfLight = 299792458.0;
+static const double secToNs = 1e9;
+static const double secondsInWeek = 604800.0;
+static const double secondsInDay = 86400.0;
+static const long long msInWeek = 604800000;
+static const double bdsToGpsOffsetS = 14.0;         // BDT = GPST - 14 s
+static const double glonassToUtcOffsetS = 10800.0;  // GLONASS time = UTC + 3 h
+
+static const double prStdevScale = 0.01;    // m * 2^n
+static const double cpStdevScale = 0.004;   // cycles * n
+static const double doStdevScale = 0.002;   // Hz * 2^n
+
+static const double l1Frequency = 1575.42e6;
+static const double b1Frequency = 1561.098e6;
+static const double glonassL1Frequency = 1602.0e6;
+static const double glonassL1Step = 0.5625e6;
+static const int8_t glonassFreqIdOffset = 7;   // freqId 0-13 is FCN -7..6
+static const int16_t glonassFcnSvidOffset = 100;
+static const uint8_t glonassUnknownSlot = 255;
+
+GnssRxmRawxParser::GnssRxmRawxParser(const uint8_t* payload, uint16_t payloadLen)
+{
+    parseRxmRawxMsg(payload, payloadLen);
+}
+
+void GnssRxmRawxParser::parseRxmRawxMsg(const uint8_t* payload, uint16_t payloadLen)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (nullptr == payload || payloadLen < mHeaderSize) {
+        ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
+        return;
+    }
+
+    const uint8_t numMeas = payload[RxmRawxOffsets::numMeas];
+    if (numMeas > mMaxSvsNum || payloadLen != mHeaderSize + numMeas * mBlockSize) {
+        ALOGV("[%s, line %d] Payload length %u does not match %u measurements", __func__, __LINE__,
+              payloadLen, numMeas);
+        return;
+    }
+
+    // Parser lives in the measurement queue longer than the receive buffer
+    memcpy(mPayload, payload, payloadLen);
+
+    mRcvTow = loadLE<double>(&mPayload[RxmRawxOffsets::rcvTow]);
+    mWeek = loadLE<uint16_t>(&mPayload[RxmRawxOffsets::week]);
+    mLeapS = loadLE<int8_t>(&mPayload[RxmRawxOffsets::leapS]);
+    mNumMeas = numMeas;
+
+    mValid = true;
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+bool GnssRxmRawxParser::getGnssMeasurement(MeasurementCb::GnssMeasurement& instance, const uint8_t* block)
+{
+    const uint8_t gnssId = block[RxmRawxOffsets::gnssIdOfst];
+    const uint8_t svId = block[RxmRawxOffsets::svId];
+    const uint8_t trkStat = block[RxmRawxOffsets::trkStat];
+
+    uint32_t state = static_cast<uint32_t>(MeasurementState::STATE_CODE_LOCK) |
+                     static_cast<uint32_t>(MeasurementState::STATE_BIT_SYNC) |
+                     static_cast<uint32_t>(MeasurementState::STATE_SUBFRAME_SYNC) |
+                     static_cast<uint32_t>(MeasurementState::STATE_TOW_DECODED);
+    double carrierFrequency = l1Frequency;
+    double timeOffsetS = 0.0;
+    double timePeriodS = secondsInWeek;
+
+    instance.svid = static_cast<int16_t>(svId);
+
+    switch (gnssId) {
+    case UbxGnssId::GPS:
+        instance.constellation = CnstlType::GPS;
+        break;
+    case UbxGnssId::SBAS:
+        instance.constellation = CnstlType::SBAS;
+        state = static_cast<uint32_t>(MeasurementState::STATE_CODE_LOCK) |
+                static_cast<uint32_t>(MeasurementState::STATE_SBAS_SYNC) |
+                static_cast<uint32_t>(MeasurementState::STATE_TOW_DECODED);
+        break;
+    case UbxGnssId::GALILEO:
+        instance.constellation = CnstlType::GALILEO;
+        state = static_cast<uint32_t>(MeasurementState::STATE_GAL_E1BC_CODE_LOCK) |
+                static_cast<uint32_t>(MeasurementState::STATE_GAL_E1C_2ND_CODE_LOCK) |
+                static_cast<uint32_t>(MeasurementState::STATE_GAL_E1B_PAGE_SYNC) |
+                static_cast<uint32_t>(MeasurementState::STATE_TOW_DECODED);
+        break;
+    case UbxGnssId::BEIDOU:
+        instance.constellation = CnstlType::BEIDOU;
+        carrierFrequency = b1Frequency;
+        timeOffsetS = -bdsToGpsOffsetS;
+        break;
+    case UbxGnssId::QZSS:
+        instance.constellation = CnstlType::QZSS;
+        break;
+    case UbxGnssId::GLONASS: {
+        const int8_t fcn = static_cast<int8_t>(block[RxmRawxOffsets::freqId] - glonassFreqIdOffset);
+        instance.constellation = CnstlType::GLONASS;
+        if (svId == glonassUnknownSlot) {
+            instance.svid = static_cast<int16_t>(glonassFcnSvidOffset + fcn);
+        }
+        carrierFrequency = glonassL1Frequency + fcn * glonassL1Step;
+        // GLONASS received time is the time of day in GLONASS time scale
+        timeOffsetS = glonassToUtcOffsetS - mLeapS;
+        timePeriodS = secondsInDay;
+        state = static_cast<uint32_t>(MeasurementState::STATE_CODE_LOCK) |
+                static_cast<uint32_t>(MeasurementState::STATE_SYMBOL_SYNC) |
+                static_cast<uint32_t>(MeasurementState::STATE_GLO_STRING_SYNC) |
+                static_cast<uint32_t>(MeasurementState::STATE_GLO_TOD_DECODED);
+        break;
+    }
+    default:
+        return false;
+    }
+
+    const double wavelength = speedOfLight / carrierFrequency;
+
+    instance.flags = static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_FREQUENCY);
+    instance.carrierFrequencyHz = static_cast<float>(carrierFrequency);
+    instance.timeOffsetNs = 0.0;
+    instance.cN0DbHz = static_cast<double>(block[RxmRawxOffsets::cno]);
+    instance.multipathIndicator = MultipathId::INDICATOR_UNKNOWN;
+
+    if (trkStat & trkStatPrValid) {
+        // Transmit time = receive time - time of flight
+        const double prMes = loadLE<double>(&block[RxmRawxOffsets::prMes]);
+        double txTime = std::fmod(mRcvTow - prMes / speedOfLight + timeOffsetS, timePeriodS);
+        if (txTime < 0.0) {
+            txTime += timePeriodS;
+        }
+
+        const double prStdevM = prStdevScale * (1u << (block[RxmRawxOffsets::prStdev] & stdevMask));
+        instance.state = state;
+        instance.receivedSvTimeInNs = llround(txTime * secToNs);
+        instance.receivedSvTimeUncertaintyInNs = std::max<int64_t>(llround(prStdevM / speedOfLight * secToNs), 1);
+    } else {
+        instance.state = static_cast<uint32_t>(MeasurementState::STATE_UNKNOWN);
+        instance.receivedSvTimeInNs = 0;
+        instance.receivedSvTimeUncertaintyInNs = 0;
+    }
+
+    // Doppler is positive for approaching satellites, pseudorange rate is negative
+    const double doMes = static_cast<double>(loadLE<float>(&block[RxmRawxOffsets::doMes]));
+    const double doStdevHz = doStdevScale * (1u << (block[RxmRawxOffsets::doStdev] & stdevMask));
+    instance.pseudorangeRateMps = -doMes * wavelength;
+    instance.pseudorangeRateUncertaintyMps = doStdevHz * wavelength;
+
+    if (trkStat & trkStatCpValid) {
+        const double cpMes = loadLE<double>(&block[RxmRawxOffsets::cpMes]);
+        const double cpStdevCycles = cpStdevScale * (block[RxmRawxOffsets::cpStdev] & stdevMask);
+        const uint16_t locktime = loadLE<uint16_t>(&block[RxmRawxOffsets::locktime]);
+
+        instance.accumulatedDeltaRangeM = cpMes * wavelength;
+        instance.accumulatedDeltaRangeUncertaintyM = cpStdevCycles * wavelength;
+        instance.accumulatedDeltaRangeState = static_cast<uint16_t>(AccumulatedDeltaRangeState::ADR_STATE_VALID);
+        if (locktime == 0) {
+            // Lock time restarts on every loss of lock, the phase ambiguity is new
+            instance.accumulatedDeltaRangeState |= static_cast<uint16_t>(AccumulatedDeltaRangeState::ADR_STATE_RESET);
+        }
+
+        instance.carrierCycles = static_cast<int64_t>(std::floor(cpMes));
+        instance.carrierPhase = cpMes - std::floor(cpMes);
+        instance.carrierPhaseUncertainty = cpStdevCycles;
+        instance.flags |= static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_CYCLES) |
+                          static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_PHASE) |
+                          static_cast<uint32_t>(MeasurementFlags::HAS_CARRIER_PHASE_UNCERTAINTY);
+    } else {
+        instance.accumulatedDeltaRangeM = 0.0;
+        instance.accumulatedDeltaRangeUncertaintyM = 0.0;
+        instance.accumulatedDeltaRangeState = static_cast<uint16_t>(AccumulatedDeltaRangeState::ADR_STATE_UNKNOWN);
+        instance.carrierCycles = 0;
+        instance.carrierPhase = 0.0;
+        instance.carrierPhaseUncertainty = 0.0;
+    }
+
+    return true;
+}
+
+uint8_t GnssRxmRawxParser::getEpoch(uint32_t& iTow)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    if (!mValid) {
+        return NotReady;
+    }
+
+    iTow = static_cast<uint32_t>(llround(mRcvTow * 1000.0) % msInWeek);
+    return RxmDone;
+}
+
+uint8_t GnssRxmRawxParser::retrieveSvInfo(MeasurementCb::GnssData& gnssData)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mValid) {
+        return NotReady;
+    }
+
+    uint32_t measurementCount = 0;
+    const uint8_t* block = &mPayload[mHeaderSize];
+
+    for (uint8_t i = 0; i < mNumMeas; i++, block += mBlockSize) {
+        if (getGnssMeasurement(gnssData.measurements[measurementCount], block)) {
+            ++measurementCount;
+        }
+    }
+
+    gnssData.measurementCount = measurementCount;
+    ALOGV("[%s, line %d] Exit Done", __func__, __LINE__);
+    return RxmDone;
+}
+
+void GnssRxmRawxParser::dumpDebug()
+{
+    ALOGV("[%s, line %d] ", __func__, __LINE__);
+    if (mValid) {
+        hexdump("/data/app/RxmRawxParser_dump", (void*)mPayload, mHeaderSize + mNumMeas * mBlockSize);
+    }
+    ALOGV("[%s, line %d] rcvTow %f, week %u, leapS %d, numMeas %u", __func__, __LINE__,
+          mRcvTow, mWeek, mLeapS, mNumMeas);
+}
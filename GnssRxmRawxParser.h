@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __GNSSRXMRAWXPARSER_H__
+#define __GNSSRXMRAWXPARSER_H__
+
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/types.h>
+#include <android/hardware/gnss/1.0/IGnssMeasurementCallback.h>
+
+#include "GnssParserCommonImpl.h"
+
+/* From u-blox 8 / u-blox M8 Receiver Description - Manual
+ * 32.18.4 UBX-RXM-RAWX (0x02 0x15)
+ * 32.18.4.1 Multi-GNSS Raw Measurement Data
+ * Message: UBX-RXM-RAWX
+ * Description: Multi-GNSS Raw Measurement Data, available on timing and raw data products
+*/
+
+class GnssRxmRawxParser : public GnssParserCommonImpl {
+public:
+    /*!
+     * \brief GnssRxmRawxParser - copy the payload, decoding is done by retrieveSvInfo
+     * \param payload - a pointer to the payload of incoming message
+     * \param payloadLen - length in bytes of payload
+     */
+    GnssRxmRawxParser(const uint8_t* payload, uint16_t payloadLen);
+    ~GnssRxmRawxParser() override {}
+
+    /*!
+     * \brief retrieveSvInfo - decode the measurements straight into the gnssData object
+     * \param gnssData - reference to gnssData object, to be filled
+     * \return RxmDone on success, otherwise NotReady
+     */
+    uint8_t retrieveSvInfo(MeasurementCb::GnssData& gnssData) final;
+
+    /*!
+     * \brief getEpoch - provide receiver time of week rounded to ms as the epoch
+     * \param iTow - GPS time of week in ms
+     * \return RxmDone if the object is valid, otherwise NotReady
+     */
+    uint8_t getEpoch(uint32_t& iTow) final;
+
+    /*!
+     * \brief dumpDebug - print log in logcat, and write dump to file
+     */
+    void dumpDebug() final;
+
+    static const uint16_t mHeaderSize = 16;
+    static const uint16_t mBlockSize = 32;
+    static const uint8_t mMaxSvsNum = 64;
+
+protected:
+    enum UbxGnssId : uint8_t {
+        GPS = 0,
+        SBAS = 1,
+        GALILEO = 2,
+        BEIDOU = 3,
+        QZSS = 5,
+        GLONASS = 6,
+    };
+
+    GnssRxmRawxParser() {}
+
+    /*!
+     * \brief parseRxmRawxMsg - check the header and the length, copy the payload, set validity
+     */
+    void parseRxmRawxMsg(const uint8_t* payload, uint16_t payloadLen);
+
+    /*!
+     * \brief getGnssMeasurement - decode a single repeated block
+     * \param instance - reference to the measurement to be filled
+     * \param block - a pointer to the repeated block
+     * \return true if the measurement is reportable, otherwise false
+     */
+    bool getGnssMeasurement(MeasurementCb::GnssMeasurement& instance, const uint8_t* block);
+
+private:
+    uint8_t mPayload[mHeaderSize + mMaxSvsNum * mBlockSize];
+    double mRcvTow = 0.0;
+    uint16_t mWeek = 0;
+    int8_t mLeapS = 0;
+    uint8_t mNumMeas = 0;
+
+    bool mValid = false;
+};
+
+#endif // __GNSSRXMRAWXPARSER_H__
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHALRxmSfrbxParser"
+#define LOG_NDEBUG 1
+
+#include <log/log.h>
+#include "GnssRxmSfrbxParser.h"
+
+typedef NavigationMessageCb::GnssNavigationMessageType NavMsgType;
+
+// Using offsets according to the protocol description of UBX-RXM-SFRBX
+enum RxmSfrbxOffsets : uint8_t {
+    gnssId = 0,
+    svId = 1,
+    sigId = 2,
+    freqId = 3,
+    numWords = 4,
+    chn = 5,
+    version = 6,
+    dwrd = 8,
+};
+
+static const uint8_t wordSize = 4;
+static const uint8_t bitsPerWord = 32;
+
+static const uint8_t glonassUnknownSlot = 255;
+static const int16_t glonassFcnSvidOffset = 100;
+static const uint8_t glonassFreqIdOffset = 7;
+
+static const int16_t notAvailable = -1;
+static const uint16_t parityPassed =
+    static_cast<uint16_t>(NavigationMessageCb::NavigationMessageStatus::PARITY_PASSED);
+
+/*
+ * Packing rules from IGnssNavigationMessageCallback.hal:
+ *  GPS L1 C/A, BeiDou D1/D2 - 10 words of 30 bits, each fit into the last 30 bits of 4 bytes, 40 bytes
+ *  GLONASS L1 C/A - 85 bits of the string, MSB first, 11 bytes
+ *  Galileo I/NAV - even and odd page parts of 114 bits, MSB first, 29 bytes
+ * u-blox right aligns the 30-bit words of GPS and BeiDou, GLONASS and Galileo are left aligned.
+ */
+const GnssRxmSfrbxParser::NavMsgLayout GnssRxmSfrbxParser::mLayouts[] = {
+    {GPS,     0x01, 10, 0x3FFFFFFF, NavMsgType::GPS_L1CA, 1, {{0, 10 * bitsPerWord}, {0, 0}}},
+    {GLONASS, 0x01, 4,  0xFFFFFFFF, NavMsgType::GLO_L1CA, 1, {{0, 85}, {0, 0}}},
+    {GALILEO, 0x03, 8,  0xFFFFFFFF, NavMsgType::GAL_I,    2, {{0, 114}, {4, 114}}},
+    {BEIDOU,  0x03, 10, 0x3FFFFFFF, NavMsgType::BDS_D1,   1, {{0, 10 * bitsPerWord}, {0, 0}}},
+};
+
+GnssRxmSfrbxParser::GnssRxmSfrbxParser(const uint8_t* payload, uint16_t payloadLen)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (nullptr == payload || payloadLen < mHeaderSize) {
+        ALOGV("[%s, line %d] Payload is not valid", __func__, __LINE__);
+        return;
+    }
+
+    const uint8_t words = payload[RxmSfrbxOffsets::numWords];
+    if (words > mMaxWordsNum || payloadLen != mHeaderSize + words * wordSize) {
+        ALOGV("[%s, line %d] Payload length %u does not match %u words", __func__, __LINE__,
+              payloadLen, words);
+        return;
+    }
+
+    mGnssId = loadLE<uint8_t>(&payload[RxmSfrbxOffsets::gnssId]);
+    mSvId = loadLE<uint8_t>(&payload[RxmSfrbxOffsets::svId]);
+    mSigId = loadLE<uint8_t>(&payload[RxmSfrbxOffsets::sigId]);
+    mFreqId = loadLE<uint8_t>(&payload[RxmSfrbxOffsets::freqId]);
+    mNumWords = words;
+
+    for (uint8_t i = 0; i < mNumWords; i++) {
+        mWords[i] = loadLE<uint32_t>(&payload[RxmSfrbxOffsets::dwrd + i * wordSize]);
+    }
+
+    mValid = true;
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+}
+
+const GnssRxmSfrbxParser::NavMsgLayout* GnssRxmSfrbxParser::findLayout() const
+{
+    for (const auto& layout : mLayouts) {
+        if (layout.gnssId != mGnssId) {
+            continue;
+        }
+
+        if (mSigId >= 8 || !(layout.sigIdMask & (1u << mSigId)) || mNumWords < layout.numWords) {
+            return nullptr;
+        }
+
+        return &layout;
+    }
+
+    return nullptr;
+}
+
+size_t GnssRxmSfrbxParser::getPackedSize(const NavMsgLayout& layout)
+{
+    size_t bits = 0;
+    for (uint8_t i = 0; i < layout.segmentsCount; i++) {
+        bits += layout.segments[i].bits;
+    }
+
+    return (bits + 7) / 8;
+}
+
+size_t GnssRxmSfrbxParser::packWords(const NavMsgLayout& layout, uint8_t* out) const
+{
+    uint64_t acc = 0;
+    uint8_t accBits = 0;
+    size_t written = 0;
+
+    for (uint8_t i = 0; i < layout.segmentsCount; i++) {
+        uint8_t word = layout.segments[i].firstWord;
+        uint16_t remaining = layout.segments[i].bits;
+
+        while (remaining > 0) {
+            const uint8_t take = remaining < bitsPerWord ? static_cast<uint8_t>(remaining) : bitsPerWord;
+            const uint32_t value = (mWords[word++] & layout.wordMask) >> (bitsPerWord - take);
+
+            acc = (acc << take) | value;
+            accBits = static_cast<uint8_t>(accBits + take);
+            remaining = static_cast<uint16_t>(remaining - take);
+
+            while (accBits >= 8) {
+                accBits = static_cast<uint8_t>(accBits - 8);
+                out[written++] = static_cast<uint8_t>(acc >> accBits);
+            }
+        }
+    }
+
+    // Unused trailing bits of the last byte are zero
+    if (accBits > 0) {
+        out[written++] = static_cast<uint8_t>(acc << (8 - accBits));
+    }
+
+    return written;
+}
+
+void GnssRxmSfrbxParser::fillMessageIds(const NavMsgLayout& layout,
+                                        NavigationMessageCb::GnssNavigationMessage &message) const
+{
+    // messageId is the frame (page) the message belongs to, submessageId is the
+    // subframe, string or word type inside of it
+    message.svid = mSvId;
+    message.type = layout.type;
+    message.messageId = notAvailable;
+    message.submessageId = notAvailable;
+
+    switch (layout.gnssId) {
+    case GPS: {
+        // HOW: TOW count in bits 1..17, subframe ID in bits 20..22
+        const uint32_t tow = (mWords[1] >> 13) & 0x1FFFF;
+        const int16_t subframe = static_cast<int16_t>((mWords[1] >> 8) & 0x07);
+        message.submessageId = subframe;
+        if (subframe == 4 || subframe == 5) {
+            // 25 pages of subframes 4 and 5, one page per 30 s frame; TOW count is in 6 s units
+            // and points to the start of the next subframe
+            const uint32_t towCountPerWeek = 100800;
+            const uint32_t frame = ((tow + towCountPerWeek - 1) % towCountPerWeek) / 5;
+            message.messageId = static_cast<int16_t>(frame % 25 + 1);
+        }
+        break;
+    }
+    case GLONASS: {
+        // Bit 85 is the idle chip, bits 84..81 carry the string number
+        message.submessageId = static_cast<int16_t>((mWords[0] >> 27) & 0x0F);
+        // The fourth word carries the superframe number and the frame number in the LSB
+        message.messageId = static_cast<int16_t>(mWords[3] & 0xFF);
+        if (mSvId == glonassUnknownSlot) {
+            message.svid = static_cast<int16_t>(glonassFcnSvidOffset + mFreqId - glonassFreqIdOffset);
+        }
+        break;
+    }
+    case GALILEO: {
+        // Even/odd and page type bits are followed by the 6-bit word type
+        message.submessageId = static_cast<int16_t>((mWords[0] >> 24) & 0x3F);
+        break;
+    }
+    case BEIDOU: {
+        // FraID is in bits 16..18 of the first word, SOW is split between bits 19..26 of
+        // the first word and bits 1..12 of the second one
+        const uint32_t sow = (((mWords[0] >> 4) & 0xFF) << 12) | ((mWords[1] >> 18) & 0xFFF);
+        message.submessageId = static_cast<int16_t>((mWords[0] >> 12) & 0x07);
+        // GEO satellites broadcast D2 with 120 frames of 3 s, the others D1 with 24 frames of 30 s
+        if (mSvId <= 5 || mSvId >= 59) {
+            message.type = NavMsgType::BDS_D2;
+            message.messageId = static_cast<int16_t>((sow / 3) % 120 + 1);
+        } else {
+            message.messageId = static_cast<int16_t>((sow / 30) % 24 + 1);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool GnssRxmSfrbxParser::getNavigationMessage(NavigationMessageCb::GnssNavigationMessage &message)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+
+    if (!mValid) {
+        return false;
+    }
+
+    const NavMsgLayout* layout = findLayout();
+    if (nullptr == layout) {
+        ALOGV("[%s, line %d] gnssId %u sigId %u is not supported", __func__, __LINE__, mGnssId, mSigId);
+        return false;
+    }
+
+    fillMessageIds(*layout, message);
+    message.status = parityPassed;
+
+    message.data.resize(getPackedSize(*layout));
+    packWords(*layout, message.data.data());
+
+    ALOGV("[%s, line %d] Exit", __func__, __LINE__);
+    return true;
+}
+
+uint8_t GnssRxmSfrbxParser::retrieveSvInfo(__attribute__((unused)) MeasurementCb::GnssData &gnssData)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    return NotReady;
+}
+
+void GnssRxmSfrbxParser::dumpDebug()
+{
+    ALOGV("[%s, line %d] ", __func__, __LINE__);
+    if (mValid) {
+        hexdump("/data/app/RxmSfrbxParser_dump", (void*)mWords, mNumWords * sizeof(mWords[0]));
+    }
+    ALOGV("[%s, line %d] gnssId %u, svId %u, sigId %u, freqId %u, numWords %u", __func__, __LINE__,
+          mGnssId, mSvId, mSigId, mFreqId, mNumWords);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSRXMSFRBXPARSER_H__
+#define __GNSSRXMSFRBXPARSER_H__
+
+#include <cstdint>
+
+#include <android/hardware/gnss/1.0/IGnssNavigationMessageCallback.h>
+
+#include "GnssParserCommonImpl.h"
+
+/* From u-blox 8 / u-blox M8 Receiver Description - Manual
+ * 32.18.6 UBX-RXM-SFRBX (0x02 0x13)
+ * 32.18.6.1 Broadcast Navigation Data Subframe
+ * Message: UBX-RXM-SFRBX
+ * Description: Broadcast Navigation Data Subframe
+*/
+
+typedef ::android::hardware::gnss::V1_0::IGnssNavigationMessageCallback NavigationMessageCb;
+
+class GnssRxmSfrbxParser : public GnssParserCommonImpl {
+public:
+    /*!
+     * \brief GnssRxmSfrbxParser - check the header and read the data words
+     * \param payload - a pointer to the payload of incoming message
+     * \param payloadLen - length in bytes of payload
+     */
+    GnssRxmSfrbxParser(const uint8_t* payload, uint16_t payloadLen);
+    ~GnssRxmSfrbxParser() override {}
+
+    /*!
+     * \brief retrieveSvInfo - SFRBX carries no measurement data
+     * \param gnssData - unused
+     * \return NotReady
+     */
+    uint8_t retrieveSvInfo(MeasurementCb::GnssData &gnssData) final;
+
+    /*!
+     * \brief getNavigationMessage - pack the data words as required by the HAL for the constellation
+     * \brief supported are GPS L1 C/A, GLONASS L1OF, Galileo E1 I/NAV and BeiDou B1I D1/D2
+     * \param message - reference to the message object, to be filled
+     * \return true on success, false if the signal is not supported or the payload is not valid
+     */
+    bool getNavigationMessage(NavigationMessageCb::GnssNavigationMessage &message);
+
+    /*!
+     * \brief dumpDebug - print log in logcat, and write dump to file
+     */
+    void dumpDebug() override;
+
+    static const uint16_t mHeaderSize = 8;
+    static const uint8_t mMaxWordsNum = 16;
+
+protected:
+    enum UbxGnssId : uint8_t {
+        GPS = 0,
+        SBAS = 1,
+        GALILEO = 2,
+        BEIDOU = 3,
+        QZSS = 5,
+        GLONASS = 6,
+    };
+
+    /*!
+     * \brief NavMsgSegment - run of bits taken MSB first from consecutive data words
+     */
+    struct NavMsgSegment {
+        uint8_t firstWord;
+        uint16_t bits;
+    };
+
+    /*!
+     * \brief NavMsgLayout - packing rule of one constellation
+     */
+    struct NavMsgLayout {
+        uint8_t gnssId;
+        uint8_t sigIdMask;     // accepted sigId values, bit per value (field is reserved before protocol 27)
+        uint8_t numWords;      // minimal number of data words
+        uint32_t wordMask;     // bits of a data word which belong to the message
+        NavigationMessageCb::GnssNavigationMessageType type;
+        uint8_t segmentsCount;
+        NavMsgSegment segments[2];
+    };
+
+    static const NavMsgLayout mLayouts[];
+
+    GnssRxmSfrbxParser() {}
+
+    /*!
+     * \brief findLayout - provide the packing rule for the received signal
+     * \return a pointer to the table entry, nullptr if the signal is not supported
+     */
+    const NavMsgLayout* findLayout() const;
+
+    /*!
+     * \brief packWords - concatenate the segments of the data words into bytes, MSB first
+     * \param layout - packing rule
+     * \param out - output buffer, at least getPackedSize(layout) bytes
+     * \return number of bytes written
+     */
+    size_t packWords(const NavMsgLayout& layout, uint8_t* out) const;
+
+    /*!
+     * \brief getPackedSize - number of bytes required for the packed message
+     */
+    static size_t getPackedSize(const NavMsgLayout& layout);
+
+    /*!
+     * \brief fillMessageIds - set svid, type, messageId and submessageId from the data words
+     */
+    void fillMessageIds(const NavMsgLayout& layout,
+                        NavigationMessageCb::GnssNavigationMessage &message) const;
+
+private:
+    uint32_t mWords[mMaxWordsNum] = {};
+    uint8_t mGnssId = 0;
+    uint8_t mSvId = 0;
+    uint8_t mSigId = 0;
+    uint8_t mFreqId = 0;
+    uint8_t mNumWords = 0;
+
+    bool mValid = false;
+};
+
+#endif // __GNSSRXMSFRBXPARSER_H__
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSSEQLOCK_H__
+#define __GNSSSEQLOCK_H__
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/*!
+ * \brief GnssSeqlock - single writer snapshot of a trivially copyable value
+ * \brief the writer never blocks, readers retry until they copy the value without
+ * \brief a concurrent store, so a half-updated value is never returned
+ * \brief the value is kept in relaxed atomic words, concurrent copies are not a data race
+ */
+template<typename T>
+class GnssSeqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "GnssSeqlock needs a trivially copyable type");
+
+public:
+    GnssSeqlock()
+    {
+        for (auto& word : mWords) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /*!
+     * \brief store - publish the value, called by the single writer thread only
+     * \param value - new value
+     */
+    void store(const T& value)
+    {
+        uint64_t words[mWordsCount] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const uint32_t sequence = mSequence.load(std::memory_order_relaxed);
+        mSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < mWordsCount; i++) {
+            mWords[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        mSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /*!
+     * \brief load - copy the last published value, may be called from any thread
+     * \param value - output value, not changed if nothing is published yet
+     * \return false if nothing is published yet
+     */
+    bool load(T& value) const
+    {
+        uint64_t words[mWordsCount];
+        uint32_t before;
+        uint32_t after;
+
+        do {
+            before = mSequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                // the writer is in the middle of a store
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t i = 0; i < mWordsCount; i++) {
+                words[i] = mWords[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = mSequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        if (0 == before) {
+            return false;
+        }
+
+        memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /*!
+     * \brief getSequence - provide the number of stores multiplied by two, odd during a store
+     * \return sequence counter
+     */
+    uint32_t getSequence() const { return mSequence.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t mWordsCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> mSequence{0};
+    std::atomic<uint64_t> mWords[mWordsCount];
+};
+
+#endif // __GNSSSEQLOCK_H__
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasSvTable"
+#define LOG_NDEBUG 1
+
+#include <algorithm>
+#include <cstring>
+#include <log/log.h>
+
+#include "GnssSvTable.h"
+
+static const uint8_t usedInFixFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
+
+GnssSvTable::GnssSvTable()
+{
+    ALOGV("[%s, line %d] Constructor", __func__, __LINE__);
+    memset(mSv, 0, sizeof(mSv));
+    memset(mSource, 0, sizeof(mSource));
+    clear();
+}
+
+bool GnssSvTable::getSlot(GnssConstellationType constellation, int16_t svid, size_t& slot)
+{
+    const size_t cnst = static_cast<size_t>(constellation);
+
+    if (svid < 0 || static_cast<size_t>(svid) >= mSvidsPerConstellation ||
+            cnst >= mConstellationsCount) {
+        return false;
+    }
+
+    slot = cnst * mSvidsPerConstellation + static_cast<size_t>(svid);
+    return true;
+}
+
+bool GnssSvTable::update(const IGnssCallback::GnssSvInfo& sv, uint8_t source)
+{
+    size_t slot;
+    if (!getSlot(sv.constellation, sv.svid, slot)) {
+        ALOGW("[%s, line %d] svid %d is out of range", __func__, __LINE__, sv.svid);
+        return false;
+    }
+
+    mSv[slot] = sv;
+    mSv[slot].svFlag &= static_cast<uint8_t>(~usedInFixFlag);
+    mSource[slot] = source;
+    mVisible[slot / mBitsPerWord] |= (1ull << (slot % mBitsPerWord));
+
+    return true;
+}
+
+void GnssSvTable::clearSource(uint8_t source)
+{
+    for (size_t word = 0; word < mWordsCount; word++) {
+        uint64_t bits = mVisible[word];
+        while (bits) {
+            const size_t bit = static_cast<size_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+
+            if (mSource[word * mBitsPerWord + bit] == source) {
+                mVisible[word] &= ~(1ull << bit);
+            }
+        }
+    }
+}
+
+void GnssSvTable::setUsedInFix(GnssConstellationType constellation, int16_t svid)
+{
+    size_t slot;
+    if (getSlot(constellation, svid, slot)) {
+        mUsedInFix[slot / mBitsPerWord] |= (1ull << (slot % mBitsPerWord));
+    }
+}
+
+void GnssSvTable::clearUsedInFix(uint8_t constellationMask)
+{
+    const size_t wordsPerConstellation = mSvidsPerConstellation / mBitsPerWord;
+
+    for (size_t cnst = 0; cnst < mConstellationsCount; cnst++) {
+        if (constellationMask & (1u << cnst)) {
+            memset(&mUsedInFix[cnst * wordsPerConstellation], 0,
+                   wordsPerConstellation * sizeof(mUsedInFix[0]));
+        }
+    }
+}
+
+void GnssSvTable::clear()
+{
+    memset(mVisible, 0, sizeof(mVisible));
+    memset(mUsedInFix, 0, sizeof(mUsedInFix));
+}
+
+size_t GnssSvTable::getVisibleCount() const
+{
+    size_t count = 0;
+    for (size_t word = 0; word < mWordsCount; word++) {
+        count += static_cast<size_t>(__builtin_popcountll(mVisible[word]));
+    }
+
+    return count;
+}
+
+size_t GnssSvTable::fillSvStatus(IGnssCallback::GnssSvStatus& status)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    const size_t maxSvs = static_cast<size_t>(GnssMax::SVS_COUNT);
+    size_t candidates = 0;
+
+    for (size_t word = 0; word < mWordsCount; word++) {
+        uint64_t bits = mVisible[word];
+        while (bits) {
+            const size_t bit = static_cast<size_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+            mCandidates[candidates++] = static_cast<uint16_t>(word * mBitsPerWord + bit);
+        }
+    }
+
+    if (candidates > maxSvs) {
+        ALOGV("[%s, line %d] %zu SVs visible, keep the strongest %zu", __func__, __LINE__,
+              candidates, maxSvs);
+
+        std::nth_element(mCandidates, mCandidates + maxSvs, mCandidates + candidates,
+                         [this](uint16_t a, uint16_t b) {
+                             return mSv[a].cN0Dbhz > mSv[b].cN0Dbhz;
+                         });
+        std::sort(mCandidates, mCandidates + maxSvs);
+        candidates = maxSvs;
+    }
+
+    for (size_t i = 0; i < candidates; i++) {
+        const size_t slot = mCandidates[i];
+        IGnssCallback::GnssSvInfo& sv = status.gnssSvList[i];
+
+        sv = mSv[slot];
+        if (mUsedInFix[slot / mBitsPerWord] & (1ull << (slot % mBitsPerWord))) {
+            sv.svFlag |= usedInFixFlag;
+        }
+    }
+
+    status.numSvs = static_cast<uint32_t>(candidates);
+
+    return candidates;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSSVTABLE_H__
+#define __GNSSSVTABLE_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include <android/hardware/gnss/1.0/IGnssCallback.h>
+
+using namespace android::hardware::gnss::V1_0;
+
+/*!
+ * \brief GnssSvTable - preallocated satellite table indexed by (constellation, svid)
+ * \brief visibility and used-in-fix are tracked as bitmaps over the table slots,
+ * \brief the callback list is assembled by walking the visibility bitmap
+ */
+class GnssSvTable
+{
+public:
+    GnssSvTable();
+    ~GnssSvTable() {}
+
+    /*!
+     * \brief update - store SV record in its slot and mark it as visible
+     * \param sv - SV record, constellation and svid select the slot
+     * \param source - identifier of the reporter (e.g. NMEA talker), used by clearSource
+     * \return true if the record was stored, false if svid is out of table range
+     */
+    bool update(const IGnssCallback::GnssSvInfo& sv, uint8_t source);
+
+    /*!
+     * \brief clearSource - mark all SVs previously reported by the source as not visible
+     * \param source - identifier of the reporter
+     */
+    void clearSource(uint8_t source);
+
+    /*!
+     * \brief setUsedInFix - mark SV as used in the position fix
+     * \param constellation - constellation of the SV
+     * \param svid - android svid of the SV
+     */
+    void setUsedInFix(GnssConstellationType constellation, int16_t svid);
+
+    /*!
+     * \brief clearUsedInFix - drop used-in-fix marks of the selected constellations
+     * \param constellationMask - bit set of constellationBit() values
+     */
+    void clearUsedInFix(uint8_t constellationMask);
+
+    /*!
+     * \brief clear - drop all visible SVs and used-in-fix marks
+     */
+    void clear();
+
+    /*!
+     * \brief getVisibleCount - provide the number of visible SVs in the table
+     * \return number of visible SVs
+     */
+    size_t getVisibleCount() const;
+
+    /*!
+     * \brief fillSvStatus - assemble the callback list from the visible SVs
+     * \brief if more than GnssMax::SVS_COUNT SVs are visible the strongest by C/N0 are chosen
+     * \param status - output structure
+     * \return number of SVs written to status
+     */
+    size_t fillSvStatus(IGnssCallback::GnssSvStatus& status);
+
+    /*!
+     * \brief constellationBit - provide the mask bit of the constellation
+     * \param constellation - constellation type
+     * \return mask bit for clearUsedInFix
+     */
+    static uint8_t constellationBit(GnssConstellationType constellation)
+    {
+        return static_cast<uint8_t>(1u << static_cast<uint8_t>(constellation));
+    }
+
+private:
+    static const size_t mConstellationsCount = 8;
+    static const size_t mSvidsPerConstellation = 256;
+    static const size_t mSlotsCount = mConstellationsCount * mSvidsPerConstellation;
+    static const size_t mBitsPerWord = 64;
+    static const size_t mWordsCount = mSlotsCount / mBitsPerWord;
+
+    static bool getSlot(GnssConstellationType constellation, int16_t svid, size_t& slot);
+
+    IGnssCallback::GnssSvInfo mSv[mSlotsCount];
+    uint8_t  mSource[mSlotsCount];
+    uint64_t mVisible[mWordsCount];
+    uint64_t mUsedInFix[mWordsCount];
+    uint16_t mCandidates[mSlotsCount];
+};
+
+#endif // __GNSSSVTABLE_H__
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssRenesasThreadPolicy"
+#define LOG_NDEBUG 1
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+
+#include <log/log.h>
+#include <cutils/properties.h>
+
+#include "GnssThreadPolicy.h"
+
+static const int32_t minNice = -20;
+static const int32_t maxNice = 19;
+static const size_t maxCpus = 64;
+// property names longer than the legacy PROPERTY_KEY_MAX are accepted since Android O
+static const size_t propertyKeySize = 64;
+
+bool GnssThreadPolicy::sMemoryLocked = false;
+
+const char* GnssThreadPolicy::getRoleName(Role role)
+{
+    switch (role) {
+    case Role::Ingest: return "ingest";
+    case Role::Parse: return "parse";
+    case Role::Callback: return "callback";
+    case Role::Binder: return "binder";
+    default: return "unknown";
+    }
+}
+
+GnssThreadPolicy::Policy GnssThreadPolicy::parsePolicy(const char* sched, int32_t priority,
+                                                       int32_t nice, const char* cpus)
+{
+    Policy policy;
+
+    policy.fifo = (0 == strcmp(sched, "fifo"));
+    if (policy.fifo) {
+        policy.priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO),
+                                     sched_get_priority_max(SCHED_FIFO));
+    }
+
+    if (nice != INT32_MIN) {
+        policy.hasNice = true;
+        policy.nice = std::clamp(nice, minNice, maxNice);
+    }
+
+    if (cpus[0] != '\0') {
+        char* end = nullptr;
+        const unsigned long long mask = strtoull(cpus, &end, 0);
+        if (end != cpus && *end == '\0') {
+            policy.cpuMask = static_cast<uint64_t>(mask);
+        } else {
+            ALOGW("[%s, line %d] Invalid CPU mask %s", __func__, __LINE__, cpus);
+        }
+    }
+
+    return policy;
+}
+
+GnssThreadPolicy::Policy GnssThreadPolicy::readPolicy(Role role)
+{
+    const char* roleName = getRoleName(role);
+    char key[propertyKeySize] = {};
+    char sched[PROPERTY_VALUE_MAX] = {};
+    char cpus[PROPERTY_VALUE_MAX] = {};
+
+    snprintf(key, sizeof(key), "ro.boot.gps.thread.%s.sched", roleName);
+    property_get(key, sched, "other");
+    snprintf(key, sizeof(key), "ro.boot.gps.thread.%s.priority", roleName);
+    const int32_t priority = property_get_int32(key, 0);
+    snprintf(key, sizeof(key), "ro.boot.gps.thread.%s.nice", roleName);
+    const int32_t nice = property_get_int32(key, INT32_MIN);
+    snprintf(key, sizeof(key), "ro.boot.gps.thread.%s.cpus", roleName);
+    property_get(key, cpus, "");
+
+    return parsePolicy(sched, priority, nice, cpus);
+}
+
+bool GnssThreadPolicy::apply(Role role, const char* name)
+{
+    ALOGV("[%s, line %d] Entry", __func__, __LINE__);
+    const Policy policy = readPolicy(role);
+    bool applied = true;
+
+    pthread_setname_np(pthread_self(), name);
+
+    // scheduling class and affinity are always set, a thread created by a FIFO
+    // or pinned thread would inherit its attributes otherwise
+    struct sched_param param = {};
+    param.sched_priority = policy.fifo ? policy.priority : 0;
+    const int ret = pthread_setschedparam(pthread_self(), policy.fifo ? SCHED_FIFO : SCHED_OTHER, &param);
+    if (ret != 0) {
+        ALOGE("[%s, line %d] %s: unable to set %s %d: %s", __func__, __LINE__, name,
+              policy.fifo ? "SCHED_FIFO" : "SCHED_OTHER", param.sched_priority, strerror(ret));
+        applied = false;
+    }
+
+    // nice level is per thread on Linux
+    if (policy.hasNice && setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), policy.nice) < 0) {
+        ALOGE("[%s, line %d] %s: unable to set nice %d: %s", __func__, __LINE__,
+              name, policy.nice, strerror(errno));
+        applied = false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (policy.cpuMask != 0) {
+        for (size_t cpu = 0; cpu < maxCpus; cpu++) {
+            if (policy.cpuMask & (1ull << cpu)) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+    } else {
+        // the kernel restricts the mask to the CPUs of the cpuset
+        const long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        for (long cpu = 0; cpu < cpus && cpu < CPU_SETSIZE; cpu++) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) < 0) {
+        ALOGE("[%s, line %d] %s: unable to set CPU mask 0x%" PRIx64 ": %s", __func__, __LINE__,
+              name, policy.cpuMask, strerror(errno));
+        applied = false;
+    }
+
+    if (sMemoryLocked) {
+        prefaultStack();
+    }
+
+    ALOGI("Thread %s (%s): %s %d, nice %s%d, CPU mask 0x%" PRIx64 "%s", name, getRoleName(role),
+          policy.fifo ? "SCHED_FIFO" : "SCHED_OTHER", param.sched_priority,
+          policy.hasNice ? "" : "inherited ",
+          policy.hasNice ? policy.nice : getpriority(PRIO_PROCESS, static_cast<id_t>(gettid())),
+          policy.cpuMask, applied ? "" : ", not applied");
+
+    return applied;
+}
+
+bool GnssThreadPolicy::lockMemory()
+{
+    if (!property_get_bool("ro.boot.gps.mlock", false)) {
+        return false;
+    }
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+        ALOGE("[%s, line %d] Unable to lock memory: %s", __func__, __LINE__, strerror(errno));
+        return false;
+    }
+
+    sMemoryLocked = true;
+    ALOGI("Memory is locked");
+    prefaultStack();
+    return true;
+}
+
+void GnssThreadPolicy::prefaultStack()
+{
+    // stack pages below the current frame are not covered by MCL_CURRENT
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile uint8_t stack[mStackPrefaultSize];
+
+    for (size_t offset = 0; offset < sizeof(stack); offset += pageSize) {
+        stack[offset] = 0;
+    }
+}
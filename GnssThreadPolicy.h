@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSTHREADPOLICY_H__
+#define __GNSSTHREADPOLICY_H__
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * \brief GnssThreadPolicy - scheduling, nice level and CPU affinity of the HAL threads
+ * \brief every thread applies the policy of its role on start, the policy of the role is
+ * \brief read from ro.boot.gps.thread.<role>.{sched,priority,nice,cpus}, e.g.
+ * \brief ro.boot.gps.thread.ingest.sched=fifo, ro.boot.gps.thread.ingest.priority=10,
+ * \brief ro.boot.gps.thread.parse.cpus=0x0c, unset properties select SCHED_OTHER on all CPUs,
+ * \brief the attributes of the creating thread are never inherited except the nice level
+ */
+class GnssThreadPolicy
+{
+public:
+    enum class Role : uint8_t {
+        Ingest = 0, // TTY reader, reactor and receiver init
+        Parse,      // NMEA and UBX parsers
+        Callback,   // framework callback delivery
+        Binder,     // HIDL RPC thread
+        RolesCount,
+    };
+
+    struct Policy {
+        bool     fifo = false;
+        int32_t  priority = 0;    // SCHED_FIFO priority
+        bool     hasNice = false;
+        int32_t  nice = 0;        // SCHED_OTHER nice level
+        uint64_t cpuMask = 0;     // 0 for all online CPUs
+    };
+
+    /*!
+     * \brief parsePolicy - validate the policy values, out of range values are clamped
+     * \param sched - "fifo" or "other", anything else is "other"
+     * \param priority - SCHED_FIFO priority
+     * \param nice - nice level, INT32_MIN keeps the inherited one
+     * \param cpus - affinity mask, e.g. "0x3", empty for all online CPUs
+     * \return policy to apply
+     */
+    static Policy parsePolicy(const char* sched, int32_t priority, int32_t nice, const char* cpus);
+
+    /*!
+     * \brief readPolicy - read the policy of the role from the system properties
+     * \param role - thread role
+     * \return policy to apply
+     */
+    static Policy readPolicy(Role role);
+
+    /*!
+     * \brief apply - name the calling thread and apply the policy of its role, report it
+     * \param role - thread role
+     * \param name - thread name, at most 15 characters
+     * \return true if all attributes were applied
+     */
+    static bool apply(Role role, const char* name);
+
+    /*!
+     * \brief lockMemory - lock current and future pages if ro.boot.gps.mlock is set,
+     * \brief buffers are faulted in when mapped, so parsing never waits for a page fault
+     * \return true if memory is locked
+     */
+    static bool lockMemory();
+
+private:
+    static constexpr size_t mStackPrefaultSize = 64 * 1024;
+
+    static const char* getRoleName(Role role);
+
+    /*!
+     * \brief prefaultStack - touch the stack pages the thread is going to use, so they
+     * \brief are locked and resident before the first message is parsed
+     */
+    static void prefaultStack();
+
+    static bool sMemoryLocked;
+};
+
+#endif // __GNSSTHREADPOLICY_H__
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GNSSUBXREGISTRY_H__
+#define __GNSSUBXREGISTRY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+/*!
+ * \brief UbxField - description of a single field of UBX message payload
+ * \param T - type of the field as defined by the protocol description
+ * \param Offset - offset in bytes from the beginning of the block
+ * \param Scale - ratio to convert the raw value to the unit used by the HAL
+ */
+template <typename T, uint16_t Offset, typename Scale = std::ratio<1>>
+struct UbxField {
+    typedef T type;
+    static constexpr uint16_t offset = Offset;
+    static constexpr uint16_t end = Offset + sizeof(T);
+    static constexpr double scale = static_cast<double>(Scale::num) / static_cast<double>(Scale::den);
+};
+
+/*!
+ * \brief UbxSchema - fixed size block of UBX message payload built from fields
+ * \brief every field is checked at compile time to lie inside the block,
+ * \brief so the loads after a single length check need no bounds checks
+ * \param BlockSize - size in bytes of the block
+ * \param Fields - UbxField types of the block
+ */
+template <uint16_t BlockSize, typename... Fields>
+struct UbxSchema {
+    static constexpr uint16_t blockSize = BlockSize;
+    static_assert(((Fields::end <= BlockSize) && ...), "UBX field is out of the block");
+
+    /*!
+     * \brief has - check that the field is described by this schema
+     */
+    template <typename Field>
+    static constexpr bool has()
+    {
+        return (std::is_same<Field, Fields>::value || ...);
+    }
+};
+
+/*!
+ * \brief ubxRegistryError - not constexpr on purpose, reaching it in a constant expression fails the build
+ */
+inline void ubxRegistryError(const char*) {}
+
+/*!
+ * \brief UbxMessageEntry - registry entry, route is a dispatcher defined handler index
+ */
+struct UbxMessageEntry {
+    uint8_t msgClass;
+    uint8_t msgId;
+    uint8_t route;
+};
+
+/*!
+ * \brief UbxDispatchTable - maps 16-bit (class << 8 | id) key to the route in constant time
+ * \brief the first level maps the class to a slot, the second level maps the id inside the slot;
+ * \brief the table is built at compile time, duplicates and too many classes fail the build
+ * \param ClassSlots - number of distinct message classes in the registry
+ */
+template <size_t ClassSlots>
+class UbxDispatchTable
+{
+public:
+    static constexpr uint8_t unknownRoute = 0;
+
+    template <size_t N>
+    constexpr explicit UbxDispatchTable(const UbxMessageEntry (&entries)[N]) :
+        mClassSlot(),
+        mRoute()
+    {
+        uint8_t slots = 0;
+        for (size_t i = 0; i < N; i++) {
+            const UbxMessageEntry& entry = entries[i];
+            if (0 == mClassSlot[entry.msgClass]) {
+                if (slots == ClassSlots) {
+                    ubxRegistryError("UBX registry has more classes than slots");
+                    return;
+                }
+                mClassSlot[entry.msgClass] = ++slots;
+            }
+
+            uint8_t& route = mRoute[mClassSlot[entry.msgClass] - 1][entry.msgId];
+            if (unknownRoute != route || unknownRoute == entry.route) {
+                ubxRegistryError("UBX registry entry is duplicated or has no route");
+                return;
+            }
+            route = entry.route;
+        }
+    }
+
+    static constexpr uint16_t key(uint8_t msgClass, uint8_t msgId)
+    {
+        return static_cast<uint16_t>(msgClass << 8 | msgId);
+    }
+
+    /*!
+     * \brief find - provide the route of the message
+     * \param key - (class << 8 | id) of the message
+     * \return route of the message, unknownRoute if the message is not registered
+     */
+    constexpr uint8_t find(uint16_t key) const
+    {
+        const uint8_t slot = mClassSlot[key >> 8];
+        return (0 == slot) ? unknownRoute : mRoute[slot - 1][key & 0xFF];
+    }
+
+private:
+    uint8_t mClassSlot[256];
+    uint8_t mRoute[ClassSlots][256];
+};
+
+#endif // __GNSSUBXREGISTRY_H__
@@ -1,3 +1,6 @@
+#ifndef __CIRCULAR_BUFFER_H__
+#define __CIRCULAR_BUFFER_H__
+
 #include <cstdio>
 
 #include <memory>
@@ -76,3 +79,5 @@ private:
     size_t size_;
     size_t element_size_;
 };
+
+#endif // __CIRCULAR_BUFFER_H__
@@ -7,12 +7,16 @@
 #include <hidl/HidlTransportSupport.h>
 
 #include "Gnss.h"
+#include "GnssThreadPolicy.h"
 
 using namespace android::hardware;
 using namespace android::hardware::gnss::V1_0;
 
 int main(void) {
     android::ProcessState::initWithDriver("/dev/vndbinder");
+    // before the HAL objects and their buffers are allocated
+    GnssThreadPolicy::lockMemory();
+
     android::sp<IGnss> gnss_hal = new renesas::Gnss();
 
     configureRpcThreadpool(1, true);
@@ -20,5 +24,7 @@ int main(void) {
     auto status = gnss_hal->registerAsService();
     CHECK_EQ(status, android::OK) << "Failed to register GNSS HAL";
 
+    // the caller joins the pool as its only thread
+    GnssThreadPolicy::apply(GnssThreadPolicy::Role::Binder, "gnss_binder");
     joinRpcThreadpool();
 }
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssDebug.h"
+
+using namespace android::hardware::gnss::V1_0::renesas;
+
+class SnapshotHw : public GnssHwIface {
+public:
+    bool start(void) override { return true; }
+    bool stop(void) override { return true; }
+    void GnssHwHandleThread(void) override {}
+    bool setUpdatePeriod(int) override { return true; }
+    uint16_t GetYearOfHardware() override { return 0; }
+
+    void publishLocation(const GnssLocation& location) { mLocationSnapshot.store(location); }
+    void publishSvStatus(const IGnssCallback::GnssSvStatus& svStatus) { mSvStatusSnapshot.store(svStatus); }
+};
+
+static IGnssDebug::DebugData getDebugData(const android::sp<GnssDebug>& debug)
+{
+    IGnssDebug::DebugData result = {};
+    debug->getDebugData([&result](const IGnssDebug::DebugData& data) { result = data; });
+    return result;
+}
+
+TEST(GnssDebugTest, noSnapshotPositionIsInvalid)
+{
+    android::sp<SnapshotHw> hw = new SnapshotHw();
+    android::sp<GnssDebug> debug = new GnssDebug(hw);
+
+    const IGnssDebug::DebugData data = getDebugData(debug);
+
+    EXPECT_FALSE(data.position.valid);
+    EXPECT_EQ((size_t)0, data.satelliteDataArray.size());
+    EXPECT_LT(0, data.time.timeEstimate);
+}
+
+TEST(GnssDebugTest, snapshotsAreReported)
+{
+    android::sp<SnapshotHw> hw = new SnapshotHw();
+    android::sp<GnssDebug> debug = new GnssDebug(hw);
+
+    GnssLocation location = {};
+    location.gnssLocationFlags = static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
+    location.latitudeDegrees = 47.285;
+    location.longitudeDegrees = 8.565;
+    location.timestamp = getDebugData(debug).time.timeEstimate;
+    hw->publishLocation(location);
+
+    IGnssCallback::GnssSvStatus svStatus = {};
+    svStatus.numSvs = 2;
+    svStatus.gnssSvList[0].svid = 5;
+    svStatus.gnssSvList[0].constellation = GnssConstellationType::GPS;
+    svStatus.gnssSvList[0].svFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA);
+    svStatus.gnssSvList[1].svid = 12;
+    svStatus.gnssSvList[1].constellation = GnssConstellationType::GLONASS;
+    hw->publishSvStatus(svStatus);
+
+    const IGnssDebug::DebugData data = getDebugData(debug);
+
+    EXPECT_TRUE(data.position.valid);
+    EXPECT_EQ(47.285, data.position.latitudeDegrees);
+    EXPECT_EQ(8.565, data.position.longitudeDegrees);
+    EXPECT_LE(0.0f, data.position.ageSeconds);
+    EXPECT_GT(60.0f, data.position.ageSeconds);
+
+    ASSERT_EQ((size_t)2, data.satelliteDataArray.size());
+    EXPECT_EQ(5, data.satelliteDataArray[0].svid);
+    EXPECT_EQ(IGnssDebug::SatelliteEphemerisType::EPHEMERIS, data.satelliteDataArray[0].ephemerisType);
+    EXPECT_EQ(12, data.satelliteDataArray[1].svid);
+    EXPECT_EQ(GnssConstellationType::GLONASS, data.satelliteDataArray[1].constellation);
+    EXPECT_EQ(IGnssDebug::SatelliteEphemerisType::NOT_AVAILABLE, data.satelliteDataArray[1].ephemerisType);
+}
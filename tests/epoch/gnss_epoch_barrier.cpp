@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include <chrono>
+#include <thread>
+
+#include "GnssEpochBarrier.h"
+
+typedef GnssEpochBarrier::Lane Lane;
+typedef GnssEpochBarrier::Policy Policy;
+
+static const int64_t epochKey = 43200000;
+static const std::chrono::milliseconds shortDelay(20);
+static const std::chrono::milliseconds longDelay(2000);
+
+class GnssEpochBarrierTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        mBarrier.setPolicy(Policy::MEAS_FIRST);
+        mBarrier.setMaxDelay(shortDelay);
+        mBarrier.setLaneActive(Lane::Measurement, true);
+        mBarrier.setLaneActive(Lane::Location, true);
+    }
+
+    void TearDown() override
+    {
+        mBarrier.setLaneActive(Lane::Measurement, false);
+        mBarrier.setLaneActive(Lane::Location, false);
+        mBarrier.setPolicy(Policy::MEAS_FIRST);
+        mBarrier.setMaxDelay(std::chrono::milliseconds(250));
+    }
+
+    GnssEpochBarrier& mBarrier = GnssEpochBarrier::getInstance();
+};
+
+TEST_F(GnssEpochBarrierTest, keysOfLocationAndMeasurementMatch)
+{
+    // 2019-01-06 12:00:00 UTC is Sunday, GPS iTOW is 12:00:18
+    const int64_t utcMs = 1546776000000;
+    const uint32_t iTowMs = 43218000;
+
+    EXPECT_EQ(epochKey, GnssEpochBarrier::keyFromUtcMs(utcMs));
+    EXPECT_EQ(epochKey, GnssEpochBarrier::keyFromGpsTow(iTowMs, 18));
+    EXPECT_EQ(GnssEpochBarrier::mMsInDay - 18000, GnssEpochBarrier::keyFromGpsTow(0, 18));
+}
+
+TEST_F(GnssEpochBarrierTest, independentPolicyNeverHolds)
+{
+    mBarrier.setPolicy(Policy::INDEPENDENT);
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Location, epochKey));
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Measurement, epochKey));
+
+    const GnssEpochBarrier::Stats after = mBarrier.getStats();
+    EXPECT_EQ(before.inOrder, after.inOrder);
+    EXPECT_EQ(before.late, after.late);
+    EXPECT_EQ(before.dropped, after.dropped);
+}
+
+TEST_F(GnssEpochBarrierTest, locationDroppedBeforeFirstMeasurement)
+{
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Measurement, epochKey));
+    EXPECT_FALSE(mBarrier.waitTurn(Lane::Location, epochKey));
+    EXPECT_EQ(before.dropped + 1, mBarrier.getStats().dropped);
+}
+
+TEST_F(GnssEpochBarrierTest, locationReleasedByMeasurementOfSameEpoch)
+{
+    mBarrier.setMaxDelay(longDelay);
+    mBarrier.release(Lane::Measurement, epochKey - 1000);
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    std::thread measurement([this] {
+        std::this_thread::sleep_for(shortDelay);
+        mBarrier.release(Lane::Measurement, epochKey);
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Location, epochKey));
+    const auto waited = std::chrono::steady_clock::now() - start;
+    measurement.join();
+
+    EXPECT_LT(waited, longDelay);
+    EXPECT_EQ(before.inOrder + 1, mBarrier.getStats().inOrder);
+    EXPECT_EQ(before.late, mBarrier.getStats().late);
+}
+
+TEST_F(GnssEpochBarrierTest, locationReleasedLateAfterMaxDelay)
+{
+    mBarrier.release(Lane::Measurement, epochKey - 1000);
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Location, epochKey));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, shortDelay);
+
+    EXPECT_EQ(before.late + 1, mBarrier.getStats().late);
+}
+
+TEST_F(GnssEpochBarrierTest, measurementAcrossDayRolloverReleasesLocation)
+{
+    mBarrier.release(Lane::Measurement, 500);
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Location, GnssEpochBarrier::mMsInDay - 500));
+    EXPECT_EQ(before.inOrder + 1, mBarrier.getStats().inOrder);
+}
+
+TEST_F(GnssEpochBarrierTest, inactiveMeasurementLaneDoesNotHoldLocation)
+{
+    mBarrier.setLaneActive(Lane::Measurement, false);
+    const GnssEpochBarrier::Stats before = mBarrier.getStats();
+
+    EXPECT_TRUE(mBarrier.waitTurn(Lane::Location, epochKey));
+    EXPECT_EQ(before.dropped, mBarrier.getStats().dropped);
+    EXPECT_EQ(before.late, mBarrier.getStats().late);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssEpochTracker.h"
+
+static const int64_t deadlineMs = 800;
+static const uint32_t partGps = 0x01;
+static const uint32_t partGlonass = 0x02;
+
+TEST(GnssEpochTrackerTest, firstEpochIsNeverComplete)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    EXPECT_TRUE(epoch.isNewEpoch(100));
+    epoch.open(100);
+    epoch.addPart(partGps, 0);
+
+    EXPECT_TRUE(epoch.isPending());
+    EXPECT_FALSE(epoch.isComplete());
+}
+
+TEST(GnssEpochTrackerTest, expectedPartsLearnedFromPreviousEpoch)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    epoch.open(100);
+    epoch.addPart(partGps, 0);
+    epoch.addPart(partGlonass, 10);
+    epoch.close();
+
+    EXPECT_FALSE(epoch.isNewEpoch(100));
+    EXPECT_TRUE(epoch.isNewEpoch(200));
+    epoch.open(200);
+    EXPECT_EQ(partGps | partGlonass, epoch.getExpected());
+
+    epoch.addPart(partGps, 1000);
+    EXPECT_FALSE(epoch.isComplete());
+    epoch.addPart(partGlonass, 1010);
+    EXPECT_TRUE(epoch.isComplete());
+
+    epoch.close();
+    EXPECT_FALSE(epoch.isPending());
+}
+
+TEST(GnssEpochTrackerTest, unknownTagIsNotNewEpoch)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    EXPECT_FALSE(epoch.isNewEpoch(-1));
+}
+
+TEST(GnssEpochTrackerTest, deadlineFromFirstPart)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    EXPECT_EQ(-1, epoch.getRemainingMs(0));
+    EXPECT_FALSE(epoch.isExpired(10000));
+
+    epoch.addPart(partGps, 1000);
+    EXPECT_EQ(deadlineMs, epoch.getRemainingMs(1000));
+    EXPECT_FALSE(epoch.isExpired(1000 + deadlineMs - 1));
+    EXPECT_TRUE(epoch.isExpired(1000 + deadlineMs));
+    EXPECT_EQ(0, epoch.getRemainingMs(1000 + deadlineMs + 5));
+}
+
+TEST(GnssEpochTrackerTest, hasPartKeepsLatePartsAfterClose)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    epoch.open(100);
+    epoch.addPart(partGps, 0);
+    epoch.close();
+
+    EXPECT_TRUE(epoch.hasPart(partGps));
+    EXPECT_FALSE(epoch.hasPart(partGlonass));
+
+    epoch.addPart(partGlonass, 900);
+    epoch.open(200);
+    EXPECT_EQ(partGps | partGlonass, epoch.getExpected());
+    EXPECT_FALSE(epoch.hasPart(partGps));
+}
+
+TEST(GnssEpochTrackerTest, latePartAfterPublishIsNotPublishedAgain)
+{
+    GnssEpochTracker epoch(deadlineMs);
+
+    epoch.open(100);
+    epoch.addPart(partGps, 0);
+    epoch.close();
+    epoch.open(200);
+
+    // complete with the expected talker only and published
+    epoch.addPart(partGps, 1000);
+    EXPECT_TRUE(epoch.isComplete());
+    epoch.close();
+
+    epoch.addPart(partGlonass, 1900);
+    EXPECT_FALSE(epoch.isComplete());
+    EXPECT_FALSE(epoch.isPending());
+    EXPECT_FALSE(epoch.isExpired(1000 + 2 * deadlineMs));
+
+    // the late part is expected from the next epoch on
+    epoch.open(300);
+    EXPECT_EQ(partGps | partGlonass, epoch.getExpected());
+}
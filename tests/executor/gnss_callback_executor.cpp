@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GnssCallbackExecutor.h"
+#include "GnssEpochBarrier.h"
+
+using android::hardware::Return;
+using android::hardware::Void;
+using android::hardware::hidl_string;
+
+class ExecutorCallback : public IGnssCallback {
+public:
+    Return<void> gnssLocationCb(const GnssLocation& location) override
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        mLatitudes.push_back(location.latitudeDegrees);
+        mCv.notify_all();
+        // a slow client is emulated by holding the first callback until opened
+        mCv.wait(lock, [this] { return mOpen; });
+        mReturned++;
+        return Void();
+    }
+
+    Return<void> gnssSvStatusCb(const GnssSvStatus& svStatus) override
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mSvCounts.push_back(svStatus.numSvs);
+        mCv.notify_all();
+        return Void();
+    }
+
+    Return<void> gnssStatusCb(GnssStatusValue) override { return Void(); }
+    Return<void> gnssNmeaCb(int64_t, const hidl_string&) override { return Void(); }
+    Return<void> gnssSetCapabilitesCb(uint32_t) override { return Void(); }
+    Return<void> gnssAcquireWakelockCb() override { return Void(); }
+    Return<void> gnssReleaseWakelockCb() override { return Void(); }
+    Return<void> gnssRequestTimeCb() override { return Void(); }
+    Return<void> gnssSetSystemInfoCb(const GnssSystemInfo&) override { return Void(); }
+
+    bool waitFor(const std::vector<double>& values, size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        return mCv.wait_for(lock, std::chrono::seconds(2), [&] { return values.size() >= count; });
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mOpen = true;
+        mCv.notify_all();
+    }
+
+    std::mutex mLock;
+    std::condition_variable mCv;
+    bool mOpen = true;
+    size_t mReturned = 0;
+    std::vector<double> mLatitudes;
+    std::vector<double> mSvCounts;
+};
+
+static GnssLocation makeLocation(double latitude)
+{
+    GnssLocation location = {};
+    location.latitudeDegrees = latitude;
+    return location;
+}
+
+static IGnssCallback::GnssSvStatus makeSvStatus(uint32_t numSvs)
+{
+    IGnssCallback::GnssSvStatus svStatus = {};
+    svStatus.numSvs = numSvs;
+    for (uint32_t i = 0; i < numSvs; i++) {
+        svStatus.gnssSvList[i].svid = static_cast<int16_t>(i + 1);
+    }
+    return svStatus;
+}
+
+TEST(GnssCallbackExecutorTest, noClientNothingPosted)
+{
+    GnssCallbackExecutor executor;
+
+    executor.PostLocation(makeLocation(1.0));
+    executor.PostSvStatus(makeSvStatus(3));
+
+    EXPECT_EQ((uint64_t)0, executor.GetStats(GnssCallbackExecutor::Mailbox::Location).posted);
+    EXPECT_EQ((uint64_t)0, executor.GetStats(GnssCallbackExecutor::Mailbox::SvStatus).posted);
+}
+
+TEST(GnssCallbackExecutorTest, deliversLocationAndSvStatus)
+{
+    android::sp<ExecutorCallback> callback = new ExecutorCallback();
+    GnssCallbackExecutor executor;
+    executor.SetCallback(callback);
+
+    executor.PostLocation(makeLocation(47.5));
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 1));
+    executor.PostSvStatus(makeSvStatus(5));
+    ASSERT_TRUE(callback->waitFor(callback->mSvCounts, 1));
+
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        EXPECT_EQ(47.5, callback->mLatitudes[0]);
+        EXPECT_EQ(5.0, callback->mSvCounts[0]);
+    }
+
+    // counters are updated after the callback returns
+    executor.SetCallback(nullptr);
+    for (int i = 0; i < 100 &&
+            executor.GetStats(GnssCallbackExecutor::Mailbox::SvStatus).delivered == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const GnssCallbackExecutor::Stats stats = executor.GetStats(GnssCallbackExecutor::Mailbox::SvStatus);
+    EXPECT_EQ((uint64_t)1, stats.posted);
+    EXPECT_EQ((uint64_t)1, stats.delivered);
+    EXPECT_EQ((uint64_t)0, stats.coalesced);
+}
+
+TEST(GnssCallbackExecutorTest, slowClientGetsNewestValue)
+{
+    android::sp<ExecutorCallback> callback = new ExecutorCallback();
+    callback->mOpen = false;
+    GnssCallbackExecutor executor;
+    executor.SetCallback(callback);
+
+    executor.PostLocation(makeLocation(1.0));
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 1));
+
+    // the client is blocked, the poster must not be
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 2; i <= 10; i++) {
+        executor.PostLocation(makeLocation(static_cast<double>(i)));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+    callback->open();
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 2));
+
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        ASSERT_EQ((size_t)2, callback->mLatitudes.size());
+        EXPECT_EQ(10.0, callback->mLatitudes[1]);
+    }
+
+    const GnssCallbackExecutor::Stats stats = executor.GetStats(GnssCallbackExecutor::Mailbox::Location);
+    EXPECT_EQ((uint64_t)10, stats.posted);
+    EXPECT_EQ((uint64_t)8, stats.coalesced);
+}
+
+TEST(GnssCallbackExecutorTest, clearDiscardsPendingValues)
+{
+    android::sp<ExecutorCallback> callback = new ExecutorCallback();
+    callback->mOpen = false;
+    GnssCallbackExecutor executor;
+    executor.SetCallback(callback);
+
+    executor.PostLocation(makeLocation(1.0));
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 1));
+    executor.PostLocation(makeLocation(2.0));
+
+    // the client returns later, Clear must not return before it
+    std::thread client([&callback] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        callback->open();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    executor.Clear();
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(90));
+    client.join();
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        EXPECT_EQ((size_t)1, callback->mReturned);
+    }
+
+    // the pending value is discarded, a value posted after Clear is the next one delivered
+    executor.PostLocation(makeLocation(3.0));
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 2));
+
+    std::lock_guard<std::mutex> lock(callback->mLock);
+    ASSERT_EQ((size_t)2, callback->mLatitudes.size());
+    EXPECT_EQ(3.0, callback->mLatitudes[1]);
+}
+
+TEST(GnssCallbackExecutorTest, epochBarrierHoldsDeliveryNotPoster)
+{
+    typedef GnssEpochBarrier::Lane Lane;
+    const int64_t epochKey = 43200000;
+    GnssEpochBarrier& barrier = GnssEpochBarrier::getInstance();
+    barrier.setPolicy(GnssEpochBarrier::Policy::MEAS_FIRST);
+    barrier.setMaxDelay(std::chrono::milliseconds(2000));
+    barrier.setLaneActive(Lane::Measurement, true);
+    barrier.setLaneActive(Lane::Location, true);
+
+    android::sp<ExecutorCallback> callback = new ExecutorCallback();
+    GnssCallbackExecutor executor;
+    executor.SetCallback(callback);
+
+    // no measurement was delivered yet, the location is dropped
+    executor.PostLocation(makeLocation(1.0), epochKey);
+    for (int i = 0; i < 100 && executor.GetStats(GnssCallbackExecutor::Mailbox::Location).dropped == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ((uint64_t)1, executor.GetStats(GnssCallbackExecutor::Mailbox::Location).dropped);
+
+    // measurements of the previous epoch are out, the location waits for its own epoch
+    barrier.release(Lane::Measurement, epochKey - 1000);
+    const auto start = std::chrono::steady_clock::now();
+    executor.PostLocation(makeLocation(2.0), epochKey);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        EXPECT_TRUE(callback->mLatitudes.empty());
+    }
+
+    barrier.release(Lane::Measurement, epochKey);
+    ASSERT_TRUE(callback->waitFor(callback->mLatitudes, 1));
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        EXPECT_EQ(2.0, callback->mLatitudes[0]);
+    }
+
+    executor.SetCallback(nullptr);
+    barrier.setLaneActive(Lane::Measurement, false);
+    barrier.setLaneActive(Lane::Location, false);
+    barrier.setMaxDelay(std::chrono::milliseconds(250));
+}
+
+TEST(GnssCallbackExecutorTest, clearDropsLocationWaitingForEpochTurn)
+{
+    typedef GnssEpochBarrier::Lane Lane;
+    const int64_t epochKey = 43200000;
+    GnssEpochBarrier& barrier = GnssEpochBarrier::getInstance();
+    barrier.setPolicy(GnssEpochBarrier::Policy::MEAS_FIRST);
+    barrier.setMaxDelay(std::chrono::milliseconds(2000));
+    barrier.setLaneActive(Lane::Measurement, true);
+    barrier.setLaneActive(Lane::Location, true);
+    barrier.release(Lane::Measurement, epochKey - 1000);
+
+    android::sp<ExecutorCallback> callback = new ExecutorCallback();
+    GnssCallbackExecutor executor;
+    executor.SetCallback(callback);
+
+    executor.PostLocation(makeLocation(1.0), epochKey);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // the session ends while the location waits for its epoch, it is never delivered
+    const auto start = std::chrono::steady_clock::now();
+    barrier.setLaneActive(Lane::Location, false);
+    executor.Clear();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    EXPECT_EQ((uint64_t)1, executor.GetStats(GnssCallbackExecutor::Mailbox::Location).dropped);
+
+    barrier.release(Lane::Measurement, epochKey);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        std::lock_guard<std::mutex> lock(callback->mLock);
+        EXPECT_TRUE(callback->mLatitudes.empty());
+    }
+
+    executor.SetCallback(nullptr);
+    barrier.setLaneActive(Lane::Measurement, false);
+    barrier.setMaxDelay(std::chrono::milliseconds(250));
+}
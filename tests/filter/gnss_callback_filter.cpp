@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssCallbackFilter.h"
+
+// enabled, C/N0 2 dBHz, angle 1 degree, displacement 1 m, silence 5 s
+static const GnssCallbackFilter::Config enabledConfig = {true, 2.f, 1.f, 1.f, 5000};
+
+class GnssCallbackFilterTest : public ::testing::Test {
+protected:
+    void SetUp();
+
+    IGnssCallback::GnssSvStatus status = {};
+    GnssLocation location = {};
+};
+
+void GnssCallbackFilterTest::SetUp()
+{
+    status.numSvs = 2;
+    status.gnssSvList[0].svid = 1;
+    status.gnssSvList[0].constellation = GnssConstellationType::GPS;
+    status.gnssSvList[0].cN0Dbhz = 30.f;
+    status.gnssSvList[0].azimuthDegrees = 359.5f;
+    status.gnssSvList[1].svid = 7;
+    status.gnssSvList[1].constellation = GnssConstellationType::GLONASS;
+    status.gnssSvList[1].cN0Dbhz = 25.f;
+
+    location.gnssLocationFlags = static_cast<uint16_t>(GnssLocationFlags::HAS_LAT_LONG);
+    location.latitudeDegrees = 50.0;
+    location.longitudeDegrees = 30.0;
+}
+
+TEST_F(GnssCallbackFilterTest, disabledFilterSendsEverything)
+{
+    GnssCallbackFilter::Config config = enabledConfig;
+    config.enabled = false;
+    GnssCallbackFilter filter(config);
+
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 0));
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 1000));
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 0));
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 1000));
+    EXPECT_EQ((uint64_t)0, filter.GetSavedSvStatusCount());
+    EXPECT_EQ((uint64_t)0, filter.GetSavedLocationCount());
+}
+
+TEST_F(GnssCallbackFilterTest, unchangedSvStatusSkippedUntilSilence)
+{
+    GnssCallbackFilter filter(enabledConfig);
+
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 0));
+    status.gnssSvList[0].cN0Dbhz += 1.f;
+    status.gnssSvList[0].azimuthDegrees = 0.2f;
+    EXPECT_FALSE(filter.ShouldSendSvStatus(status, 1000));
+    EXPECT_FALSE(filter.ShouldSendSvStatus(status, 2000));
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 5000));
+    EXPECT_EQ((uint64_t)2, filter.GetSavedSvStatusCount());
+}
+
+TEST_F(GnssCallbackFilterTest, svStatusChangesAreSent)
+{
+    GnssCallbackFilter filter(enabledConfig);
+
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 0));
+
+    status.gnssSvList[1].cN0Dbhz += 2.f;
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 1000));
+
+    status.gnssSvList[1].svFlag |= static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 2000));
+
+    status.numSvs = 1;
+    EXPECT_TRUE(filter.ShouldSendSvStatus(status, 3000));
+    EXPECT_EQ((uint64_t)0, filter.GetSavedSvStatusCount());
+}
+
+TEST_F(GnssCallbackFilterTest, locationDisplacementThreshold)
+{
+    GnssCallbackFilter filter(enabledConfig);
+
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 0));
+
+    location.latitudeDegrees += 0.000005; // ~0.55 m
+    EXPECT_FALSE(filter.ShouldSendLocation(location, 1000));
+
+    location.latitudeDegrees += 0.00001; // ~1.66 m from the last sent one
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 2000));
+
+    location.gnssLocationFlags |= static_cast<uint16_t>(GnssLocationFlags::HAS_ALTITUDE);
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 3000));
+    EXPECT_EQ((uint64_t)1, filter.GetSavedLocationCount());
+}
+
+TEST_F(GnssCallbackFilterTest, resetForcesNextUpdate)
+{
+    GnssCallbackFilter filter(enabledConfig);
+
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 0));
+    EXPECT_FALSE(filter.ShouldSendLocation(location, 100));
+    filter.Reset();
+    EXPECT_TRUE(filter.ShouldSendLocation(location, 200));
+}
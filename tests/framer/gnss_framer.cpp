@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <string>
+#include <vector>
+
+#include "GnssFramer.h"
+
+struct UbxFrame {
+    uint8_t cl;
+    uint8_t id;
+    std::vector<uint8_t> payload;
+};
+
+class GnssFramerTest : public ::testing::Test, public GnssFramer::Sink {
+protected:
+    void OnNmeaFrame(const char* sentence, size_t len) override
+    {
+        mNmea.push_back(std::string(sentence, len));
+    }
+
+    void OnUbxFrame(uint8_t cl, uint8_t id, const uint8_t* payload, uint16_t len) override
+    {
+        mUbx.push_back({cl, id, std::vector<uint8_t>(payload, payload + len)});
+    }
+
+    static std::vector<uint8_t> makeUbx(uint8_t cl, uint8_t id, const std::vector<uint8_t>& payload)
+    {
+        std::vector<uint8_t> frame = {0xB5, 0x62, cl, id,
+                                      static_cast<uint8_t>(payload.size() & 0xFF),
+                                      static_cast<uint8_t>(payload.size() >> 8)};
+        frame.insert(frame.end(), payload.begin(), payload.end());
+
+        uint8_t ckA = 0;
+        uint8_t ckB = 0;
+        for (size_t i = 2; i < frame.size(); i++) {
+            ckA = static_cast<uint8_t>(ckA + frame[i]);
+            ckB = static_cast<uint8_t>(ckB + ckA);
+        }
+        frame.push_back(ckA);
+        frame.push_back(ckB);
+
+        return frame;
+    }
+
+    void push(const std::vector<uint8_t>& data)
+    {
+        mFramer.Push(data.data(), data.size());
+    }
+
+    void push(const std::string& data)
+    {
+        mFramer.Push(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    GnssFramer mFramer{*this};
+    std::vector<std::string> mNmea;
+    std::vector<UbxFrame> mUbx;
+};
+
+TEST_F(GnssFramerTest, fletcherMatchesBytewiseChecksum)
+{
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+
+    for (size_t len : {0, 1, 63, 64, 65, 200, 1000}) {
+        uint8_t expA = 0;
+        uint8_t expB = 0;
+        for (size_t i = 0; i < len; i++) {
+            expA = static_cast<uint8_t>(expA + data[i]);
+            expB = static_cast<uint8_t>(expB + expA);
+        }
+
+        uint8_t ckA = 0;
+        uint8_t ckB = 0;
+        GnssFramer::Fletcher8(data.data(), len, ckA, ckB);
+        EXPECT_EQ(expA, ckA) << "len " << len;
+        EXPECT_EQ(expB, ckB) << "len " << len;
+
+        // same result when continued over two parts
+        ckA = 0;
+        ckB = 0;
+        GnssFramer::Fletcher8(data.data(), len / 3, ckA, ckB);
+        GnssFramer::Fletcher8(data.data() + len / 3, len - len / 3, ckA, ckB);
+        EXPECT_EQ(expA, ckA) << "len " << len;
+        EXPECT_EQ(expB, ckB) << "len " << len;
+    }
+}
+
+TEST_F(GnssFramerTest, mixedStream)
+{
+    std::vector<uint8_t> stream = makeUbx(0x01, 0x07, {1, 2, 3, 4});
+    const std::string gga = "$GPGGA,123519,4807.038,N*47";
+    stream.insert(stream.end(), gga.begin(), gga.end());
+    stream.push_back('\r');
+    stream.push_back('\n');
+    const std::vector<uint8_t> ack = makeUbx(0x05, 0x01, {0x06, 0x01});
+    stream.insert(stream.end(), ack.begin(), ack.end());
+
+    push(stream);
+
+    ASSERT_EQ(2u, mUbx.size());
+    EXPECT_EQ(0x01, mUbx[0].cl);
+    EXPECT_EQ(0x07, mUbx[0].id);
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4}), mUbx[0].payload);
+    EXPECT_EQ(0x05, mUbx[1].cl);
+    ASSERT_EQ(1u, mNmea.size());
+    EXPECT_EQ(gga, mNmea[0]);
+    EXPECT_EQ(0u, mFramer.GetDiscardedBytesCount());
+    EXPECT_EQ(0u, mFramer.GetResyncCount());
+}
+
+TEST_F(GnssFramerTest, byteByByte)
+{
+    std::vector<uint8_t> stream = makeUbx(0x02, 0x14, std::vector<uint8_t>(300, 0xB5));
+    const std::string rmc = "$GPRMC,1*00\r\n";
+    stream.insert(stream.end(), rmc.begin(), rmc.end());
+
+    for (uint8_t ch : stream) {
+        mFramer.Push(&ch, 1);
+    }
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(300u, mUbx[0].payload.size());
+    ASSERT_EQ(1u, mNmea.size());
+    EXPECT_EQ("$GPRMC,1*00", mNmea[0]);
+}
+
+TEST_F(GnssFramerTest, checksumFailureIsDroppedAndNextFrameRecovered)
+{
+    std::vector<uint8_t> bad = makeUbx(0x01, 0x07, {1, 2, 3, 4});
+    bad[7] ^= 0xFF;
+    push(bad);
+    push(makeUbx(0x01, 0x35, {5}));
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(0x35, mUbx[0].id);
+    EXPECT_EQ(1u, mFramer.GetChecksumErrorCount());
+    EXPECT_EQ(1u, mFramer.GetResyncCount());
+    EXPECT_EQ(bad.size(), mFramer.GetDiscardedBytesCount());
+}
+
+TEST_F(GnssFramerTest, corruptedLengthDoesNotSwallowFollowingFrames)
+{
+    // ACK class allows 2 bytes only, the frame following the bad header must survive
+    std::vector<uint8_t> stream = {0xB5, 0x62, 0x05, 0x01, 0xFF, 0x7F};
+    const std::vector<uint8_t> good = makeUbx(0x05, 0x01, {0x06, 0x01});
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    push(stream);
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(std::vector<uint8_t>({0x06, 0x01}), mUbx[0].payload);
+    EXPECT_EQ(1u, mFramer.GetLengthErrorCount());
+    EXPECT_EQ(6u, mFramer.GetDiscardedBytesCount());
+}
+
+TEST_F(GnssFramerTest, truncatedFrameResyncsOnFrameInsideIt)
+{
+    // frame cut after its header, next frame starts where the payload was expected
+    std::vector<uint8_t> stream = {0xB5, 0x62, 0x01, 0x07, 0x10, 0x00};
+    const std::vector<uint8_t> good = makeUbx(0x01, 0x03, std::vector<uint8_t>(16, 0x00));
+    stream.insert(stream.end(), good.begin(), good.end());
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    push(stream);
+
+    ASSERT_LE(1u, mUbx.size());
+    EXPECT_EQ(0x03, mUbx.back().id);
+    EXPECT_EQ(1u, mFramer.GetChecksumErrorCount());
+}
+
+TEST_F(GnssFramerTest, garbageAndLongSentenceAreDiscarded)
+{
+    push(std::string("xyz\r\n$GPGSV,") + std::string(200, 'A'));
+    push(std::string("\r\n$GPGSA,1*00\r\n"));
+
+    ASSERT_EQ(1u, mNmea.size());
+    EXPECT_EQ("$GPGSA,1*00", mNmea[0]);
+    EXPECT_EQ(1u, mFramer.GetLengthErrorCount());
+    EXPECT_EQ(3u + 7u + 200u, mFramer.GetDiscardedBytesCount());
+}
+
+TEST_F(GnssFramerTest, maxPayloadLenPerClass)
+{
+    EXPECT_EQ(2, GnssFramer::GetMaxPayloadLen(0x05));
+    EXPECT_EQ(GnssFramer::mMaxUbxPayloadLen, GnssFramer::GetMaxPayloadLen(0x02));
+    EXPECT_GE(GnssFramer::mMaxUbxPayloadLen, GnssFramer::GetMaxPayloadLen(0x7F));
+}
+
+TEST_F(GnssFramerTest, unwantedUbxIsSkipped)
+{
+    mFramer.SetUbxWanted(0x01, 0x07, false);
+    EXPECT_FALSE(mFramer.IsUbxWanted(0x01, 0x07));
+    EXPECT_TRUE(mFramer.IsUbxWanted(0x01, 0x35));
+
+    std::vector<uint8_t> stream = makeUbx(0x01, 0x07, {1, 2, 3, 4});
+    const std::vector<uint8_t> sat = makeUbx(0x01, 0x35, {5});
+    stream.insert(stream.end(), sat.begin(), sat.end());
+    push(stream);
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(0x35, mUbx[0].id);
+    EXPECT_EQ(1u, mFramer.GetUbxSkippedCount(0x01, 0x07));
+    EXPECT_EQ(0u, mFramer.GetUbxSkippedCount(0x01, 0x35));
+    EXPECT_EQ(1u, mFramer.GetSkippedCount());
+    EXPECT_EQ(1u, mFramer.GetUbxFrameCount());
+}
+
+TEST_F(GnssFramerTest, unwantedUbxSplitAcrossReadsIsSkipped)
+{
+    mFramer.SetAllUbxWanted(false);
+    mFramer.SetUbxWanted(0x05, 0x01, true);
+
+    std::vector<uint8_t> stream = makeUbx(0x02, 0x15, std::vector<uint8_t>(2000, 0x62));
+    const std::vector<uint8_t> ack = makeUbx(0x05, 0x01, {0x06, 0x01});
+    stream.insert(stream.end(), ack.begin(), ack.end());
+
+    // the header arrives alone, the frame is delivered only after its checksum
+    for (size_t pos = 0; pos < stream.size(); pos += 7) {
+        mFramer.Push(&stream[pos], std::min(static_cast<size_t>(7), stream.size() - pos));
+    }
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(0x05, mUbx[0].cl);
+    EXPECT_EQ(1u, mFramer.GetUbxSkippedCount(0x02, 0x15));
+    EXPECT_EQ(0u, mFramer.GetChecksumErrorCount());
+}
+
+TEST_F(GnssFramerTest, unwantedUbxWithBadChecksumIsCounted)
+{
+    mFramer.SetUbxWanted(0x02, 0x15, false);
+
+    std::vector<uint8_t> bad = makeUbx(0x02, 0x15, std::vector<uint8_t>(100, 0x11));
+    bad.back() ^= 0xFF;
+    push(std::vector<uint8_t>(bad.begin(), bad.begin() + 10));
+    push(std::vector<uint8_t>(bad.begin() + 10, bad.end()));
+    push(makeUbx(0x01, 0x07, {1}));
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(0u, mFramer.GetUbxSkippedCount(0x02, 0x15));
+    EXPECT_EQ(1u, mFramer.GetChecksumErrorCount());
+}
+
+TEST_F(GnssFramerTest, corruptedUnwantedHeaderDoesNotHideFrames)
+{
+    mFramer.SetUbxWanted(0x02, 0x15, false);
+
+    // bogus RXM-RAWX header with a 256 byte length covering a wanted frame
+    std::vector<uint8_t> stream = {0xB5, 0x62, 0x02, 0x15, 0x00, 0x01};
+    const std::vector<uint8_t> ack = makeUbx(0x05, 0x01, {0x06, 0x01});
+    stream.insert(stream.end(), ack.begin(), ack.end());
+    stream.insert(stream.end(), 300, 0x00);
+    push(stream);
+
+    ASSERT_EQ(1u, mUbx.size());
+    EXPECT_EQ(0x05, mUbx[0].cl);
+    EXPECT_EQ(0u, mFramer.GetUbxSkippedCount(0x02, 0x15));
+    EXPECT_EQ(1u, mFramer.GetChecksumErrorCount());
+}
+
+TEST_F(GnssFramerTest, unwantedNmeaIsSkipped)
+{
+    mFramer.SetAllNmeaWanted(false);
+    mFramer.SetNmeaWanted("RMC", true);
+    EXPECT_FALSE(mFramer.IsNmeaWanted("GLL"));
+    EXPECT_TRUE(mFramer.IsNmeaWanted("RMC"));
+
+    const std::string stream = "$GPGLL,4916.45,N,12311.12,W,225444,A*31\r\n"
+                               "$GPTXT,01,01,02,ANTSTATUS=OK*3B\r\n"
+                               "$GPRMC,1*00\r\n"
+                               "$PUBX,00,1*00\r\n";
+    for (char ch : stream) {
+        mFramer.Push(reinterpret_cast<const uint8_t*>(&ch), 1);
+    }
+
+    ASSERT_EQ(2u, mNmea.size());
+    EXPECT_EQ("$GPRMC,1*00", mNmea[0]);
+    EXPECT_EQ("$PUBX,00,1*00", mNmea[1]);
+    EXPECT_EQ(1u, mFramer.GetNmeaSkippedCount("GLL"));
+    EXPECT_EQ(1u, mFramer.GetNmeaSkippedCount("TXT"));
+    EXPECT_EQ(0u, mFramer.GetDiscardedBytesCount());
+}
@@ -83,8 +83,9 @@ TEST_F(GnssHwTTYTest, selectParserRxmMeasxDumpNormalInput)
     data.measurementCount = 0;
     EXPECT_EQ(emptyDataMeasCount, data.measurementCount);
 
-    auto parser = instance.pop();
-    ASSERT_EQ(GnssIParser::RxmDone, parser->retrieveSvInfo(data));
+    GnssMeasMsg parser;
+    ASSERT_TRUE(instance.pop(parser));
+    ASSERT_EQ(GnssIParser::RxmDone, std::visit(GnssMeasMsgRetrieve{data}, parser));
     ASSERT_EQ(dumpedDataMeasCount, data.measurementCount);
 
     uint16_t exptectedSvid[] = {32, 2, 6, 17, 19, 24};
@@ -120,8 +121,9 @@ TEST_F(GnssHwTTYTest, DISABLED_selectParserRxmGnssMeasurementsCallbackThreadNorm
     data.measurementCount = 0;
     EXPECT_EQ(emptyDataMeasCount, data.measurementCount);
 
-    auto parser = instance.pop();
-    ASSERT_EQ(GnssIParser::RxmDone, parser->retrieveSvInfo(data));
+    GnssMeasMsg parser;
+    ASSERT_TRUE(instance.pop(parser));
+    ASSERT_EQ(GnssIParser::RxmDone, std::visit(GnssMeasMsgRetrieve{data}, parser));
     ASSERT_EQ(dumpedDataMeasCount, data.measurementCount);
 
     uint16_t exptectedSvid[] = {32, 2, 6, 17, 19, 24};
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utils/SystemClock.h>
+
+#include "GnssFixLatency.h"
+#include "circular_buffer.h"
+
+TEST(GnssFixLatencyTest, recordsCountAverageAndMax)
+{
+    GnssFixLatency latency;
+    latency.Record(1000000, 1000000 + 4000);
+    latency.Record(2000000, 2000000 + 10000);
+    latency.Record(3000000, 3000000 + 7000);
+
+    const GnssFixLatency::Stats stats = latency.GetStats();
+    EXPECT_EQ(3u, stats.count);
+    EXPECT_EQ(7, stats.avgUs);
+    EXPECT_EQ(10, stats.maxUs);
+}
+
+TEST(GnssFixLatencyTest, fixWithoutReceptionTimeIsNotRecorded)
+{
+    GnssFixLatency latency;
+    latency.Record(0, 5000000);
+
+    const GnssFixLatency::Stats stats = latency.GetStats();
+    EXPECT_EQ(0u, stats.count);
+    EXPECT_EQ(0, stats.avgUs);
+    EXPECT_EQ(0, stats.maxUs);
+}
+
+TEST(GnssFixLatencyTest, resetClearsCounters)
+{
+    GnssFixLatency latency;
+    latency.Record(1000000, 1000000 + 50000);
+    latency.Reset();
+    latency.Record(2000000, 2000000 + 3000);
+
+    const GnssFixLatency::Stats stats = latency.GetStats();
+    EXPECT_EQ(1u, stats.count);
+    EXPECT_EQ(3, stats.avgUs);
+    EXPECT_EQ(3, stats.maxUs);
+}
+
+TEST(GnssFixLatencyTest, nmeaAndUbxThreadsRecordTheirOwnLatency)
+{
+    GnssFixLatency latency;
+    const int fixes = 100000;
+    std::atomic<bool> done(false);
+
+    // each parse thread measures from the frames it parsed, not from the last frame of the other one
+    std::thread nmea([&] {
+        for (int i = 0; i < fixes; i++) {
+            latency.Record(1000000 + i, 1000000 + i + 5000);
+        }
+    });
+    std::thread ubx([&] {
+        for (int i = 0; i < fixes; i++) {
+            latency.Record(2000000 + i, 2000000 + i + 20000);
+        }
+    });
+    std::thread binder([&] {
+        while (!done) {
+            const GnssFixLatency::Stats stats = latency.GetStats();
+            EXPECT_LE(stats.maxUs, 20);
+        }
+    });
+
+    nmea.join();
+    ubx.join();
+    done = true;
+    binder.join();
+
+    const GnssFixLatency::Stats stats = latency.GetStats();
+    EXPECT_EQ(static_cast<uint64_t>(2 * fixes), stats.count);
+    EXPECT_EQ(12, stats.avgUs);
+    EXPECT_EQ(20, stats.maxUs);
+}
+
+struct LatencyFrame {
+    int64_t receivedNs;
+};
+
+TEST(GnssFixLatencyTest, benchmarkParseThreadHandoff)
+{
+    // the reader thread stamps frames and hands them to a parse thread as GnssHwTTY does,
+    // the binder thread reads the counters while the session runs
+    CircularBuffer<LatencyFrame> buffer(32, sizeof(LatencyFrame));
+    std::mutex lock;
+    std::condition_variable cv;
+    std::atomic<bool> exit(false);
+    GnssFixLatency latency;
+    const int frames = 500;
+
+    std::thread parse([&] {
+        while (!exit || !buffer.empty()) {
+            if (!buffer.empty()) {
+                const int64_t receivedNs = buffer.get()->receivedNs;
+                latency.Record(receivedNs, android::elapsedRealtimeNano());
+            } else {
+                std::unique_lock<std::mutex> guard(lock);
+                cv.wait_for(guard, std::chrono::milliseconds(10));
+            }
+        }
+    });
+    std::thread binder([&] {
+        while (!exit) {
+            latency.GetStats();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    for (int i = 0; i < frames; i++) {
+        LatencyFrame frame = {android::elapsedRealtimeNano()};
+        buffer.put(&frame);
+        cv.notify_all();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    exit = true;
+    cv.notify_all();
+    parse.join();
+    binder.join();
+
+    const GnssFixLatency::Stats stats = latency.GetStats();
+    EXPECT_EQ(static_cast<uint64_t>(frames), stats.count);
+    RecordProperty("HandoffLatencyAvgUs", static_cast<int>(stats.avgUs));
+    RecordProperty("HandoffLatencyMaxUs", static_cast<int>(stats.maxUs));
+
+    const int iterations = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        latency.Record(1000000 + i, 1000000 + 2 * i);
+    }
+    auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    RecordProperty("RecordNs", static_cast<int>(elapsedNs / iterations));
+
+    // a fix is posted once per epoch, recording it must be negligible next to the parsing
+    EXPECT_LT(elapsedNs / iterations, 1000);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssDataPool.h"
+
+TEST(GnssDataPoolTest, acquireReusesOneBuffer)
+{
+    GnssDataPool pool;
+    MeasurementCb::GnssData* first = &pool.acquire();
+
+    EXPECT_EQ(first, &pool.acquire());
+    EXPECT_EQ(first, &pool.acquire());
+}
+
+TEST(GnssDataPoolTest, acquireResetsUsedEntries)
+{
+    GnssDataPool pool;
+    const uint32_t used = 5;
+
+    MeasurementCb::GnssData& data = pool.acquire();
+    data.measurementCount = used;
+    for (uint32_t i = 0; i < used; ++i) {
+        data.measurements[i].svid = static_cast<int16_t>(i + 1);
+        data.measurements[i].cN0DbHz = 40.0;
+    }
+    data.clock.fullBiasNs = -1234567890;
+    data.clock.biasNs = 12.5;
+
+    MeasurementCb::GnssData& reused = pool.acquire();
+    ASSERT_EQ(&data, &reused);
+    EXPECT_EQ(0u, reused.measurementCount);
+    for (uint32_t i = 0; i < used; ++i) {
+        EXPECT_EQ(0, reused.measurements[i].svid);
+        EXPECT_EQ(0.0, reused.measurements[i].cN0DbHz);
+    }
+    EXPECT_EQ(0, reused.clock.fullBiasNs);
+    EXPECT_EQ(0.0, reused.clock.biasNs);
+}
+
+TEST(GnssDataPoolTest, resetClampsMeasurementCount)
+{
+    MeasurementCb::GnssData data;
+    data.measurementCount = UINT32_MAX;
+    GnssDataPool::reset(data);
+    EXPECT_EQ(0u, data.measurementCount);
+}
+
+TEST(GnssDataPoolTest, oneAllocationPerSession)
+{
+    GnssDataPool pool;
+    EXPECT_EQ((uint64_t)0, pool.getStats().allocated);
+
+    const size_t epochs = 1000;
+    for (size_t i = 0; i < epochs; ++i) {
+        MeasurementCb::GnssData& data = pool.acquire();
+        data.measurementCount = static_cast<uint32_t>(i % data.measurements.size());
+    }
+
+    GnssDataPool::Stats stats = pool.getStats();
+    EXPECT_EQ((uint64_t)epochs, stats.acquired);
+    EXPECT_EQ((uint64_t)1, stats.allocated);
+
+    // the next session allocates the buffer again
+    pool.release();
+    EXPECT_EQ(0u, pool.acquire().measurementCount);
+    stats = pool.getStats();
+    EXPECT_EQ((uint64_t)epochs + 1, stats.acquired);
+    EXPECT_EQ((uint64_t)2, stats.allocated);
+}
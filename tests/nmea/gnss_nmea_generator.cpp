@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssNmeaGenerator.h"
+
+class GnssNmeaGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp()
+    {
+        location = {};
+        location.gnssLocationFlags = GnssLocationFlags::HAS_LAT_LONG | GnssLocationFlags::HAS_ALTITUDE |
+                                     GnssLocationFlags::HAS_SPEED | GnssLocationFlags::HAS_BEARING;
+        location.timestamp = 1552558830500; // 2019-03-14 10:20:30.5 UTC
+        location.latitudeDegrees = 35.68;
+        location.longitudeDegrees = 139.7;
+        location.altitudeMeters = 45.123;
+        location.speedMetersPerSec = 0.223f;
+        location.bearingDegrees = 90.f;
+
+        status = {};
+        status.numSvs = 3;
+        setSv(status.gnssSvList[0], GnssConstellationType::GPS, 5, 40.f, 45.f, 270.f, true);
+        setSv(status.gnssSvList[1], GnssConstellationType::GLONASS, 3, 30.f, 10.f, 90.f, false);
+        setSv(status.gnssSvList[2], GnssConstellationType::GPS, 12, 35.f, 60.f, 180.f, true);
+    }
+
+    static void setSv(IGnssCallback::GnssSvInfo& sv, GnssConstellationType constellation, int16_t svid,
+                      float cn0, float elevation, float azimuth, bool used)
+    {
+        sv.constellation = constellation;
+        sv.svid = svid;
+        sv.cN0Dbhz = cn0;
+        sv.elevationDegrees = elevation;
+        sv.azimuthDegrees = azimuth;
+        sv.svFlag = used ? static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX) : 0;
+    }
+
+    GnssNmeaPassthrough passthrough{"all", false};
+    GnssNmeaGenerator generator{passthrough};
+    GnssLocation location;
+    IGnssCallback::GnssSvStatus status;
+};
+
+TEST_F(GnssNmeaGeneratorTest, checksumOfKnownSentence)
+{
+    EXPECT_EQ(0x76, GnssNmeaGenerator::Checksum("$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76"));
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatRMC)
+{
+    generator.FormatRMC(location);
+    EXPECT_STREQ("$GNRMC,102030.50,A,3540.80000,N,13942.00000,E,0.433,90.00,140319,,,A,V*3B",
+                 generator.GetSentence());
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatRMCSouthWest)
+{
+    location.latitudeDegrees = -0.5;
+    location.longitudeDegrees = -1.9999999999;
+    generator.FormatRMC(location);
+    EXPECT_NE(nullptr, strstr(generator.GetSentence(), ",0030.00000,S,00200.00000,W,"));
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatVoidRMC)
+{
+    generator.FormatVoidRMC(location.timestamp);
+    EXPECT_STREQ("$GNRMC,102030.50,V,,,,,,,140319,,,N,V*12", generator.GetSentence());
+
+    generator.FormatVoidRMC(-1);
+    EXPECT_STREQ("$GNRMC,,V,,,,,,,,,,N,V*37", generator.GetSentence());
+}
+
+TEST_F(GnssNmeaGeneratorTest, putNoFixClearsFix)
+{
+    generator.PutFix(location, 12.0, 1.5f, 9, 0);
+    generator.PutNoFix(location.timestamp, 0);
+    EXPECT_GT(generator.FormatGSA(status, 0), 0u);
+    EXPECT_EQ(0, strncmp("$GNGSA,A,1,05,12,", generator.GetSentence(), 17));
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatGGA)
+{
+    generator.FormatGGA(location, 12.0, 9);
+    EXPECT_STREQ("$GNGGA,102030.50,3540.80000,N,13942.00000,E,1,09,,12.0,M,33.1,M,,*65",
+                 generator.GetSentence());
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatGSAAfterFix)
+{
+    generator.PutFix(location, 12.0, 1.5f, 9, 0);
+    EXPECT_GT(generator.FormatGSA(status, 0), 0u);
+    EXPECT_STREQ("$GNGSA,A,3,05,12,,,,,,,,,,,1.50,,,1*03", generator.GetSentence());
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatGSANoUsedSvs)
+{
+    EXPECT_EQ(0u, generator.FormatGSA(status, 1));
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatGSV)
+{
+    ASSERT_EQ(1u, generator.SelectGSV(status, 1));
+    generator.FormatGSV(status, 1, 0);
+    EXPECT_STREQ("$GLGSV,1,1,01,67,10,090,30*5E", generator.GetSentence());
+}
+
+TEST_F(GnssNmeaGeneratorTest, formatGSVSplitsByFour)
+{
+    status.numSvs = 9;
+    for (uint32_t i = 0; i < status.numSvs; i++) {
+        setSv(status.gnssSvList[i], GnssConstellationType::GALILEO, static_cast<int16_t>(i + 1),
+              30.f, 20.f, 100.f, false);
+    }
+
+    ASSERT_EQ(3u, generator.SelectGSV(status, 2));
+    generator.FormatGSV(status, 2, 2);
+    EXPECT_EQ(0, strncmp("$GAGSV,3,3,09,09,20,100,30*", generator.GetSentence(), 27));
+}
+
+TEST_F(GnssNmeaGeneratorTest, noClientNothingQueued)
+{
+    generator.PutFix(location, 12.0, 1.5f, 9, 0);
+    generator.PutSvStatus(status, 0);
+    EXPECT_EQ(0u, passthrough.GetForwardedCount());
+    EXPECT_EQ(0u, passthrough.GetFilteredCount());
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GnssNmeaPassthrough.h"
+
+using android::hardware::Return;
+using android::hardware::Void;
+using android::hardware::hidl_string;
+
+static const char rmc[] = "$GNRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A,V*57";
+static const char gga[] = "$GNGGA,092725.00,4717.11399,N,00833.91590,E,1,08,1.01,499.6,M,48.0,M,,*5B";
+static const char txt[] = "$GNTXT,01,01,02,u-blox AG - www.u-blox.com*4E";
+static const char pubx[] = "$PUBX,00,081350.00,4717.113210,N,00833.915187,E,546.589,G3,2.1,2.0,0.007,77.52,0.007,,0.92,1.19,0.77,9,0,0*5F";
+
+class NmeaCallback : public IGnssCallback {
+public:
+    Return<void> gnssLocationCb(const GnssLocation&) override { return Void(); }
+    Return<void> gnssStatusCb(GnssStatusValue) override { return Void(); }
+    Return<void> gnssSvStatusCb(const GnssSvStatus&) override { return Void(); }
+    Return<void> gnssSetCapabilitesCb(uint32_t) override { return Void(); }
+    Return<void> gnssAcquireWakelockCb() override { return Void(); }
+    Return<void> gnssReleaseWakelockCb() override { return Void(); }
+    Return<void> gnssRequestTimeCb() override { return Void(); }
+    Return<void> gnssSetSystemInfoCb(const GnssSystemInfo&) override { return Void(); }
+
+    Return<void> gnssNmeaCb(int64_t timestamp, const hidl_string& nmea) override
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mTimestamps.push_back(timestamp);
+        mSentences.push_back(std::string(nmea.c_str()));
+        mCv.notify_all();
+        return Void();
+    }
+
+    bool waitFor(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        return mCv.wait_for(lock, std::chrono::seconds(2), [&] { return mSentences.size() >= count; });
+    }
+
+    std::mutex mLock;
+    std::condition_variable mCv;
+    std::vector<int64_t> mTimestamps;
+    std::vector<std::string> mSentences;
+};
+
+TEST(GnssNmeaPassthroughTest, allowAllSkipsProprietary)
+{
+    GnssNmeaPassthrough passthrough("all", false);
+
+    EXPECT_TRUE(passthrough.IsTypeAllowed(rmc));
+    EXPECT_TRUE(passthrough.IsTypeAllowed(txt));
+    EXPECT_FALSE(passthrough.IsTypeAllowed(pubx));
+    EXPECT_FALSE(passthrough.IsTypeAllowed("garbage"));
+}
+
+TEST(GnssNmeaPassthroughTest, allowlistSelectsTypes)
+{
+    GnssNmeaPassthrough passthrough("RMC,GGA:1000,PUBX", false);
+
+    EXPECT_TRUE(passthrough.IsTypeAllowed(rmc));
+    EXPECT_TRUE(passthrough.IsTypeAllowed(gga));
+    EXPECT_TRUE(passthrough.IsTypeAllowed(pubx));
+    EXPECT_FALSE(passthrough.IsTypeAllowed(txt));
+}
+
+TEST(GnssNmeaPassthroughTest, noClientNothingQueued)
+{
+    GnssNmeaPassthrough passthrough("all", false);
+
+    passthrough.Put(rmc, 1000);
+    EXPECT_EQ((uint64_t)0, passthrough.GetForwardedCount());
+    EXPECT_EQ((uint64_t)0, passthrough.GetFilteredCount());
+}
+
+TEST(GnssNmeaPassthroughTest, deliveredWithReceptionTimestamp)
+{
+    android::sp<NmeaCallback> callback = new NmeaCallback();
+    GnssNmeaPassthrough passthrough("RMC,GGA", false);
+    passthrough.SetCallback(callback);
+
+    passthrough.Put(rmc, 1234567);
+    passthrough.Put(txt, 1234568);
+    passthrough.Put(gga, 1234569);
+
+    ASSERT_TRUE(callback->waitFor(2));
+    std::lock_guard<std::mutex> lock(callback->mLock);
+    ASSERT_EQ((size_t)2, callback->mSentences.size());
+    EXPECT_EQ(std::string(rmc), callback->mSentences[0]);
+    EXPECT_EQ(1234567, callback->mTimestamps[0]);
+    EXPECT_EQ(std::string(gga), callback->mSentences[1]);
+    EXPECT_EQ(1234569, callback->mTimestamps[1]);
+    EXPECT_EQ((uint64_t)1, passthrough.GetFilteredCount());
+}
+
+TEST(GnssNmeaPassthroughTest, perTypeRateLimit)
+{
+    android::sp<NmeaCallback> callback = new NmeaCallback();
+    GnssNmeaPassthrough passthrough("RMC:60000", false);
+    passthrough.SetCallback(callback);
+
+    passthrough.Put(rmc, 1);
+    passthrough.Put(rmc, 2);
+    passthrough.Put(rmc, 3);
+
+    ASSERT_TRUE(callback->waitFor(1));
+    EXPECT_EQ((uint64_t)2, passthrough.GetRateLimitedCount());
+}
+
+TEST(GnssNmeaPassthroughTest, coalescedEpoch)
+{
+    android::sp<NmeaCallback> callback = new NmeaCallback();
+    GnssNmeaPassthrough passthrough("all", true);
+    passthrough.SetCallback(callback);
+
+    passthrough.Put(rmc, 100);
+    passthrough.Put(gga, 101);
+
+    ASSERT_TRUE(callback->waitFor(1));
+    std::lock_guard<std::mutex> lock(callback->mLock);
+    ASSERT_EQ((size_t)1, callback->mSentences.size());
+    EXPECT_EQ(std::string(rmc) + "\r\n" + gga, callback->mSentences[0]);
+    EXPECT_EQ(100, callback->mTimestamps[0]);
+}
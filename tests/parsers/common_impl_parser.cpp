@@ -276,3 +276,24 @@ TEST_F(GnssParserCommonImplTest, testInRangesNegative)
     inRanges(1, 9, 11, 40, value);
     EXPECT_EQ(11, value);
 }
+
+TEST_F(GnssParserCommonImplTest, loadLEUnalignedInput)
+{
+    const uint8_t buf[] = {0xAA, 0x04, 0x03, 0x02, 0x01};
+    EXPECT_EQ((uint32_t)0x01020304, loadLE<uint32_t>(&buf[1]));
+    EXPECT_EQ((uint16_t)0x0304, loadLE<uint16_t>(&buf[1]));
+    EXPECT_EQ((int8_t)-86, loadLE<int8_t>(buf));
+}
+
+TEST_F(GnssParserCommonImplTest, byteSwapAllSizes)
+{
+    EXPECT_EQ((uint8_t)0x12, byteSwap((uint8_t)0x12));
+    EXPECT_EQ((uint16_t)0x3412, byteSwap((uint16_t)0x1234));
+    EXPECT_EQ((int32_t)0x78563412, byteSwap((int32_t)0x12345678));
+    EXPECT_EQ(0xEFCDAB8967452301ull, byteSwap(0x0123456789ABCDEFull));
+
+    const double value = 1.5;
+    EXPECT_EQ(value, byteSwap(byteSwap(value)));
+    const float valueF = -2.25f;
+    EXPECT_EQ(valueF, byteSwap(byteSwap(valueF)));
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LEGACYDECODER_H__
+#define __LEGACYDECODER_H__
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <type_traits>
+
+#include "GnssParserCommonImpl.h"
+
+/*
+ * Reference decoder: the value getValue produced for a little endian field before the loads were
+ * switched to loadLE. The field is assembled from its bytes with shifts, so the reference does not
+ * depend on the byte order of the test host and the parser output can be compared against it.
+ */
+template <typename T>
+static T legacyGetValue(const uint8_t* ptr)
+{
+    typedef std::conditional_t<sizeof(T) == 1, uint8_t,
+            std::conditional_t<sizeof(T) == 2, uint16_t,
+            std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>> Bits;
+
+    Bits bits = 0;
+    for (size_t i = sizeof(T); i > 0; --i) {
+        bits = static_cast<Bits>((static_cast<uint64_t>(bits) << 8) | ptr[i - 1]);
+    }
+
+    T out;
+    memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+class LoadLEProbe : public GnssParserCommonImpl {
+public:
+    using GnssParserCommonImpl::byteSwap;
+    uint8_t retrieveSvInfo(MeasurementCb::GnssData&) final { return NotReady; }
+};
+
+/*!
+ * \brief loadBigEndianBranch - run the big endian branch of loadLE on the test host
+ * \brief the field is copied in the memory image a big endian host has after memcpy, then byteSwap restores it
+ * \param ptr - a pointer to the little endian field
+ */
+template <typename T>
+static T loadBigEndianBranch(const uint8_t* ptr)
+{
+    uint8_t image[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); i++) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        image[i] = ptr[i];
+#else
+        image[i] = ptr[sizeof(T) - 1 - i];
+#endif
+    }
+
+    T value;
+    memcpy(&value, image, sizeof(value));
+    return LoadLEProbe::byteSwap(value);
+}
+
+template <typename T>
+static void expectBigEndianBranchSameAsLegacy(const uint8_t* msg, size_t len)
+{
+    for (size_t offset = 0; offset + sizeof(T) <= len; offset++) {
+        const T expected = legacyGetValue<T>(&msg[offset]);
+        const T actual = loadBigEndianBranch<T>(&msg[offset]);
+        // bitwise comparison, NaN patterns of float fields must match too
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(T))) << "offset " << offset;
+    }
+}
+
+/*!
+ * \brief expectBigEndianBranchSameAsLegacy - compare the byte swapping load with the reference decoder
+ * \brief for every field type the protocol uses, at every offset of the message
+ */
+static inline void expectBigEndianBranchSameAsLegacy(const uint8_t* msg, size_t len)
+{
+    expectBigEndianBranchSameAsLegacy<uint8_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<int8_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<uint16_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<int16_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<uint32_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<int32_t>(msg, len);
+    expectBigEndianBranchSameAsLegacy<float>(msg, len);
+    expectBigEndianBranchSameAsLegacy<double>(msg, len);
+}
+
+#endif // __LEGACYDECODER_H__
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "GnssNavClockParser.h"
+#include "legacy_decoder.h"
 
 // Dump UBX-NAV-CLOCK
 //80 ee 2e 1d  489614976   ITow ms
@@ -144,3 +145,23 @@ TEST_F(GnssNavClockParserTest, checkRetrievedDataFromDumpInput)
     EXPECT_EQ(navClockSample.clockDrift, clock.driftNsps);
     EXPECT_EQ((uint32_t)0, clock.hwClockDiscontinuityCount);
 }
+
+TEST_F(GnssNavClockParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    GnssNavClockParser obj(ubxNavClockDump, sizeof(ubxNavClockDump));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(ClockDone, obj.retrieveSvInfo(data));
+
+    uint32_t iTow = 0;
+    EXPECT_EQ(ClockDone, obj.getEpoch(iTow));
+    EXPECT_EQ(legacyGetValue<uint32_t>(&ubxNavClockDump[0]), iTow);
+    EXPECT_EQ(legacyGetValue<int32_t>(&ubxNavClockDump[4]), data.clock.biasNs);
+    EXPECT_EQ(static_cast<double>(legacyGetValue<int32_t>(&ubxNavClockDump[8])), data.clock.driftNsps);
+    EXPECT_EQ(static_cast<double>(legacyGetValue<uint32_t>(&ubxNavClockDump[12])), data.clock.biasUncertaintyNs);
+    EXPECT_DOUBLE_EQ(legacyGetValue<uint32_t>(&ubxNavClockDump[16]) * 1e-3, data.clock.driftUncertaintyNsps);
+}
+
+TEST_F(GnssNavClockParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(ubxNavClockDump, sizeof(ubxNavClockDump));
+}
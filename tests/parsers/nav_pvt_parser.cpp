@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <cstring>
+#include <ctime>
+
+#include "GnssNavPvtParser.h"
+#include "legacy_decoder.h"
+
+using ::android::hardware::gnss::V1_0::GnssLocation;
+using ::android::hardware::gnss::V1_0::GnssLocationFlags;
+
+// Synthesized UBX-NAV-PVT (u-blox 8, 92 bytes)
+// 2019-03-14 10:20:30.5 UTC, valid 0x07, 3D fix, gnssFixOK
+// lon 139.7, lat 35.68, height 45.123 m, hAcc 1.5 m, vAcc 2.5 m
+// gSpeed 0.223 m/s, headMot 90 deg, sAcc 0.12 m/s, headAcc 5 deg
+static const uint8_t ubxNavPvtDump[] = {
+    0x00, 0xca, 0x5b, 0x07, 0xe3, 0x07, 0x03, 0x0e,
+    0x0a, 0x14, 0x1e, 0x07, 0x19, 0x00, 0x00, 0x00,
+    0x00, 0x65, 0xcd, 0x1d, 0x03, 0x01, 0x0a, 0x09,
+    0x40, 0x87, 0x44, 0x53, 0x00, 0x56, 0x44, 0x15,
+    0x43, 0xb0, 0x00, 0x00, 0xe0, 0x2e, 0x00, 0x00,
+    0xdc, 0x05, 0x00, 0x00, 0xc4, 0x09, 0x00, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00,
+    0xce, 0xff, 0xff, 0xff, 0xdf, 0x00, 0x00, 0x00,
+    0x40, 0x54, 0x89, 0x00, 0x78, 0x00, 0x00, 0x00,
+    0x20, 0xa1, 0x07, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00 };
+
+static const size_t fixTypeOffset = 20;
+static const size_t flagsOffset = 21;
+static const size_t validOffset = 11;
+static const uint16_t ublox7PayloadLen = 84;
+
+class GnssNavPvtParserTest : public GnssNavPvtParser, public ::testing::Test {
+protected:
+    void SetUp() {}
+};
+
+TEST_F(GnssNavPvtParserTest, createObjFromNullPayloadNoLocation)
+{
+    GnssNavPvtParser obj(nullptr, (uint16_t)sizeof(ubxNavPvtDump));
+    GnssLocation location = {};
+    ASSERT_FALSE(obj.getLocation(location));
+}
+
+TEST_F(GnssNavPvtParserTest, createObjFromDumpWrongLengthNoLocation)
+{
+    GnssNavPvtParser obj(ubxNavPvtDump, (uint16_t)(sizeof(ubxNavPvtDump) - 1));
+    GnssLocation location = {};
+    ASSERT_FALSE(obj.getLocation(location));
+}
+
+TEST_F(GnssNavPvtParserTest, createObjFromDumpRetrieveNotReady)
+{
+    GnssNavPvtParser obj(ubxNavPvtDump, (uint16_t)sizeof(ubxNavPvtDump));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavPvtParserTest, checkLocationFromDumpInput)
+{
+    GnssNavPvtParser obj(ubxNavPvtDump, (uint16_t)sizeof(ubxNavPvtDump));
+    GnssLocation location = {};
+    ASSERT_TRUE(obj.getLocation(location));
+
+    const uint16_t expectedFlags = GnssLocationFlags::HAS_LAT_LONG | GnssLocationFlags::HAS_ALTITUDE |
+                                   GnssLocationFlags::HAS_SPEED | GnssLocationFlags::HAS_BEARING |
+                                   GnssLocationFlags::HAS_HORIZONTAL_ACCURACY |
+                                   GnssLocationFlags::HAS_VERTICAL_ACCURACY |
+                                   GnssLocationFlags::HAS_SPEED_ACCURACY |
+                                   GnssLocationFlags::HAS_BEARING_ACCURACY;
+    EXPECT_EQ(expectedFlags, location.gnssLocationFlags);
+    EXPECT_EQ(1552558830500, location.timestamp);
+    EXPECT_NEAR(35.68, location.latitudeDegrees, 1e-7);
+    EXPECT_NEAR(139.7, location.longitudeDegrees, 1e-7);
+    EXPECT_NEAR(45.123, location.altitudeMeters, 1e-6);
+    EXPECT_FLOAT_EQ(0.223f, location.speedMetersPerSec);
+    EXPECT_FLOAT_EQ(90.0f, location.bearingDegrees);
+    EXPECT_FLOAT_EQ(1.5f, location.horizontalAccuracyMeters);
+    EXPECT_FLOAT_EQ(2.5f, location.verticalAccuracyMeters);
+    EXPECT_FLOAT_EQ(0.12f, location.speedAccuracyMetersPerSecond);
+    EXPECT_FLOAT_EQ(5.0f, location.bearingAccuracyDegrees);
+}
+
+TEST_F(GnssNavPvtParserTest, checkLocationFromUblox7Length)
+{
+    GnssNavPvtParser obj(ubxNavPvtDump, ublox7PayloadLen);
+    GnssLocation location = {};
+    ASSERT_TRUE(obj.getLocation(location));
+    EXPECT_NEAR(35.68, location.latitudeDegrees, 1e-7);
+}
+
+TEST_F(GnssNavPvtParserTest, checkNo3dFixNoLocation)
+{
+    uint8_t dump[sizeof(ubxNavPvtDump)];
+    memcpy(dump, ubxNavPvtDump, sizeof(dump));
+    dump[fixTypeOffset] = 2;
+
+    GnssNavPvtParser obj(dump, (uint16_t)sizeof(dump));
+    GnssLocation location = {};
+    ASSERT_FALSE(obj.getLocation(location));
+
+    // the time is still reported for the void RMC
+    GnssNavPvtParser fixed(ubxNavPvtDump, (uint16_t)sizeof(ubxNavPvtDump));
+    ASSERT_TRUE(fixed.getLocation(location));
+    EXPECT_EQ(location.timestamp, obj.getUtcTimeMs());
+}
+
+TEST_F(GnssNavPvtParserTest, checkFixNotOkNoLocation)
+{
+    uint8_t dump[sizeof(ubxNavPvtDump)];
+    memcpy(dump, ubxNavPvtDump, sizeof(dump));
+    dump[flagsOffset] = 0;
+
+    GnssNavPvtParser obj(dump, (uint16_t)sizeof(dump));
+    GnssLocation location = {};
+    ASSERT_FALSE(obj.getLocation(location));
+}
+
+TEST_F(GnssNavPvtParserTest, checkInvalidTimeNoLocation)
+{
+    uint8_t dump[sizeof(ubxNavPvtDump)];
+    memcpy(dump, ubxNavPvtDump, sizeof(dump));
+    dump[validOffset] = 0x01;
+
+    GnssNavPvtParser obj(dump, (uint16_t)sizeof(dump));
+    GnssLocation location = {};
+    ASSERT_FALSE(obj.getLocation(location));
+    EXPECT_EQ(-1, obj.getUtcTimeMs());
+}
+
+TEST_F(GnssNavPvtParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    const uint8_t* msg = ubxNavPvtDump;
+    GnssNavPvtParser obj(msg, (uint16_t)sizeof(ubxNavPvtDump));
+    GnssLocation location = {};
+    ASSERT_TRUE(obj.getLocation(location));
+
+    struct tm t = {};
+    t.tm_year = legacyGetValue<uint16_t>(&msg[4]) - 1900;
+    t.tm_mon = legacyGetValue<uint8_t>(&msg[6]) - 1;
+    t.tm_mday = legacyGetValue<uint8_t>(&msg[7]);
+    t.tm_hour = legacyGetValue<uint8_t>(&msg[8]);
+    t.tm_min = legacyGetValue<uint8_t>(&msg[9]);
+    t.tm_sec = legacyGetValue<uint8_t>(&msg[10]);
+    const int64_t timestampMs = static_cast<int64_t>(timegm(&t)) * 1000 + legacyGetValue<int32_t>(&msg[16]) / 1000000;
+
+    EXPECT_EQ(timestampMs, location.timestamp);
+    EXPECT_EQ(timestampMs, obj.getUtcTimeMs());
+    EXPECT_DOUBLE_EQ(legacyGetValue<int32_t>(&msg[24]) * 1e-7, location.longitudeDegrees);
+    EXPECT_DOUBLE_EQ(legacyGetValue<int32_t>(&msg[28]) * 1e-7, location.latitudeDegrees);
+    EXPECT_DOUBLE_EQ(legacyGetValue<int32_t>(&msg[32]) * 1e-3, location.altitudeMeters);
+    EXPECT_DOUBLE_EQ(legacyGetValue<int32_t>(&msg[36]) * 1e-3, obj.getAltitudeMslMeters());
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<uint32_t>(&msg[40]) * 1e-3), location.horizontalAccuracyMeters);
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<uint32_t>(&msg[44]) * 1e-3), location.verticalAccuracyMeters);
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<int32_t>(&msg[60]) * 1e-3), location.speedMetersPerSec);
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<int32_t>(&msg[64]) * 1e-5), location.bearingDegrees);
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<uint32_t>(&msg[68]) * 1e-3),
+                    location.speedAccuracyMetersPerSecond);
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<uint32_t>(&msg[72]) * 1e-5), location.bearingAccuracyDegrees);
+    EXPECT_EQ(legacyGetValue<uint8_t>(&msg[23]), obj.getNumSv());
+    EXPECT_FLOAT_EQ(static_cast<float>(legacyGetValue<uint16_t>(&msg[76]) * 1e-2), obj.getPDop());
+}
+
+TEST_F(GnssNavPvtParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(ubxNavPvtDump, sizeof(ubxNavPvtDump));
+}
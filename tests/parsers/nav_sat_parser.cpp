@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <vector>
+
+#include "GnssNavSatParser.h"
+#include "legacy_decoder.h"
+
+using ::android::hardware::gnss::V1_0::GnssConstellationType;
+using ::android::hardware::gnss::V1_0::IGnssCallback;
+
+// Synthesized UBX-NAV-SAT, version 1, 4 SVs
+// GPS 5:      cno 40, elev 45, azim 270, used, eph + alm
+// GLONASS 3:  cno 30, elev 10, azim 90, eph
+// GLONASS ?:  cno 20, unknown slot (255), must be skipped
+// QZSS 1:     cno 35, elev 60, azim 180, alm
+static const uint8_t ubxNavSatDump[] = {
+    0x10, 0x27, 0x00, 0x00, 0x01, 0x04, 0x00, 0x00,
+    0x00, 0x05, 0x28, 0x2d, 0x0e, 0x01, 0x00, 0x00, 0x08, 0x18, 0x00, 0x00,
+    0x06, 0x03, 0x1e, 0x0a, 0x5a, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+    0x06, 0xff, 0x14, 0x05, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x05, 0x01, 0x23, 0x3c, 0xb4, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00 };
+
+// Synthesized UBX-NAV-SVINFO, 3 channels
+// svid 12  -> GPS 12,     cno 42, used, ephemeris
+// svid 70  -> GLONASS 6,  cno 33, almanac
+// svid 255 -> GLONASS unknown slot, must be skipped
+static const uint8_t ubxNavSvInfoDump[] = {
+    0x10, 0x27, 0x00, 0x00, 0x03, 0x04, 0x00, 0x00,
+    0x00, 0x0c, 0x09, 0x07, 0x2a, 0x1e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x46, 0x20, 0x04, 0x21, 0x14, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0xff, 0x00, 0x01, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+static const uint8_t carrier = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_CARRIER_FREQUENCY);
+static const uint8_t ephAlmUsed = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA |
+                                                       IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA |
+                                                       IGnssCallback::GnssSvFlags::USED_IN_FIX) | carrier;
+static const uint8_t ephUsed = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA |
+                                                    IGnssCallback::GnssSvFlags::USED_IN_FIX) | carrier;
+static const uint8_t ephOnly = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_EPHEMERIS_DATA) | carrier;
+static const uint8_t almOnly = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA) | carrier;
+
+class GnssNavSatParserTest : public GnssNavSatParser, public ::testing::Test {
+protected:
+    void SetUp() {}
+
+    // NAV-SAT with count GPS SVs, svid i + 1 has cno 10 + i
+    static std::vector<uint8_t> makeGpsNavSat(uint8_t count)
+    {
+        std::vector<uint8_t> msg = {0x10, 0x27, 0x00, 0x00, 0x01, count, 0x00, 0x00};
+        for (uint8_t i = 0; i < count; i++) {
+            const uint8_t block[] = {0x00, static_cast<uint8_t>(i + 1), static_cast<uint8_t>(10 + i), 0x00,
+                                     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+            msg.insert(msg.end(), block, block + sizeof(block));
+        }
+        return msg;
+    }
+};
+
+TEST_F(GnssNavSatParserTest, createObjFromNullPayloadNoStatus)
+{
+    GnssNavSatParser obj(Format::NavSat, nullptr, (uint16_t)sizeof(ubxNavSatDump));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_FALSE(obj.getSvStatus(status));
+}
+
+TEST_F(GnssNavSatParserTest, createObjFromDumpWrongLengthNoStatus)
+{
+    GnssNavSatParser obj(Format::NavSat, ubxNavSatDump, (uint16_t)(sizeof(ubxNavSatDump) - 1));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_FALSE(obj.getSvStatus(status));
+}
+
+TEST_F(GnssNavSatParserTest, createObjFromDumpRetrieveNotReady)
+{
+    GnssNavSatParser obj(Format::NavSat, ubxNavSatDump, (uint16_t)sizeof(ubxNavSatDump));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavSatParserTest, checkSvStatusFromNavSatDump)
+{
+    GnssNavSatParser obj(Format::NavSat, ubxNavSatDump, (uint16_t)sizeof(ubxNavSatDump));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_TRUE(obj.getSvStatus(status));
+    ASSERT_EQ(3u, status.numSvs);
+
+    EXPECT_EQ(GnssConstellationType::GPS, status.gnssSvList[0].constellation);
+    EXPECT_EQ(5, status.gnssSvList[0].svid);
+    EXPECT_FLOAT_EQ(40.f, status.gnssSvList[0].cN0Dbhz);
+    EXPECT_FLOAT_EQ(45.f, status.gnssSvList[0].elevationDegrees);
+    EXPECT_FLOAT_EQ(270.f, status.gnssSvList[0].azimuthDegrees);
+    EXPECT_EQ(ephAlmUsed, status.gnssSvList[0].svFlag);
+
+    EXPECT_EQ(GnssConstellationType::GLONASS, status.gnssSvList[1].constellation);
+    EXPECT_EQ(3, status.gnssSvList[1].svid);
+    EXPECT_EQ(ephOnly, status.gnssSvList[1].svFlag);
+
+    EXPECT_EQ(GnssConstellationType::QZSS, status.gnssSvList[2].constellation);
+    EXPECT_EQ(193, status.gnssSvList[2].svid);
+    EXPECT_EQ(almOnly, status.gnssSvList[2].svFlag);
+}
+
+TEST_F(GnssNavSatParserTest, checkSvStatusFromNavSvInfoDump)
+{
+    GnssNavSatParser obj(Format::NavSvInfo, ubxNavSvInfoDump, (uint16_t)sizeof(ubxNavSvInfoDump));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_TRUE(obj.getSvStatus(status));
+    ASSERT_EQ(2u, status.numSvs);
+
+    EXPECT_EQ(GnssConstellationType::GPS, status.gnssSvList[0].constellation);
+    EXPECT_EQ(12, status.gnssSvList[0].svid);
+    EXPECT_FLOAT_EQ(42.f, status.gnssSvList[0].cN0Dbhz);
+    EXPECT_FLOAT_EQ(30.f, status.gnssSvList[0].elevationDegrees);
+    EXPECT_FLOAT_EQ(60.f, status.gnssSvList[0].azimuthDegrees);
+    EXPECT_EQ(ephUsed, status.gnssSvList[0].svFlag);
+
+    EXPECT_EQ(GnssConstellationType::GLONASS, status.gnssSvList[1].constellation);
+    EXPECT_EQ(6, status.gnssSvList[1].svid);
+    EXPECT_EQ(almOnly, status.gnssSvList[1].svFlag);
+}
+
+TEST_F(GnssNavSatParserTest, checkCarrierFrequencyPerConstellation)
+{
+    GnssNavSatParser obj(Format::NavSat, ubxNavSatDump, (uint16_t)sizeof(ubxNavSatDump));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_TRUE(obj.getSvStatus(status));
+    ASSERT_EQ(3u, status.numSvs);
+
+    EXPECT_FLOAT_EQ(1575.42e6f, status.gnssSvList[0].carrierFrequencyHz);   // GPS L1
+    EXPECT_FLOAT_EQ(1602.562e6f, status.gnssSvList[1].carrierFrequencyHz);  // GLONASS L1
+    EXPECT_FLOAT_EQ(1575.42e6f, status.gnssSvList[2].carrierFrequencyHz);   // QZSS L1
+
+    // svid 159 -> BeiDou B1
+    const uint8_t msg[] = {
+        0x10, 0x27, 0x00, 0x00, 0x01, 0x04, 0x00, 0x00,
+        0x00, 0x9f, 0x00, 0x04, 0x26, 0x1e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    GnssNavSatParser svInfo(Format::NavSvInfo, msg, (uint16_t)sizeof(msg));
+    ASSERT_TRUE(svInfo.getSvStatus(status));
+    ASSERT_EQ(1u, status.numSvs);
+    EXPECT_FLOAT_EQ(1561.098e6f, status.gnssSvList[0].carrierFrequencyHz);
+    EXPECT_EQ(carrier, status.gnssSvList[0].svFlag & carrier);
+}
+
+TEST_F(GnssNavSatParserTest, checkNavSvInfoBeidouNumbering)
+{
+    // svid 33 -> B6, svid 64 -> B37, svid 159 -> B1
+    const uint8_t msg[] = {
+        0x10, 0x27, 0x00, 0x00, 0x03, 0x04, 0x00, 0x00,
+        0x00, 0x21, 0x00, 0x04, 0x28, 0x1e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x40, 0x00, 0x04, 0x27, 0x1e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x02, 0x9f, 0x00, 0x04, 0x26, 0x1e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    GnssNavSatParser obj(Format::NavSvInfo, msg, (uint16_t)sizeof(msg));
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_TRUE(obj.getSvStatus(status));
+    ASSERT_EQ(3u, status.numSvs);
+
+    const int16_t expected[] = {6, 37, 1};
+    for (uint32_t i = 0; i < status.numSvs; i++) {
+        EXPECT_EQ(GnssConstellationType::BEIDOU, status.gnssSvList[i].constellation);
+        EXPECT_EQ(expected[i], status.gnssSvList[i].svid);
+    }
+}
+
+TEST_F(GnssNavSatParserTest, checkOverflowKeepsStrongest)
+{
+    const uint8_t count = 70;
+    std::vector<uint8_t> msg = makeGpsNavSat(count);
+
+    GnssNavSatParser obj(Format::NavSat, msg.data(), (uint16_t)msg.size());
+    IGnssCallback::GnssSvStatus status = {};
+    ASSERT_TRUE(obj.getSvStatus(status));
+    ASSERT_EQ(64u, status.numSvs);
+
+    // svid 1..6 are the weakest and must be dropped
+    for (uint32_t i = 0; i < status.numSvs; i++) {
+        EXPECT_GT(status.gnssSvList[i].svid, 6);
+    }
+}
+
+TEST_F(GnssNavSatParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    // {format, dump, size, cno, elev, azim offsets in the block}
+    const struct {
+        Format format;
+        const uint8_t* msg;
+        size_t len;
+        size_t cno;
+        size_t elev;
+        size_t azim;
+    } dumps[] = {
+        {Format::NavSat, ubxNavSatDump, sizeof(ubxNavSatDump), 2, 3, 4},
+        {Format::NavSvInfo, ubxNavSvInfoDump, sizeof(ubxNavSvInfoDump), 4, 5, 6},
+    };
+
+    for (const auto& dump : dumps) {
+        GnssNavSatParser obj(dump.format, dump.msg, (uint16_t)dump.len);
+        IGnssCallback::GnssSvStatus status = {};
+        ASSERT_TRUE(obj.getSvStatus(status));
+
+        // SVs of unknown GLONASS slots are skipped, the others keep the order of the blocks
+        uint32_t sv = 0;
+        for (size_t offset = 8; offset + 12 <= dump.len; offset += 12) {
+            if (0xff == dump.msg[offset + 1]) {
+                continue;
+            }
+            ASSERT_LT(sv, status.numSvs);
+            const IGnssCallback::GnssSvInfo& info = status.gnssSvList[sv++];
+            EXPECT_EQ(legacyGetValue<uint8_t>(&dump.msg[offset + dump.cno]), info.cN0Dbhz);
+            EXPECT_EQ(legacyGetValue<int8_t>(&dump.msg[offset + dump.elev]), info.elevationDegrees);
+            EXPECT_EQ(legacyGetValue<int16_t>(&dump.msg[offset + dump.azim]), info.azimuthDegrees);
+        }
+        EXPECT_EQ(sv, status.numSvs);
+    }
+}
+
+TEST_F(GnssNavSatParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(ubxNavSatDump, sizeof(ubxNavSatDump));
+    expectBigEndianBranchSameAsLegacy(ubxNavSvInfoDump, sizeof(ubxNavSvInfoDump));
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssNavStatusParser.h"
+#include "legacy_decoder.h"
+
+// Dump UBX-NAV-STATUS
+//80 ee 2e 1d  489614976   ITow ms
+//03           3           gpsFix: 3D
+//dd 00 08     flags, fixStat, flags2
+//9e 6e 00 00  28318       ttff ms
+//87 d6 12 00  1234567     msss ms
+static const uint8_t ubxNavStatusDump[] = {
+    0x80, 0xee, 0x2e, 0x1d,
+    0x03, 0xdd, 0x00, 0x08,
+    0x9e, 0x6e, 0x00, 0x00,
+    0x87, 0xd6, 0x12, 0x00 };
+
+class GnssNavStatusParserTest : public GnssNavStatusParser, public ::testing::Test {
+protected:
+    void SetUp() {}
+};
+
+TEST_F(GnssNavStatusParserTest, createObjFromNullPayloadRetrieveNotReady)
+{
+    GnssNavStatusParser obj(nullptr, (uint16_t)sizeof(ubxNavStatusDump));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavStatusParserTest, createObjFromDumpWrongLengthRetrieveNotReady)
+{
+    GnssNavStatusParser obj(ubxNavStatusDump, (uint16_t)(sizeof(ubxNavStatusDump) + 1));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavStatusParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    const uint8_t* msg = ubxNavStatusDump;
+    GnssNavStatusParser obj(msg, (uint16_t)sizeof(ubxNavStatusDump));
+    MeasurementCb::GnssData data;
+    data.clock.gnssClockFlags = 0;
+    ASSERT_EQ(StatusDone, obj.retrieveSvInfo(data));
+
+    uint32_t iTow = 0;
+    EXPECT_EQ(StatusDone, obj.getEpoch(iTow));
+    EXPECT_EQ(legacyGetValue<uint32_t>(&msg[0]), iTow);
+    EXPECT_EQ(legacyGetValue<uint32_t>(&msg[12]) * 1000000LL, data.clock.timeNs);
+}
+
+TEST_F(GnssNavStatusParserTest, fullBiasFollowsTimeSinceStartup)
+{
+    GnssNavStatusParser obj(ubxNavStatusDump, (uint16_t)sizeof(ubxNavStatusDump));
+    MeasurementCb::GnssData data;
+    data.clock.gnssClockFlags = static_cast<uint16_t>(MeasurementCb::GnssClockFlags::HAS_FULL_BIAS);
+    data.clock.timeNs = 1;
+    data.clock.fullBiasNs = -1000;
+    ASSERT_EQ(StatusDone, obj.retrieveSvInfo(data));
+
+    // GPS time = timeNs - fullBiasNs is kept
+    EXPECT_EQ(1001, data.clock.timeNs - data.clock.fullBiasNs);
+}
+
+TEST_F(GnssNavStatusParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(ubxNavStatusDump, sizeof(ubxNavStatusDump));
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <cstring>
+
+#include "GnssNavTimeGPSParser.h"
+#include "legacy_decoder.h"
+
+// Dump UBX-NAV-TIMEGPS
+//80 ee 2e 1d  489614976   ITow ms
+//4c 97 fc ff  -223412     fTow ns
+//fb 07        2043        week
+//12           18          leap seconds
+//07           0x07        valid: tow, week, leapS
+//d0 03 00 00  976         tAcc ns
+static const uint8_t ubxNavTimeGpsDump[] = {
+    0x80, 0xee, 0x2e, 0x1d,
+    0x4c, 0x97, 0xfc, 0xff,
+    0xfb, 0x07, 0x12, 0x07,
+    0xd0, 0x03, 0x00, 0x00 };
+
+static const size_t validOffset = 11;
+
+class GnssNavTimeGPSParserTest : public GnssNavTimeGPSParser, public ::testing::Test {
+protected:
+    void SetUp() {}
+};
+
+TEST_F(GnssNavTimeGPSParserTest, createObjFromNullPayloadRetrieveNotReady)
+{
+    GnssNavTimeGPSParser obj(nullptr, (uint16_t)sizeof(ubxNavTimeGpsDump));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavTimeGPSParserTest, createObjFromDumpWrongLengthRetrieveNotReady)
+{
+    GnssNavTimeGPSParser obj(ubxNavTimeGpsDump, (uint16_t)(sizeof(ubxNavTimeGpsDump) - 1));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavTimeGPSParserTest, checkRetrieveNotReadyInvalidWeekFlag)
+{
+    uint8_t msg[sizeof(ubxNavTimeGpsDump)];
+    memcpy(msg, ubxNavTimeGpsDump, sizeof(msg));
+    msg[validOffset] = 0x05;
+
+    GnssNavTimeGPSParser obj(msg, (uint16_t)sizeof(msg));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssNavTimeGPSParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    const uint8_t* msg = ubxNavTimeGpsDump;
+    GnssNavTimeGPSParser obj(msg, (uint16_t)sizeof(ubxNavTimeGpsDump));
+    MeasurementCb::GnssData data;
+    data.clock.timeNs = 0;
+    ASSERT_EQ(GPSTimeDone, obj.retrieveSvInfo(data));
+
+    uint32_t iTow = 0;
+    EXPECT_EQ(GPSTimeDone, obj.getEpoch(iTow));
+    EXPECT_EQ(legacyGetValue<uint32_t>(&msg[0]), iTow);
+
+    // Without a receiver clock the time is 1 ns, the full bias carries the GPS time
+    const int64_t gpsTimeNs = legacyGetValue<int16_t>(&msg[8]) * 604800000LL * 1000000LL +
+                              legacyGetValue<uint32_t>(&msg[0]) * 1000000LL + legacyGetValue<int32_t>(&msg[4]);
+    EXPECT_EQ(1, data.clock.timeNs);
+    EXPECT_EQ(1 - gpsTimeNs, data.clock.fullBiasNs);
+    EXPECT_EQ(static_cast<double>(legacyGetValue<uint32_t>(&msg[12])), data.clock.timeUncertaintyNs);
+    EXPECT_EQ(legacyGetValue<int8_t>(&msg[10]), data.clock.leapSecond);
+    EXPECT_NE(0, data.clock.gnssClockFlags & MeasurementCb::GnssClockFlags::HAS_LEAP_SECOND);
+}
+
+TEST_F(GnssNavTimeGPSParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(ubxNavTimeGpsDump, sizeof(ubxNavTimeGpsDump));
+}
@@ -1,9 +1,11 @@
 #define LOG_TAG "GnssHalTesting"
 #include <gtest/gtest.h>
 #include <log/log.h>
+#include <ctime>
 #include <string>
 
 #include "GnssNavTimeUTCParser.h"
+#include "legacy_decoder.h"
 #include "GnssMeasQueue.h"
 
 static const uint8_t navTimeUtcDump[] = {
@@ -151,3 +153,33 @@ TEST_F(GnssNavTimeUTCParserTest, checkRetrieveNotReadyInvalidZeroFlag)
     ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
 }
 
+TEST_F(GnssNavTimeUTCParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    const uint8_t* msg = navTimeUtcDump;
+    mPayload = msg;
+    mPayloadLen = sizeof(navTimeUtcDump);
+    parseNavTimeUTCMsg();
+    ASSERT_TRUE(mValid);
+
+    EXPECT_EQ(legacyGetValue<uint32_t>(&msg[0]), data.iTow);
+    EXPECT_EQ(legacyGetValue<uint32_t>(&msg[4]), data.timeAccuracy);
+    EXPECT_EQ(legacyGetValue<int32_t>(&msg[8]), data.nanoSecondFraction);
+    EXPECT_EQ(legacyGetValue<uint16_t>(&msg[12]), data.year);
+    EXPECT_EQ(legacyGetValue<uint8_t>(&msg[19]), data.flags);
+
+    struct tm t = {};
+    t.tm_year = legacyGetValue<uint16_t>(&msg[12]) - 1900;
+    t.tm_mon = legacyGetValue<uint8_t>(&msg[14]) - 1;
+    t.tm_mday = legacyGetValue<uint8_t>(&msg[15]);
+    t.tm_hour = legacyGetValue<uint8_t>(&msg[16]);
+    t.tm_min = legacyGetValue<uint8_t>(&msg[17]);
+    t.tm_sec = legacyGetValue<uint8_t>(&msg[18]);
+    t.tm_isdst = -1;
+    const int64_t expectedNs = static_cast<int64_t>(mktime(&t)) * 1000000000 + legacyGetValue<int32_t>(&msg[8]);
+    EXPECT_EQ(expectedNs, timeNano);
+}
+
+TEST_F(GnssNavTimeUTCParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(navTimeUtcDump, sizeof(navTimeUtcDump));
+}
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "GnssRxmMeasxParser.h"
+#include "legacy_decoder.h"
 #include <android/hardware/gnss/1.0/IGnss.h>
 
 
@@ -438,3 +439,79 @@ TEST_F(GnssRxmMeasxParserTest, testGetValidSvidForGnssIdNegative) {
     EXPECT_EQ(glonassFcnFirst, getValidSvidForGnssId(UbxGnssId::GLONASS, glonassLast + 1));
     EXPECT_EQ(glonassFcnFirst, getValidSvidForGnssId(UbxGnssId::GLONASS, 0xff));
 }
+
+TEST_F(GnssRxmMeasxParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    MeasurementCb::GnssData data;
+    GnssRxmMeasxParser parser(rxmMeasxMsg, sizeof(rxmMeasxMsg));
+    ASSERT_EQ(GnssIParser::RxmDone, parser.retrieveSvInfo(data));
+    ASSERT_EQ(legacyGetValue<uint8_t>(&rxmMeasxMsg[34]), data.measurementCount);
+
+    uint32_t iTow = 0;
+    EXPECT_EQ(GnssIParser::RxmDone, parser.getEpoch(iTow));
+    const uint32_t gpsTow = legacyGetValue<uint32_t>(&rxmMeasxMsg[4]);
+    EXPECT_EQ(gpsTow, iTow);
+
+    // All SVs of the recorded message are GPS
+    for (uint32_t i = 0; i < data.measurementCount; ++i) {
+        const uint8_t* block = &rxmMeasxMsg[singleBlockSize + i * repeatedBlockSize];
+        EXPECT_EQ(legacyGetValue<uint8_t>(&block[1]), data.measurements[i].svid);
+        EXPECT_EQ(legacyGetValue<uint8_t>(&block[2]), data.measurements[i].cN0DbHz);
+        EXPECT_EQ(legacyGetValue<int32_t>(&block[4]) * 0.04, data.measurements[i].pseudorangeRateMps);
+        EXPECT_EQ(static_cast<int64_t>(gpsTow) * 1000000, data.measurements[i].receivedSvTimeInNs);
+    }
+}
+
+TEST_F(GnssRxmMeasxParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    expectBigEndianBranchSameAsLegacy(rxmMeasxMsg, sizeof(rxmMeasxMsg));
+}
+
+TEST_F(GnssRxmMeasxParserTest, retrieveDataMixedConstellations)
+{
+    uint8_t sampleInput[44 + 3 * 24] = {};
+    sampleInput[4] = 0x10;  // gpsTOW
+    sampleInput[8] = 0x20;  // glonassTOW
+    sampleInput[12] = 0x30; // bdsTOW
+    sampleInput[34] = 3;    // numSvs
+    sampleInput[35] = 1;    // TOWset
+
+    const uint8_t gnssIds[] = {UbxGnssId::GLONASS, UbxGnssId::BEIDOU, 9};
+    const uint8_t svIds[] = {0, 5, 7};
+    for (size_t i = 0; i < sizeof(gnssIds); i++) {
+        uint8_t* block = &sampleInput[44 + i * 24];
+        block[0] = gnssIds[i];
+        block[1] = svIds[i];
+        block[2] = static_cast<uint8_t>(20 + i);
+        block[4] = 0xFF; // pseudorangeRate = -1
+        block[5] = 0xFF;
+        block[6] = 0xFF;
+        block[7] = 0xFF;
+    }
+
+    GnssRxmMeasxParser parser(sampleInput, sizeof(sampleInput));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(GnssIParser::RxmDone, parser.retrieveSvInfo(data));
+    ASSERT_EQ((uint32_t)3, data.measurementCount);
+
+    EXPECT_EQ(CnstlType::GLONASS, data.measurements[0].constellation);
+    EXPECT_EQ(93, data.measurements[0].svid);
+    EXPECT_EQ(0x20 * 1000000ll, data.measurements[0].receivedSvTimeInNs);
+    EXPECT_EQ(mStateFlags, data.measurements[0].state);
+    EXPECT_FLOAT_EQ(1602.562e6f, data.measurements[0].carrierFrequencyHz);
+
+    EXPECT_EQ(CnstlType::BEIDOU, data.measurements[1].constellation);
+    EXPECT_EQ(5, data.measurements[1].svid);
+    EXPECT_EQ(0x30 * 1000000ll, data.measurements[1].receivedSvTimeInNs);
+    EXPECT_FLOAT_EQ(1561.098e6f, data.measurements[1].carrierFrequencyHz);
+    EXPECT_EQ(21.0, data.measurements[1].cN0DbHz);
+    EXPECT_EQ(-0.04, data.measurements[1].pseudorangeRateMps);
+
+    EXPECT_EQ(CnstlType::UNKNOWN, data.measurements[2].constellation);
+    EXPECT_EQ(7, data.measurements[2].svid);
+    EXPECT_EQ((uint32_t)MeasurementCb::GnssMeasurementState::STATE_UNKNOWN,
+              data.measurements[2].state);
+    EXPECT_EQ((uint32_t)0, data.measurements[2].flags);
+    EXPECT_EQ(MeasurementCb::GnssMultipathIndicator::INDICATIOR_NOT_PRESENT,
+              data.measurements[2].multipathIndicator);
+}
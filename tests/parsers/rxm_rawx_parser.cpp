@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "GnssRxmRawxParser.h"
+#include "legacy_decoder.h"
+
+static const double speedOfLight = 299792458.0;
+static const double l1Wavelength = speedOfLight / 1575.42e6;
+
+struct RawxMeas {
+    double prMes;
+    double cpMes;
+    float doMes;
+    uint8_t gnssId;
+    uint8_t svId;
+    uint8_t freqId;
+    uint16_t locktime;
+    uint8_t cno;
+    uint8_t trkStat;
+};
+
+class GnssRxmRawxParserTest : public GnssRxmRawxParser, public ::testing::Test {
+protected:
+    void SetUp() {}
+
+    // Synthesized capture: rcvTow, week 2043, leapS 18, prStdev 2^10 * 0.01 m,
+    // cpStdev 5 * 0.004 cycles, doStdev 2^4 * 0.002 Hz
+    static std::vector<uint8_t> makeRawx(double rcvTow, const std::vector<RawxMeas>& meas)
+    {
+        std::vector<uint8_t> msg(mHeaderSize + meas.size() * mBlockSize, 0);
+        const uint16_t week = 2043;
+
+        memcpy(&msg[0], &rcvTow, sizeof(rcvTow));
+        memcpy(&msg[8], &week, sizeof(week));
+        msg[10] = 18;
+        msg[11] = static_cast<uint8_t>(meas.size());
+        msg[12] = 0x01;
+
+        for (size_t i = 0; i < meas.size(); i++) {
+            uint8_t* block = &msg[mHeaderSize + i * mBlockSize];
+            memcpy(&block[0], &meas[i].prMes, sizeof(double));
+            memcpy(&block[8], &meas[i].cpMes, sizeof(double));
+            memcpy(&block[16], &meas[i].doMes, sizeof(float));
+            block[20] = meas[i].gnssId;
+            block[21] = meas[i].svId;
+            block[23] = meas[i].freqId;
+            memcpy(&block[24], &meas[i].locktime, sizeof(uint16_t));
+            block[26] = meas[i].cno;
+            block[27] = 10;
+            block[28] = 5;
+            block[29] = 4;
+            block[30] = meas[i].trkStat;
+        }
+
+        return msg;
+    }
+};
+
+TEST_F(GnssRxmRawxParserTest, createObjFromNullPayloadRetrieveNotReady)
+{
+    GnssRxmRawxParser obj(nullptr, 0);
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssRxmRawxParserTest, createObjFromWrongLengthRetrieveNotReady)
+{
+    std::vector<uint8_t> msg = makeRawx(100.0, {{2.2e7, 1.1e8, 1000.f, GPS, 5, 0, 500, 40, 0x03}});
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size() - 1));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(NotReady, obj.retrieveSvInfo(data));
+}
+
+TEST_F(GnssRxmRawxParserTest, checkGpsMeasurement)
+{
+    const double rcvTow = 100.0;
+    const double prMes = 2.2e7;
+    const double cpMes = 1.15e8 + 0.25;
+    std::vector<uint8_t> msg = makeRawx(rcvTow, {{prMes, cpMes, 1000.f, GPS, 5, 0, 500, 40, 0x03}});
+
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(RxmDone, obj.retrieveSvInfo(data));
+    ASSERT_EQ(1u, data.measurementCount);
+
+    const MeasurementCb::GnssMeasurement& m = data.measurements[0];
+    EXPECT_EQ(CnstlType::GPS, m.constellation);
+    EXPECT_EQ(5, m.svid);
+    EXPECT_DOUBLE_EQ(40.0, m.cN0DbHz);
+    EXPECT_NEAR((rcvTow - prMes / speedOfLight) * 1e9, static_cast<double>(m.receivedSvTimeInNs), 1.0);
+    EXPECT_NE(0u, m.state & MeasurementCb::GnssMeasurementState::STATE_TOW_DECODED);
+    EXPECT_EQ(llround(10.24 / speedOfLight * 1e9), m.receivedSvTimeUncertaintyInNs);
+    EXPECT_NEAR(-1000.0 * l1Wavelength, m.pseudorangeRateMps, 1e-9);
+    EXPECT_NEAR(0.032 * l1Wavelength, m.pseudorangeRateUncertaintyMps, 1e-9);
+    EXPECT_NEAR(cpMes * l1Wavelength, m.accumulatedDeltaRangeM, 1e-6);
+    EXPECT_NEAR(0.02 * l1Wavelength, m.accumulatedDeltaRangeUncertaintyM, 1e-9);
+    EXPECT_EQ(static_cast<uint16_t>(MeasurementCb::GnssAccumulatedDeltaRangeState::ADR_STATE_VALID),
+              m.accumulatedDeltaRangeState);
+    EXPECT_NEAR(0.25, m.carrierPhase, 1e-6);
+    EXPECT_NE(0u, m.flags & MeasurementCb::GnssMeasurementFlags::HAS_CARRIER_PHASE);
+}
+
+TEST_F(GnssRxmRawxParserTest, checkInvalidCarrierPhaseAndLockReset)
+{
+    std::vector<uint8_t> msg = makeRawx(100.0, {{2.2e7, 0.0, 0.f, GPS, 5, 0, 0, 40, 0x01},
+                                                {2.2e7, 1.0e8, 0.f, GPS, 6, 0, 0, 40, 0x03}});
+
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(RxmDone, obj.retrieveSvInfo(data));
+    ASSERT_EQ(2u, data.measurementCount);
+
+    EXPECT_EQ(static_cast<uint16_t>(MeasurementCb::GnssAccumulatedDeltaRangeState::ADR_STATE_UNKNOWN),
+              data.measurements[0].accumulatedDeltaRangeState);
+    EXPECT_EQ(static_cast<uint16_t>(MeasurementCb::GnssAccumulatedDeltaRangeState::ADR_STATE_VALID |
+                                    MeasurementCb::GnssAccumulatedDeltaRangeState::ADR_STATE_RESET),
+              data.measurements[1].accumulatedDeltaRangeState);
+}
+
+TEST_F(GnssRxmRawxParserTest, checkGlonassUnknownSlotUsesFcn)
+{
+    std::vector<uint8_t> msg = makeRawx(100.0, {{2.0e7, 0.0, 0.f, GLONASS, 255, 8, 500, 35, 0x01}});
+
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(RxmDone, obj.retrieveSvInfo(data));
+    ASSERT_EQ(1u, data.measurementCount);
+
+    EXPECT_EQ(CnstlType::GLONASS, data.measurements[0].constellation);
+    EXPECT_EQ(101, data.measurements[0].svid);
+    EXPECT_FLOAT_EQ(1602.5625e6f, data.measurements[0].carrierFrequencyHz);
+}
+
+TEST_F(GnssRxmRawxParserTest, checkUnknownGnssIdSkipped)
+{
+    std::vector<uint8_t> msg = makeRawx(100.0, {{2.0e7, 0.0, 0.f, 4, 1, 0, 500, 35, 0x01},
+                                                {2.0e7, 0.0, 0.f, GALILEO, 11, 0, 500, 35, 0x01}});
+
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(RxmDone, obj.retrieveSvInfo(data));
+    ASSERT_EQ(1u, data.measurementCount);
+    EXPECT_EQ(CnstlType::GALILEO, data.measurements[0].constellation);
+}
+
+TEST_F(GnssRxmRawxParserTest, outputMatchesLegacyDecoderOnRecordedMessage)
+{
+    std::vector<uint8_t> msg = makeRawx(345600.123, {{2.1234567e7, 1.1e8 + 0.75, -1234.5f, GPS, 5, 0, 500, 40, 0x03},
+                                                     {2.3456789e7, 1.2e8 + 0.125, 2345.25f, GPS, 12, 0, 64000, 35, 0x03}});
+
+    GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+    MeasurementCb::GnssData data;
+    ASSERT_EQ(RxmDone, obj.retrieveSvInfo(data));
+    ASSERT_EQ(legacyGetValue<uint8_t>(&msg[11]), data.measurementCount);
+
+    const double rcvTow = legacyGetValue<double>(&msg[0]);
+    uint32_t iTow = 0;
+    EXPECT_EQ(RxmDone, obj.getEpoch(iTow));
+    EXPECT_EQ(static_cast<uint32_t>(llround(rcvTow * 1000.0)), iTow);
+
+    for (uint32_t i = 0; i < data.measurementCount; i++) {
+        const uint8_t* block = &msg[mHeaderSize + i * mBlockSize];
+        const MeasurementCb::GnssMeasurement& m = data.measurements[i];
+        const double prMes = legacyGetValue<double>(&block[0]);
+        const double cpMes = legacyGetValue<double>(&block[8]);
+        const double doMes = legacyGetValue<float>(&block[16]);
+
+        EXPECT_NEAR((rcvTow - prMes / speedOfLight) * 1e9, static_cast<double>(m.receivedSvTimeInNs), 1.0);
+        EXPECT_DOUBLE_EQ(-doMes * l1Wavelength, m.pseudorangeRateMps);
+        EXPECT_DOUBLE_EQ(cpMes * l1Wavelength, m.accumulatedDeltaRangeM);
+        EXPECT_EQ(static_cast<int64_t>(std::floor(cpMes)), m.carrierCycles);
+        EXPECT_EQ(0 == legacyGetValue<uint16_t>(&block[24]),
+                  0 != (m.accumulatedDeltaRangeState &
+                        MeasurementCb::GnssAccumulatedDeltaRangeState::ADR_STATE_RESET));
+    }
+}
+
+TEST_F(GnssRxmRawxParserTest, bigEndianBranchMatchesLegacyDecoder)
+{
+    std::vector<uint8_t> msg = makeRawx(345600.123, {{2.1234567e7, 1.1e8 + 0.75, -1234.5f, GPS, 5, 0, 500, 40, 0x03}});
+    expectBigEndianBranchSameAsLegacy(msg.data(), msg.size());
+}
+
+TEST_F(GnssRxmRawxParserTest, benchmarkDecodeFullEpoch)
+{
+    const uint8_t gnssIds[] = {GPS, GLONASS, GALILEO, BEIDOU};
+    std::vector<RawxMeas> meas;
+    for (uint8_t i = 0; i < mMaxSvsNum; i++) {
+        meas.push_back({2.0e7 + i * 1000.0, 1.05e8 + i, -500.f + i, gnssIds[i % 4],
+                        static_cast<uint8_t>(i / 4 + 1), 7, 1000, 40, 0x03});
+    }
+    std::vector<uint8_t> msg = makeRawx(345600.123, meas);
+    ASSERT_EQ(2064u, msg.size());
+
+    const int iterations = 1000;
+    auto data = std::make_unique<MeasurementCb::GnssData>();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        GnssRxmRawxParser obj(msg.data(), static_cast<uint16_t>(msg.size()));
+        ASSERT_EQ(RxmDone, obj.retrieveSvInfo(*data));
+    }
+    auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    ASSERT_EQ(static_cast<uint32_t>(mMaxSvsNum), data->measurementCount);
+    RecordProperty("RawxEpochDecodeUs", static_cast<int>(elapsedUs / iterations));
+
+    // 10 Hz leaves 100 ms per epoch, decoding must take a small fraction of it
+    EXPECT_LT(elapsedUs / iterations, 1000);
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <cstring>
+#include <vector>
+
+#include "GnssRxmSfrbxParser.h"
+#include "legacy_decoder.h"
+
+typedef NavigationMessageCb::GnssNavigationMessageType NavMsgType;
+typedef NavigationMessageCb::GnssNavigationMessage NavMsg;
+
+static const uint8_t gnssIdGps = 0;
+static const uint8_t gnssIdSbas = 1;
+static const uint8_t gnssIdGalileo = 2;
+static const uint8_t gnssIdBeidou = 3;
+static const uint8_t gnssIdGlonass = 6;
+
+// Build UBX-RXM-SFRBX payload: 8 bytes header followed by little endian data words
+static std::vector<uint8_t> makeSfrbx(uint8_t gnssId, uint8_t svId, uint8_t sigId, uint8_t freqId,
+                                      const std::vector<uint32_t>& words)
+{
+    std::vector<uint8_t> payload = {gnssId, svId, sigId, freqId,
+                                    static_cast<uint8_t>(words.size()), 0x00, 0x02, 0x00};
+    for (uint32_t word : words) {
+        for (int i = 0; i < 4; i++) {
+            payload.push_back(static_cast<uint8_t>(word >> (8 * i)));
+        }
+    }
+    return payload;
+}
+
+static bool decode(const std::vector<uint8_t>& payload, NavMsg& message)
+{
+    GnssRxmSfrbxParser parser(payload.data(), static_cast<uint16_t>(payload.size()));
+    return parser.getNavigationMessage(message);
+}
+
+TEST(GnssRxmSfrbxParserTest, nullPayloadNoMessage)
+{
+    GnssRxmSfrbxParser parser(nullptr, 48);
+    NavMsg message;
+    EXPECT_FALSE(parser.getNavigationMessage(message));
+}
+
+TEST(GnssRxmSfrbxParserTest, lengthMismatchNoMessage)
+{
+    auto payload = makeSfrbx(gnssIdGps, 5, 0, 0, std::vector<uint32_t>(10, 0));
+    payload.pop_back();
+    NavMsg message;
+    EXPECT_FALSE(decode(payload, message));
+}
+
+TEST(GnssRxmSfrbxParserTest, gpsSubframeWordsPackedInto40Bytes)
+{
+    // HOW: TOW count 11, subframe 4; bits 31..30 do not belong to the word
+    const uint32_t how = 0xC0000000 | (11u << 13) | (4u << 8);
+    std::vector<uint32_t> words(10, 0);
+    words[0] = 0x22C00000;
+    words[1] = how;
+    words[9] = 0x3FFFFFFF;
+
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdGps, 5, 0, 0, words), message));
+
+    EXPECT_EQ(5, message.svid);
+    EXPECT_EQ(NavMsgType::GPS_L1CA, message.type);
+    EXPECT_EQ(3, message.messageId);
+    EXPECT_EQ(4, message.submessageId);
+    EXPECT_EQ(1, message.status);
+    ASSERT_EQ(40u, message.data.size());
+
+    const uint8_t expectedTlm[] = {0x22, 0xC0, 0x00, 0x00};
+    const uint8_t expectedHow[] = {0x00, 0x01, 0x64, 0x00};
+    const uint8_t expectedLast[] = {0x3F, 0xFF, 0xFF, 0xFF};
+    EXPECT_EQ(0, memcmp(expectedTlm, &message.data[0], 4));
+    EXPECT_EQ(0, memcmp(expectedHow, &message.data[4], 4));
+    EXPECT_EQ(0, memcmp(expectedLast, &message.data[36], 4));
+}
+
+TEST(GnssRxmSfrbxParserTest, gpsWordsMatchLegacyDecoder)
+{
+    std::vector<uint32_t> words;
+    for (uint32_t i = 0; i < 10; i++) {
+        words.push_back(0x8BADF00Du * (i + 1) + 0x01020304u);
+    }
+    const auto payload = makeSfrbx(gnssIdGps, 5, 0, 0, words);
+
+    NavMsg message;
+    ASSERT_TRUE(decode(payload, message));
+    ASSERT_EQ(40u, message.data.size());
+
+    // Each data word carries 30 bits, packed most significant byte first
+    for (size_t i = 0; i < words.size(); i++) {
+        const uint32_t word = legacyGetValue<uint32_t>(&payload[8 + i * 4]) & 0x3FFFFFFF;
+        const uint8_t expected[] = {static_cast<uint8_t>(word >> 24), static_cast<uint8_t>(word >> 16),
+                                    static_cast<uint8_t>(word >> 8), static_cast<uint8_t>(word)};
+        EXPECT_EQ(0, memcmp(expected, &message.data[i * 4], 4)) << "word " << i;
+    }
+
+    expectBigEndianBranchSameAsLegacy(payload.data(), payload.size());
+}
+
+TEST(GnssRxmSfrbxParserTest, gpsSubframeWithoutPageHasNoFrameId)
+{
+    std::vector<uint32_t> words(10, 0);
+    words[1] = (100u << 13) | (2u << 8);
+
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdGps, 12, 0, 0, words), message));
+    EXPECT_EQ(-1, message.messageId);
+    EXPECT_EQ(2, message.submessageId);
+}
+
+TEST(GnssRxmSfrbxParserTest, gpsOtherSignalNotSupported)
+{
+    NavMsg message;
+    EXPECT_FALSE(decode(makeSfrbx(gnssIdGps, 5, 3, 0, std::vector<uint32_t>(10, 0)), message));
+}
+
+TEST(GnssRxmSfrbxParserTest, glonassStringPackedInto11Bytes)
+{
+    // idle chip 0, string number 5, frame number 4
+    const std::vector<uint32_t> words = {0x2A000000, 0x00000000, 0xFFFFFFFF, 0x00010004};
+
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdGlonass, 255, 0, 3, words), message));
+
+    EXPECT_EQ(96, message.svid); // unknown slot, FCN -4
+    EXPECT_EQ(NavMsgType::GLO_L1CA, message.type);
+    EXPECT_EQ(4, message.messageId);
+    EXPECT_EQ(5, message.submessageId);
+    ASSERT_EQ(11u, message.data.size());
+    EXPECT_EQ(0x2A, message.data[0]);
+    EXPECT_EQ(0xFF, message.data[8]);
+    EXPECT_EQ(0xFF, message.data[9]);
+    EXPECT_EQ(0xF8, message.data[10]);
+}
+
+TEST(GnssRxmSfrbxParserTest, glonassKnownSlotKeepsSvid)
+{
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdGlonass, 17, 0, 3, std::vector<uint32_t>(4, 0)), message));
+    EXPECT_EQ(17, message.svid);
+}
+
+TEST(GnssRxmSfrbxParserTest, galileoPagePartsPackedInto29Bytes)
+{
+    std::vector<uint32_t> words(8, 0);
+    words[0] = 0x0A000000; // even page, word type 10
+    words[3] = 0x0000FFFF; // 2 last bits of the even part and the tail
+    words[4] = 0xFFFFFFFF;
+
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdGalileo, 11, 1, 0, words), message));
+
+    EXPECT_EQ(11, message.svid);
+    EXPECT_EQ(NavMsgType::GAL_I, message.type);
+    EXPECT_EQ(-1, message.messageId);
+    EXPECT_EQ(10, message.submessageId);
+    ASSERT_EQ(29u, message.data.size());
+    EXPECT_EQ(0x0A, message.data[0]);
+    EXPECT_EQ(0xFF, message.data[14]); // even bits 112..113, odd bits 0..5
+    EXPECT_EQ(0xFF, message.data[17]);
+    EXPECT_EQ(0xC0, message.data[18]); // odd bits 30..31 of the first odd word
+    EXPECT_EQ(0x00, message.data[28]);
+}
+
+TEST(GnssRxmSfrbxParserTest, beidouGeoIsD2)
+{
+    std::vector<uint32_t> words(10, 0);
+    // FraID 3, SOW 100 s: 8 MSBs in the first word, 12 LSBs in the second one
+    const uint32_t sow = 100;
+    words[0] = (3u << 12) | ((sow >> 12) << 4);
+    words[1] = (sow & 0xFFF) << 18;
+
+    NavMsg message;
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdBeidou, 3, 0, 0, words), message));
+    EXPECT_EQ(NavMsgType::BDS_D2, message.type);
+    EXPECT_EQ(34, message.messageId);
+    EXPECT_EQ(3, message.submessageId);
+    EXPECT_EQ(40u, message.data.size());
+
+    ASSERT_TRUE(decode(makeSfrbx(gnssIdBeidou, 20, 0, 0, words), message));
+    EXPECT_EQ(NavMsgType::BDS_D1, message.type);
+    EXPECT_EQ(4, message.messageId);
+    EXPECT_EQ(3, message.submessageId);
+}
+
+TEST(GnssRxmSfrbxParserTest, sbasNotSupported)
+{
+    NavMsg message;
+    EXPECT_FALSE(decode(makeSfrbx(gnssIdSbas, 120, 0, 0, std::vector<uint32_t>(8, 0)), message));
+}
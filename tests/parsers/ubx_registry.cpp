@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssUbxRegistry.h"
+
+enum TestRoute : uint8_t {
+    routeNone = UbxDispatchTable<1>::unknownRoute,
+    routeA,
+    routeB,
+    routeC,
+};
+
+static constexpr UbxMessageEntry testMessages[] = {
+    {0x01, 0x07, routeA},
+    {0x01, 0x35, routeB},
+    {0x02, 0x15, routeC},
+};
+
+typedef UbxDispatchTable<2> TestDispatch;
+static constexpr TestDispatch testDispatch(testMessages);
+
+// The table is usable in constant expressions
+static_assert(routeA == testDispatch.find(TestDispatch::key(0x01, 0x07)), "compile time lookup");
+
+typedef UbxField<uint32_t, 0> fieldU4;
+typedef UbxField<int16_t, 6, std::ratio<1, 100>> fieldI2;
+typedef UbxSchema<8, fieldU4, fieldI2> TestSchema;
+
+TEST(GnssUbxRegistryTest, registeredMessagesAreFound)
+{
+    EXPECT_EQ(routeA, testDispatch.find(TestDispatch::key(0x01, 0x07)));
+    EXPECT_EQ(routeB, testDispatch.find(TestDispatch::key(0x01, 0x35)));
+    EXPECT_EQ(routeC, testDispatch.find(TestDispatch::key(0x02, 0x15)));
+}
+
+TEST(GnssUbxRegistryTest, unknownMessagesHaveNoRoute)
+{
+    EXPECT_EQ(routeNone, testDispatch.find(TestDispatch::key(0x01, 0x08))); // known class
+    EXPECT_EQ(routeNone, testDispatch.find(TestDispatch::key(0x0A, 0x04))); // unknown class
+    EXPECT_EQ(routeNone, testDispatch.find(TestDispatch::key(0x00, 0x00)));
+}
+
+TEST(GnssUbxRegistryTest, keyIsClassAndId)
+{
+    EXPECT_EQ(0x0215, TestDispatch::key(0x02, 0x15));
+}
+
+TEST(GnssUbxRegistryTest, schemaDescribesFields)
+{
+    EXPECT_EQ(8, TestSchema::blockSize);
+    EXPECT_EQ(6, fieldI2::offset);
+    EXPECT_EQ(8, fieldI2::end);
+    EXPECT_DOUBLE_EQ(0.01, fieldI2::scale);
+    EXPECT_DOUBLE_EQ(1.0, fieldU4::scale);
+    EXPECT_TRUE(TestSchema::has<fieldI2>());
+    EXPECT_FALSE((TestSchema::has<UbxField<uint8_t, 4>>()));
+}
@@ -17,12 +17,15 @@
 #define LOG_TAG "GnssHalTesting"
 #include <gtest/gtest.h>
 #include <log/log.h>
+#include <atomic>
 #include <string>
 #include <thread>
 
 #include "GnssMeasQueue.h"
 #include "GnssRxmMeasxParser.h"
 #include "GnssNavClockParser.h"
+#include "GnssNavStatusParser.h"
+#include "GnssNavTimeGPSParser.h"
 #include "GnssNavTimeUTCParser.h"
 
 static const size_t hundred = 100;
@@ -45,20 +48,25 @@ static const uint32_t mStateFlags = MeasurementCb::GnssMeasurementState::STATE_T
         MeasurementCb::GnssMeasurementState::STATE_BIT_SYNC |
         MeasurementCb::GnssMeasurementState::STATE_SUBFRAME_SYNC;
 
+static uint8_t retrieve(GnssMeasMsg& msg, MeasurementCb::GnssData& data)
+{
+    return std::visit(GnssMeasMsgRetrieve{data}, msg);
+}
+
 TEST(GnssMeasQueueTest, pushOnePopOneExpectNotEmpty)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
-    auto rxm = instance.pop();
+    GnssMeasMsg rxm;
+    ASSERT_TRUE(instance.pop(rxm));
     EXPECT_TRUE(instance.empty());
 
     const uint32_t dumpedDataMeasCount = 6;
     MeasurementCb::GnssData data;
 
-    ASSERT_EQ(GnssIParser::RxmDone, rxm->retrieveSvInfo(data));
+    ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm, data));
     ASSERT_EQ(dumpedDataMeasCount, data.measurementCount);
 
     uint16_t exptectedSvid[] = {32, 2, 6, 17, 19, 24};
@@ -81,21 +89,21 @@ TEST(GnssMeasQueueTest, pushTwoSameObjPopTwoExpectSizeCorrect)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp1 = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    auto sp2 = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp1);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
     EXPECT_EQ((size_t)1, instance.getSize());
 
-    instance.push(sp2);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
     EXPECT_EQ((size_t)2, instance.getSize());
 
-    auto rxm1 = instance.pop();
+    GnssMeasMsg rxm1;
+    ASSERT_TRUE(instance.pop(rxm1));
     EXPECT_FALSE(instance.empty());
     EXPECT_EQ((size_t)1, instance.getSize());
 
-    auto rxm2 = instance.pop();
+    GnssMeasMsg rxm2;
+    ASSERT_TRUE(instance.pop(rxm2));
     EXPECT_TRUE(instance.empty());
     EXPECT_EQ((size_t)0, instance.getSize());
 
@@ -103,8 +111,8 @@ TEST(GnssMeasQueueTest, pushTwoSameObjPopTwoExpectSizeCorrect)
     MeasurementCb::GnssData data1;
     MeasurementCb::GnssData data2;
 
-    ASSERT_EQ(GnssIParser::RxmDone, rxm1->retrieveSvInfo(data1));
-    ASSERT_EQ(GnssIParser::RxmDone, rxm2->retrieveSvInfo(data2));
+    ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm1, data1));
+    ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm2, data2));
     ASSERT_EQ(dumpedDataMeasCount, data1.measurementCount);
     ASSERT_EQ(dumpedDataMeasCount, data2.measurementCount);
 
@@ -130,27 +138,26 @@ TEST(GnssMeasQueueTest, pushHundredObjectsCheckSize)
     const size_t maxObjToPush = 100;
 
     for (size_t i = 1; i <= maxObjToPush; ++i) {
-        auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-        instance.push(sp);
+        instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
         EXPECT_EQ(i, instance.getSize());
     }
 
     ASSERT_FALSE(instance.empty());
     ASSERT_EQ(maxObjToPush, instance.getSize());
 
+    GnssMeasMsg rxm;
     for (size_t i = maxObjToPush; i > 1; --i) {
-        auto rxm = instance.pop();
+        EXPECT_TRUE(instance.pop(rxm));
         EXPECT_EQ((i - 1), instance.getSize());
-        (void)rxm;
     }
 
-    auto rxm = instance.pop();
+    ASSERT_TRUE(instance.pop(rxm));
     EXPECT_EQ((size_t)0, instance.getSize());
     EXPECT_TRUE(instance.empty());
     MeasurementCb::GnssData data;
     const uint32_t dumpedDataMeasCount = 6;
 
-    ASSERT_EQ(GnssIParser::RxmDone, rxm->retrieveSvInfo(data));
+    ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm, data));
     ASSERT_EQ(dumpedDataMeasCount, data.measurementCount);
 
     uint16_t exptectedSvid[] = {32, 2, 6, 17, 19, 24};
@@ -174,8 +181,8 @@ TEST(GnssMeasQueueTest, popFromEmptyQueue)
     instance.setState(true);
     EXPECT_TRUE(instance.empty());
     EXPECT_EQ((size_t)0, instance.getSize());
-    auto sp = instance.pop();
-    EXPECT_EQ(nullptr, sp);
+    GnssMeasMsg msg;
+    EXPECT_FALSE(instance.pop(msg));
 }
 
 static void pushThread(void)
@@ -183,8 +190,7 @@ static void pushThread(void)
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
     for (size_t i = 0; i < hundred; ++i) {
-        auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-        instance.push(sp);
+        instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     }
 }
 
@@ -198,12 +204,12 @@ static void popThread(void)
     double expectedPseudoRangeRate[] = {16572.0, 21966.0, 18455.0, -6048.0, -905.0, 3147.0};
 
     do {
-        auto rxm = instance.pop();
-        if (nullptr != rxm) {
+        GnssMeasMsg rxm;
+        if (instance.pop(rxm)) {
             MeasurementCb::GnssData data;
             const uint32_t dumpedDataMeasCount = 6;
 
-            ASSERT_EQ(GnssIParser::RxmDone, rxm->retrieveSvInfo(data));
+            ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm, data));
             ASSERT_EQ(dumpedDataMeasCount, data.measurementCount);
 
             for (uint32_t i = 0; i < data.measurementCount; ++i) {
@@ -246,35 +252,33 @@ TEST(GnssMeasQueueTest, setStateTrueCheckPushPop)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
 
-    auto rxm = instance.pop();
+    GnssMeasMsg rxm;
+    ASSERT_TRUE(instance.pop(rxm));
     EXPECT_TRUE(instance.empty());
     MeasurementCb::GnssData data;
-    ASSERT_EQ(GnssIParser::RxmDone, rxm->retrieveSvInfo(data));
+    ASSERT_EQ(GnssIParser::RxmDone, retrieve(rxm, data));
 }
 
 TEST(GnssMeasQueueTest, setStateFalseCheckPushPop)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(false);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_TRUE(instance.empty());
 
-    auto rxm = instance.pop();
+    GnssMeasMsg rxm;
+    EXPECT_FALSE(instance.pop(rxm));
     EXPECT_TRUE(instance.empty());
-    ASSERT_EQ(nullptr, rxm);
 }
 
 TEST(GnssMeasQueueTest, setStateTruePushThenFalseCheckSize)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
 
     instance.setState(false);
@@ -292,8 +296,7 @@ TEST(GnssMeasQueueTest, checkEmptyIfNotEmpty)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
 }
 
@@ -301,9 +304,9 @@ TEST(GnssMeasQueueTest, checkPopIfStateFalse)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(false);
-    auto rxm = instance.pop();
+    GnssMeasMsg rxm;
+    EXPECT_FALSE(instance.pop(rxm));
     EXPECT_TRUE(instance.empty());
-    ASSERT_EQ(nullptr, rxm);
 
 }
 
@@ -311,14 +314,13 @@ TEST(GnssMeasQueueTest, checkPushSetFalsePop)
 {
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
-    instance.push(sp);
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
     EXPECT_FALSE(instance.empty());
 
     instance.setState(false);
-    auto rxm = instance.pop();
+    GnssMeasMsg rxm;
+    EXPECT_FALSE(instance.pop(rxm));
     EXPECT_TRUE(instance.empty());
-    ASSERT_EQ(nullptr, rxm);
 }
 
 TEST(GnssMeasQueueTest, checkPopIfEmptyAndStateOn)
@@ -327,8 +329,8 @@ TEST(GnssMeasQueueTest, checkPopIfEmptyAndStateOn)
     instance.setState(true);
     EXPECT_TRUE(instance.empty());
 
-    auto rxm = instance.pop();
-    ASSERT_EQ(nullptr, rxm);
+    GnssMeasMsg rxm;
+    EXPECT_FALSE(instance.pop(rxm));
 
 }
 
@@ -337,9 +339,8 @@ TEST(GnssMeasQueueTest, pushToOverflowQueue)
     const size_t ten_hundred = 1000;
     GnssMeasQueue& instance = GnssMeasQueue::getInstance();
     instance.setState(true);
-    auto sp = std::make_shared<GnssRxmMeasxParser> (rxmMeasxMsg, sizeof(rxmMeasxMsg));
     for (size_t i = 0; i < ten_hundred; ++i) {
-        instance.push(sp);
+        instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
         EXPECT_FALSE(instance.empty());
         EXPECT_TRUE(hundred >= instance.getSize());
     }
@@ -362,3 +363,403 @@ TEST(GnssMeasQueueTest, pushFromMultipleTheadsToOverflowQueue)
     instance.setState(false);
     EXPECT_TRUE(instance.empty());
 }
+
+TEST(GnssMeasQueueTest, waitAndPopWakesUpOnPush)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(true);
+    GnssMeasMsg rxm;
+
+    std::thread consumer([&instance, &rxm] {
+        // a pending wake up from a previous test returns false first
+        while (!instance.waitAndPop(rxm)) {
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    instance.emplace<GnssRxmMeasxParser>(rxmMeasxMsg, sizeof(rxmMeasxMsg));
+    consumer.join();
+
+    ASSERT_TRUE(std::holds_alternative<GnssRxmMeasxParser>(rxm));
+    EXPECT_TRUE(instance.empty());
+    MeasurementCb::GnssData data;
+    EXPECT_EQ(GnssIParser::RxmDone, retrieve(rxm, data));
+}
+
+TEST(GnssMeasQueueTest, waitAndPopInterruptedByWakeUp)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(true);
+    bool popped = true;
+
+    std::thread consumer([&instance, &popped] {
+        GnssMeasMsg rxm;
+        popped = instance.waitAndPop(rxm);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    instance.wakeUp();
+    consumer.join();
+
+    EXPECT_FALSE(popped);
+    instance.setState(false);
+}
+
+static const uint32_t epochITow = 486776000;
+
+static void putU32(uint8_t* buf, uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i) {
+        buf[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint16_t makePayload(uint8_t part, uint32_t iTow, uint8_t* payload)
+{
+    memset(payload, 0, sizeof(rxmMeasxMsg));
+
+    switch (part) {
+    case GnssIParser::RxmDone:
+        memcpy(payload, rxmMeasxMsg, sizeof(rxmMeasxMsg));
+        putU32(&payload[4], iTow);
+        return sizeof(rxmMeasxMsg);
+    case GnssIParser::GPSTimeDone:
+        putU32(payload, iTow);
+        payload[8] = 0x20; // week 2080
+        payload[9] = 0x08;
+        payload[11] = 0x03; // TOW and week valid
+        return 16;
+    case GnssIParser::ClockDone:
+        putU32(payload, iTow);
+        return 20;
+    default:
+        putU32(payload, iTow);
+        return 16;
+    }
+}
+
+static GnssMeasMsg makePart(uint8_t part, uint32_t iTow)
+{
+    uint8_t payload[sizeof(rxmMeasxMsg)];
+    const uint16_t len = makePayload(part, iTow, payload);
+
+    switch (part) {
+    case GnssIParser::RxmDone:
+        return GnssMeasMsg(std::in_place_type<GnssRxmMeasxParser>, payload, len);
+    case GnssIParser::GPSTimeDone:
+        return GnssMeasMsg(std::in_place_type<GnssNavTimeGPSParser>, payload, len);
+    case GnssIParser::ClockDone:
+        return GnssMeasMsg(std::in_place_type<GnssNavClockParser>, payload, len);
+    default:
+        return GnssMeasMsg(std::in_place_type<GnssNavStatusParser>, payload, len);
+    }
+}
+
+static void pushEpoch(uint32_t iTow, uint8_t parts)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    uint8_t payload[sizeof(rxmMeasxMsg)];
+
+    for (uint8_t part = GnssIParser::RxmDone; part <= GnssIParser::StatusDone; part <<= 1) {
+        if (!(parts & part)) {
+            continue;
+        }
+
+        const uint16_t len = makePayload(part, iTow, payload);
+        switch (part) {
+        case GnssIParser::RxmDone:
+            instance.emplace<GnssRxmMeasxParser>(payload, len);
+            break;
+        case GnssIParser::GPSTimeDone:
+            instance.emplace<GnssNavTimeGPSParser>(payload, len);
+            break;
+        case GnssIParser::ClockDone:
+            instance.emplace<GnssNavClockParser>(payload, len);
+            break;
+        default:
+            instance.emplace<GnssNavStatusParser>(payload, len);
+            break;
+        }
+    }
+}
+
+TEST(GnssMeasQueueTest, getEpochOfParsers)
+{
+    for (uint8_t part = GnssIParser::RxmDone; part <= GnssIParser::StatusDone; part <<= 1) {
+        uint32_t iTow = 0;
+        GnssMeasMsg msg = makePart(part, epochITow);
+        EXPECT_EQ(part, std::visit(GnssMeasMsgEpoch{iTow}, msg));
+        EXPECT_EQ(epochITow, iTow);
+    }
+
+    uint32_t iTow = 0;
+    GnssMeasMsg empty;
+    EXPECT_EQ(GnssIParser::NotReady, std::visit(GnssMeasMsgEpoch{iTow}, empty));
+}
+
+TEST(GnssMeasQueueTest, popEpochGroupsPartsByITow)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    const uint64_t completed = instance.getEpochStats().completed;
+
+    // the clock of the next epoch arrives before the clock of the current one
+    pushEpoch(epochITow, GnssIParser::RxmDone);
+    pushEpoch(epochITow + 1000, GnssIParser::ClockDone);
+    pushEpoch(epochITow, GnssIParser::GPSTimeDone | GnssIParser::StatusDone);
+    pushEpoch(epochITow, GnssIParser::ClockDone);
+
+    GnssMeasQueue::Epoch epoch;
+    ASSERT_TRUE(instance.popEpoch(epoch));
+    EXPECT_EQ(epochITow, epoch.iTow);
+    EXPECT_EQ(GnssIParser::Ready, epoch.flags);
+    EXPECT_EQ(completed + 1, instance.getEpochStats().completed);
+
+    for (size_t i = 0; i < GnssMeasQueue::mPartsCount; ++i) {
+        uint32_t iTow = 0;
+        ASSERT_FALSE(std::holds_alternative<std::monostate>(epoch.parts[i]));
+        EXPECT_EQ(1u << i, std::visit(GnssMeasMsgEpoch{iTow}, epoch.parts[i]));
+        EXPECT_EQ(epochITow, iTow);
+    }
+
+    MeasurementCb::GnssData data;
+    uint8_t flags = GnssIParser::NotReady;
+    for (auto& part : epoch.parts) {
+        flags |= retrieve(part, data);
+    }
+    EXPECT_EQ(GnssIParser::Ready, flags);
+
+    pushEpoch(epochITow + 1000, GnssIParser::RxmDone | GnssIParser::GPSTimeDone | GnssIParser::StatusDone);
+    ASSERT_TRUE(instance.popEpoch(epoch));
+    EXPECT_EQ(epochITow + 1000, epoch.iTow);
+    EXPECT_EQ(GnssIParser::Ready, epoch.flags);
+    EXPECT_TRUE(instance.empty());
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, popEpochDropsOlderIncompleteEpoch)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    const GnssMeasQueue::EpochStats before = instance.getEpochStats();
+
+    pushEpoch(epochITow, GnssIParser::RxmDone | GnssIParser::ClockDone);
+    pushEpoch(epochITow + 1000, GnssIParser::Ready);
+
+    GnssMeasQueue::Epoch epoch;
+    ASSERT_TRUE(instance.popEpoch(epoch));
+    EXPECT_EQ(epochITow + 1000, epoch.iTow);
+    EXPECT_EQ(before.droppedIncomplete + 1, instance.getEpochStats().droppedIncomplete);
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, popEpochDropsIncompleteAtDeadline)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    instance.setEpochDeadline(std::chrono::milliseconds(20));
+    const GnssMeasQueue::EpochStats before = instance.getEpochStats();
+    bool popped = true;
+
+    pushEpoch(epochITow, GnssIParser::RxmDone | GnssIParser::ClockDone);
+    std::thread consumer([&instance, &popped] {
+        GnssMeasQueue::Epoch epoch;
+        popped = instance.popEpoch(epoch);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(before.droppedIncomplete + 1, instance.getEpochStats().droppedIncomplete);
+    instance.wakeUp();
+    consumer.join();
+
+    EXPECT_FALSE(popped);
+    instance.setEpochDeadline(GnssMeasQueue::mDefaultEpochDeadline);
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, popEpochEmitsIncompleteAtDeadline)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    instance.setEpochDeadline(std::chrono::milliseconds(20));
+    instance.setIncompletePolicy(GnssMeasQueue::IncompletePolicy::Emit);
+    const GnssMeasQueue::EpochStats before = instance.getEpochStats();
+
+    pushEpoch(epochITow, GnssIParser::RxmDone | GnssIParser::ClockDone);
+
+    GnssMeasQueue::Epoch epoch;
+    ASSERT_TRUE(instance.popEpoch(epoch));
+    EXPECT_EQ(epochITow, epoch.iTow);
+    EXPECT_EQ(GnssIParser::RxmDone | GnssIParser::ClockDone, epoch.flags);
+    EXPECT_GE(epoch.latency, std::chrono::milliseconds(20));
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(epoch.parts[1]));
+    EXPECT_EQ(before.emittedIncomplete + 1, instance.getEpochStats().emittedIncomplete);
+
+    instance.setIncompletePolicy(GnssMeasQueue::IncompletePolicy::Drop);
+    instance.setEpochDeadline(GnssMeasQueue::mDefaultEpochDeadline);
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, popEpochAcrossWeekRollover)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+
+    // RAWX receiver time may differ from the navigation iTOW by a few ms
+    const uint32_t lastMsOfWeek = 604799995;
+    pushEpoch(lastMsOfWeek, GnssIParser::RxmDone);
+    pushEpoch(5, GnssIParser::GPSTimeDone | GnssIParser::ClockDone | GnssIParser::StatusDone);
+
+    GnssMeasQueue::Epoch epoch;
+    ASSERT_TRUE(instance.popEpoch(epoch));
+    EXPECT_EQ(lastMsOfWeek, epoch.iTow);
+    EXPECT_EQ(GnssIParser::Ready, epoch.flags);
+    instance.setState(false);
+}
+
+static void pushMeasx(uint32_t iTow)
+{
+    uint8_t payload[sizeof(rxmMeasxMsg)];
+    const uint16_t len = makePayload(GnssIParser::RxmDone, iTow, payload);
+    GnssMeasQueue::getInstance().emplace<GnssRxmMeasxParser>(payload, len);
+}
+
+static uint32_t popITow(GnssMeasQueue& instance)
+{
+    GnssMeasMsg msg;
+    uint32_t iTow = 0;
+    if (!instance.pop(msg) || GnssIParser::NotReady == std::visit(GnssMeasMsgEpoch{iTow}, msg)) {
+        return 0;
+    }
+
+    return iTow;
+}
+
+TEST(GnssMeasQueueTest, dropOldestKeepsNewestMessages)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    const GnssMeasQueue::QueueStats before = instance.getQueueStats();
+    const uint32_t extra = 10;
+
+    for (uint32_t i = 0; i < GnssMeasQueue::mMaxSize + extra; ++i) {
+        pushMeasx(epochITow + i);
+    }
+
+    const GnssMeasQueue::QueueStats stats = instance.getQueueStats();
+    EXPECT_EQ(before.pushed + GnssMeasQueue::mMaxSize + extra, stats.pushed);
+    EXPECT_EQ(before.dropped + extra, stats.dropped);
+    EXPECT_EQ(GnssMeasQueue::mMaxSize, stats.highWater);
+    EXPECT_EQ(GnssMeasQueue::mMaxSize, stats.size);
+
+    EXPECT_EQ(epochITow + extra, popITow(instance));
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, dropNewestKeepsOldestMessages)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    instance.setDropPolicy(GnssMeasQueue::DropPolicy::DropNewest);
+    const GnssMeasQueue::QueueStats before = instance.getQueueStats();
+    const uint32_t extra = 10;
+
+    for (uint32_t i = 0; i < GnssMeasQueue::mMaxSize + extra; ++i) {
+        pushMeasx(epochITow + i);
+    }
+
+    const GnssMeasQueue::QueueStats stats = instance.getQueueStats();
+    EXPECT_EQ(before.pushed + GnssMeasQueue::mMaxSize, stats.pushed);
+    EXPECT_EQ(before.dropped + extra, stats.dropped);
+    EXPECT_EQ(epochITow, popITow(instance));
+
+    instance.setDropPolicy(GnssMeasQueue::DropPolicy::DropOldest);
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, drainConsumesBatchInOrder)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    const GnssMeasQueue::QueueStats before = instance.getQueueStats();
+    const uint32_t count = 10;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        pushMeasx(epochITow + i);
+    }
+
+    uint32_t expected = epochITow;
+    auto consumer = [&expected](GnssMeasMsg& msg, GnssMeasQueue::Clock::time_point) {
+        uint32_t iTow = 0;
+        std::visit(GnssMeasMsgEpoch{iTow}, msg);
+        EXPECT_EQ(expected++, iTow);
+        return true;
+    };
+
+    EXPECT_EQ(4u, instance.drain(consumer, 4));
+    EXPECT_EQ(count - 4, instance.getSize());
+    EXPECT_EQ(count - 4, instance.drain(consumer));
+    EXPECT_TRUE(instance.empty());
+    EXPECT_EQ(0u, instance.drain(consumer));
+    EXPECT_EQ(before.popped + count, instance.getQueueStats().popped);
+
+    // the consumer stops the batch by returning false
+    pushMeasx(epochITow);
+    pushMeasx(epochITow + 1);
+    EXPECT_EQ(1u, instance.drain([](GnssMeasMsg&, GnssMeasQueue::Clock::time_point) {
+        return false;
+    }));
+    EXPECT_EQ(1u, instance.getSize());
+    instance.setState(false);
+}
+
+TEST(GnssMeasQueueTest, multipleProducersKeepCountersConsistent)
+{
+    GnssMeasQueue& instance = GnssMeasQueue::getInstance();
+    instance.setState(false);
+    instance.setState(true);
+    const GnssMeasQueue::QueueStats before = instance.getQueueStats();
+    const size_t producersCount = 4;
+    const uint32_t perProducer = 500;
+    std::atomic<bool> done{false};
+    uint64_t consumed = 0;
+
+    std::thread consumer([&instance, &done, &consumed] {
+        GnssMeasMsg msg;
+        while (!done || !instance.empty()) {
+            if (instance.pop(msg)) {
+                EXPECT_TRUE(std::holds_alternative<GnssRxmMeasxParser>(msg));
+                consumed++;
+            }
+        }
+    });
+
+    std::thread producers[producersCount];
+    for (auto& producer : producers) {
+        producer = std::thread([] {
+            for (uint32_t i = 0; i < perProducer; ++i) {
+                pushMeasx(epochITow + i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    done = true;
+    consumer.join();
+
+    const GnssMeasQueue::QueueStats stats = instance.getQueueStats();
+    // with DropOldest every message is published, consumed or dropped
+    EXPECT_EQ(producersCount * perProducer, stats.pushed - before.pushed);
+    EXPECT_EQ(stats.pushed - before.pushed, consumed + (stats.dropped - before.dropped));
+    EXPECT_LE(stats.highWater, GnssMeasQueue::mMaxSize);
+    instance.setState(false);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <thread>
+
+#include "GnssNavMsgQueue.h"
+
+static const uint8_t payload[] = {0x00, 0x05, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00,
+                                  0x11, 0x22, 0x33, 0x44};
+static const std::chrono::milliseconds noWait{0};
+
+TEST(GnssNavMsgQueueTest, pushWhenOffIsIgnored)
+{
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    queue.setState(false);
+    EXPECT_FALSE(queue.push(payload, sizeof(payload)));
+    EXPECT_EQ(0u, queue.getSize());
+}
+
+TEST(GnssNavMsgQueueTest, pushOnePopOneKeepsPayload)
+{
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    queue.setState(true);
+    ASSERT_TRUE(queue.push(payload, sizeof(payload)));
+
+    GnssNavMsgQueue::Element element;
+    ASSERT_TRUE(queue.pop(element, noWait));
+    EXPECT_EQ(sizeof(payload), element.len);
+    EXPECT_EQ(0, memcmp(payload, element.data, sizeof(payload)));
+    EXPECT_FALSE(queue.pop(element, noWait));
+    queue.setState(false);
+}
+
+TEST(GnssNavMsgQueueTest, oversizedPayloadIsRejected)
+{
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    queue.setState(true);
+    uint8_t big[GnssNavMsgQueue::mMaxPayloadSize + 1] = {};
+    EXPECT_FALSE(queue.push(big, sizeof(big)));
+    queue.setState(false);
+}
+
+TEST(GnssNavMsgQueueTest, fullQueueDropsNewest)
+{
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    queue.setState(true);
+    const uint64_t dropped = queue.getDroppedCount();
+
+    size_t pushed = 0;
+    while (queue.push(payload, sizeof(payload))) {
+        ++pushed;
+    }
+    EXPECT_EQ(pushed, queue.getSize());
+    EXPECT_EQ(dropped + 1, queue.getDroppedCount());
+
+    queue.setState(false);
+    EXPECT_EQ(0u, queue.getSize());
+}
+
+TEST(GnssNavMsgQueueTest, popIsWokenUpByPush)
+{
+    GnssNavMsgQueue& queue = GnssNavMsgQueue::getInstance();
+    queue.setState(true);
+
+    std::thread producer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.push(payload, sizeof(payload));
+    });
+
+    GnssNavMsgQueue::Element element;
+    EXPECT_TRUE(queue.pop(element, std::chrono::milliseconds(5000)));
+    producer.join();
+    queue.setState(false);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "GnssReactor.h"
+
+class ReactorHandler : public GnssReactor::Handler {
+public:
+    bool OnReadable(int fd) override
+    {
+        char chunk[64];
+        ssize_t ret = read(fd, chunk, sizeof(chunk));
+        if (ret <= 0) {
+            mClosed = true;
+            return false;
+        }
+
+        mData.append(chunk, static_cast<size_t>(ret));
+        if (mReactor != nullptr && mData.size() >= mStopAfterBytes) {
+            mReactor->Stop();
+        }
+        return true;
+    }
+
+    void OnTimeout() override
+    {
+        mTimeouts++;
+        if (mReactor != nullptr) {
+            mReactor->Stop();
+        }
+    }
+
+    GnssReactor* mReactor = nullptr;
+    size_t mStopAfterBytes = 0;
+    std::string mData;
+    bool mClosed = false;
+    int mTimeouts = 0;
+};
+
+class GnssReactorTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(0, pipe(mPipe));
+    }
+
+    void TearDown() override
+    {
+        for (int fd : mPipe) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    int mPipe[2] = {-1, -1};
+};
+
+TEST_F(GnssReactorTest, readableDescriptorIsDispatched)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+    ASSERT_TRUE(reactor.AddFd(mPipe[0]));
+    handler.mReactor = &reactor;
+    handler.mStopAfterBytes = 6;
+
+    ASSERT_EQ(3, write(mPipe[1], "$GP", 3));
+    std::thread writer([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(3, write(mPipe[1], "RMC", 3));
+    });
+    reactor.Run();
+    writer.join();
+
+    EXPECT_EQ(std::string("$GPRMC"), handler.mData);
+    EXPECT_EQ(0, handler.mTimeouts);
+    EXPECT_LE((uint64_t)1, reactor.GetStats().readEvents);
+}
+
+TEST_F(GnssReactorTest, slowHandlerIsReported)
+{
+    class SlowHandler : public ReactorHandler {
+    public:
+        bool OnReadable(int fd) override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return ReactorHandler::OnReadable(fd);
+        }
+    };
+
+    SlowHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+    ASSERT_TRUE(reactor.AddFd(mPipe[0]));
+    handler.mReactor = &reactor;
+    handler.mStopAfterBytes = 1;
+
+    ASSERT_EQ(1, write(mPipe[1], "$", 1));
+    reactor.Run();
+
+    EXPECT_LE(20000, reactor.GetStats().maxHandlerUs);
+}
+
+TEST_F(GnssReactorTest, timeoutFiresOnce)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+    handler.mReactor = &reactor;
+
+    const auto start = std::chrono::steady_clock::now();
+    reactor.SetTimeout(20);
+    reactor.Run();
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(1, handler.mTimeouts);
+    EXPECT_EQ((uint64_t)1, reactor.GetStats().timerEvents);
+}
+
+TEST_F(GnssReactorTest, expiredDeadlineFiresImmediately)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+    handler.mReactor = &reactor;
+
+    reactor.SetTimeout(0);
+    reactor.Run();
+
+    EXPECT_EQ(1, handler.mTimeouts);
+}
+
+TEST_F(GnssReactorTest, disarmedTimerDoesNotFire)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+
+    reactor.SetTimeout(10);
+    reactor.SetTimeout(-1);
+    std::thread stopper([&reactor] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        reactor.Stop();
+    });
+    reactor.Run();
+    stopper.join();
+
+    EXPECT_EQ(0, handler.mTimeouts);
+    EXPECT_LE((uint64_t)1, reactor.GetStats().controlEvents);
+}
+
+TEST_F(GnssReactorTest, closedDescriptorIsRemoved)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+    ASSERT_TRUE(reactor.AddFd(mPipe[0]));
+    handler.mReactor = &reactor;
+
+    close(mPipe[1]);
+    mPipe[1] = -1;
+    // the hang-up is reported once, then only the timer wakes the loop
+    reactor.SetTimeout(30);
+    reactor.Run();
+
+    EXPECT_TRUE(handler.mClosed);
+    EXPECT_EQ((uint64_t)1, reactor.GetStats().readEvents);
+    EXPECT_EQ(1, handler.mTimeouts);
+}
+
+TEST_F(GnssReactorTest, stopBeforeRunReturnsImmediately)
+{
+    ReactorHandler handler;
+    GnssReactor reactor(handler);
+    ASSERT_TRUE(reactor.IsValid());
+
+    reactor.Stop();
+    reactor.Run();
+
+    EXPECT_EQ((uint64_t)0, reactor.GetStats().wakeups);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <atomic>
+#include <thread>
+
+#include "GnssSeqlock.h"
+
+// every field carries the same value, a torn copy would mix two stores
+struct SeqlockSample {
+    uint64_t values[37];
+    uint32_t tail;
+};
+
+static SeqlockSample makeSample(uint64_t value)
+{
+    SeqlockSample sample;
+    for (auto& v : sample.values) {
+        v = value;
+    }
+    sample.tail = static_cast<uint32_t>(value);
+    return sample;
+}
+
+static bool isConsistent(const SeqlockSample& sample)
+{
+    for (const auto& v : sample.values) {
+        if (v != sample.values[0]) {
+            return false;
+        }
+    }
+    return sample.tail == static_cast<uint32_t>(sample.values[0]);
+}
+
+TEST(GnssSeqlockTest, loadBeforeStoreFails)
+{
+    GnssSeqlock<SeqlockSample> seqlock;
+    SeqlockSample sample = makeSample(7);
+
+    EXPECT_FALSE(seqlock.load(sample));
+    EXPECT_EQ((uint64_t)7, sample.values[0]);
+    EXPECT_EQ((uint32_t)0, seqlock.getSequence());
+}
+
+TEST(GnssSeqlockTest, loadReturnsLastStore)
+{
+    GnssSeqlock<SeqlockSample> seqlock;
+    SeqlockSample sample = {};
+
+    seqlock.store(makeSample(1));
+    seqlock.store(makeSample(2));
+
+    ASSERT_TRUE(seqlock.load(sample));
+    EXPECT_TRUE(isConsistent(sample));
+    EXPECT_EQ((uint64_t)2, sample.values[0]);
+    EXPECT_EQ((uint32_t)4, seqlock.getSequence());
+}
+
+TEST(GnssSeqlockTest, readersNeverSeeTornValue)
+{
+    GnssSeqlock<SeqlockSample> seqlock;
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> torn(0);
+    std::atomic<uint64_t> loads(0);
+    const uint64_t storesCount = 200000;
+
+    auto reader = [&] {
+        SeqlockSample sample = {};
+        uint64_t last = 0;
+        while (!done) {
+            if (seqlock.load(sample)) {
+                if (!isConsistent(sample) || sample.values[0] < last) {
+                    torn++;
+                }
+                last = sample.values[0];
+                loads++;
+            }
+        }
+    };
+
+    std::thread first(reader);
+    std::thread second(reader);
+    for (uint64_t i = 1; i <= storesCount; i++) {
+        seqlock.store(makeSample(i));
+    }
+    done = true;
+    first.join();
+    second.join();
+
+    EXPECT_EQ((uint64_t)0, torn.load());
+    EXPECT_LT((uint64_t)0, loads.load());
+    EXPECT_EQ(static_cast<uint32_t>(storesCount * 2), seqlock.getSequence());
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include "GnssSvTable.h"
+
+static const uint8_t sourceGps = 0;
+static const uint8_t sourceGlonass = 1;
+static const uint8_t usedInFixFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::USED_IN_FIX);
+
+static IGnssCallback::GnssSvInfo makeSv(GnssConstellationType constellation, int16_t svid, float cn0)
+{
+    IGnssCallback::GnssSvInfo sv = {};
+    sv.constellation = constellation;
+    sv.svid = svid;
+    sv.cN0Dbhz = cn0;
+    sv.svFlag = static_cast<uint8_t>(IGnssCallback::GnssSvFlags::HAS_ALMANAC_DATA);
+    return sv;
+}
+
+class GnssSvTableTest : public ::testing::Test {
+protected:
+    GnssSvTable table;
+    IGnssCallback::GnssSvStatus status = {};
+};
+
+TEST_F(GnssSvTableTest, emptyTableGivesEmptyList)
+{
+    EXPECT_EQ((size_t)0, table.fillSvStatus(status));
+    EXPECT_EQ((uint32_t)0, status.numSvs);
+}
+
+TEST_F(GnssSvTableTest, updateInPlaceKeepsOneRecordPerSv)
+{
+    EXPECT_TRUE(table.update(makeSv(GnssConstellationType::GPS, 5, 20.f), sourceGps));
+    EXPECT_TRUE(table.update(makeSv(GnssConstellationType::GPS, 5, 30.f), sourceGps));
+
+    ASSERT_EQ((size_t)1, table.fillSvStatus(status));
+    EXPECT_EQ(5, status.gnssSvList[0].svid);
+    EXPECT_EQ(30.f, status.gnssSvList[0].cN0Dbhz);
+}
+
+TEST_F(GnssSvTableTest, outOfRangeSvidRejected)
+{
+    EXPECT_FALSE(table.update(makeSv(GnssConstellationType::UNKNOWN, 301, 20.f), sourceGps));
+    EXPECT_FALSE(table.update(makeSv(GnssConstellationType::GPS, -1, 20.f), sourceGps));
+    EXPECT_EQ((size_t)0, table.getVisibleCount());
+}
+
+TEST_F(GnssSvTableTest, usedInFixFromBitmap)
+{
+    table.update(makeSv(GnssConstellationType::GPS, 1, 20.f), sourceGps);
+    table.update(makeSv(GnssConstellationType::GPS, 2, 20.f), sourceGps);
+    table.update(makeSv(GnssConstellationType::GLONASS, 1, 20.f), sourceGlonass);
+
+    table.setUsedInFix(GnssConstellationType::GPS, 2);
+    table.setUsedInFix(GnssConstellationType::GLONASS, 1);
+
+    ASSERT_EQ((size_t)3, table.fillSvStatus(status));
+    EXPECT_FALSE(status.gnssSvList[0].svFlag & usedInFixFlag);
+    EXPECT_TRUE(status.gnssSvList[1].svFlag & usedInFixFlag);
+    EXPECT_TRUE(status.gnssSvList[2].svFlag & usedInFixFlag);
+
+    table.clearUsedInFix(GnssSvTable::constellationBit(GnssConstellationType::GPS));
+    ASSERT_EQ((size_t)3, table.fillSvStatus(status));
+    EXPECT_FALSE(status.gnssSvList[1].svFlag & usedInFixFlag);
+    EXPECT_TRUE(status.gnssSvList[2].svFlag & usedInFixFlag);
+}
+
+TEST_F(GnssSvTableTest, clearSourceKeepsOtherSources)
+{
+    table.update(makeSv(GnssConstellationType::GPS, 1, 20.f), sourceGps);
+    table.update(makeSv(GnssConstellationType::SBAS, 120, 20.f), sourceGps);
+    table.update(makeSv(GnssConstellationType::GLONASS, 7, 20.f), sourceGlonass);
+
+    table.clearSource(sourceGps);
+
+    ASSERT_EQ((size_t)1, table.fillSvStatus(status));
+    EXPECT_EQ(GnssConstellationType::GLONASS, status.gnssSvList[0].constellation);
+    EXPECT_EQ(7, status.gnssSvList[0].svid);
+}
+
+TEST_F(GnssSvTableTest, moreThanMaxKeepsStrongest)
+{
+    const size_t maxSvs = static_cast<size_t>(GnssMax::SVS_COUNT);
+    const int16_t total = 80;
+
+    /* GPS 1..80 is not a valid numbering but exercises the selection */
+    for (int16_t svid = 1; svid <= total; svid++) {
+        table.update(makeSv(GnssConstellationType::GPS, svid, static_cast<float>(svid)), sourceGps);
+    }
+
+    ASSERT_EQ(maxSvs, table.fillSvStatus(status));
+    ASSERT_EQ((uint32_t)maxSvs, status.numSvs);
+
+    for (size_t i = 0; i < maxSvs; i++) {
+        EXPECT_GT(status.gnssSvList[i].cN0Dbhz, static_cast<float>(total - maxSvs));
+        if (i > 0) {
+            EXPECT_LT(status.gnssSvList[i - 1].svid, status.gnssSvList[i].svid);
+        }
+    }
+}
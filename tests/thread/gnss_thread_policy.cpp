@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2019 GlobalLogic
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "GnssHalTesting"
+#include <gtest/gtest.h>
+#include <log/log.h>
+#include <climits>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <thread>
+
+#include "GnssThreadPolicy.h"
+
+typedef GnssThreadPolicy::Policy Policy;
+
+TEST(GnssThreadPolicyTest, defaultsAreOtherOnAllCpus)
+{
+    const Policy policy = GnssThreadPolicy::parsePolicy("other", 0, INT32_MIN, "");
+
+    EXPECT_FALSE(policy.fifo);
+    EXPECT_EQ(0, policy.priority);
+    EXPECT_FALSE(policy.hasNice);
+    EXPECT_EQ((uint64_t)0, policy.cpuMask);
+}
+
+TEST(GnssThreadPolicyTest, fifoPriorityIsClamped)
+{
+    const Policy low = GnssThreadPolicy::parsePolicy("fifo", 0, INT32_MIN, "");
+    const Policy high = GnssThreadPolicy::parsePolicy("fifo", 1000, INT32_MIN, "");
+    const Policy other = GnssThreadPolicy::parsePolicy("other", 50, INT32_MIN, "");
+
+    EXPECT_TRUE(low.fifo);
+    EXPECT_EQ(sched_get_priority_min(SCHED_FIFO), low.priority);
+    EXPECT_EQ(sched_get_priority_max(SCHED_FIFO), high.priority);
+    EXPECT_FALSE(other.fifo);
+    EXPECT_EQ(0, other.priority);
+}
+
+TEST(GnssThreadPolicyTest, unknownSchedulerIsOther)
+{
+    EXPECT_FALSE(GnssThreadPolicy::parsePolicy("rr", 10, INT32_MIN, "").fifo);
+}
+
+TEST(GnssThreadPolicyTest, niceIsClamped)
+{
+    const Policy low = GnssThreadPolicy::parsePolicy("other", 0, -100, "");
+    const Policy high = GnssThreadPolicy::parsePolicy("other", 0, 100, "");
+    const Policy zero = GnssThreadPolicy::parsePolicy("other", 0, 0, "");
+
+    EXPECT_TRUE(low.hasNice);
+    EXPECT_EQ(-20, low.nice);
+    EXPECT_EQ(19, high.nice);
+    EXPECT_TRUE(zero.hasNice);
+    EXPECT_EQ(0, zero.nice);
+}
+
+TEST(GnssThreadPolicyTest, cpuMaskIsParsed)
+{
+    EXPECT_EQ((uint64_t)0x0c, GnssThreadPolicy::parsePolicy("other", 0, INT32_MIN, "0x0c").cpuMask);
+    EXPECT_EQ((uint64_t)3, GnssThreadPolicy::parsePolicy("other", 0, INT32_MIN, "3").cpuMask);
+    EXPECT_EQ((uint64_t)0, GnssThreadPolicy::parsePolicy("other", 0, INT32_MIN, "cpu1").cpuMask);
+}
+
+TEST(GnssThreadPolicyTest, applyNamesThreadWithDefaultPolicy)
+{
+    bool applied = false;
+    char name[16] = {};
+
+    std::thread worker([&] {
+        applied = GnssThreadPolicy::apply(GnssThreadPolicy::Role::Parse, "gnss_test");
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+    });
+    worker.join();
+
+    EXPECT_TRUE(applied);
+    EXPECT_STREQ("gnss_test", name);
+}
+
+TEST(GnssThreadPolicyTest, applyDoesNotInheritAffinity)
+{
+    cpu_set_t processSet;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(processSet), &processSet));
+
+    int pinnedCount = 0;
+    int appliedCount = 0;
+    std::thread worker([&] {
+        // the creating thread is pinned to a single CPU
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &processSet)) {
+                CPU_SET(cpu, &set);
+                break;
+            }
+        }
+        sched_setaffinity(0, sizeof(set), &set);
+        sched_getaffinity(0, sizeof(set), &set);
+        pinnedCount = CPU_COUNT(&set);
+
+        GnssThreadPolicy::apply(GnssThreadPolicy::Role::Parse, "gnss_test");
+        sched_getaffinity(0, sizeof(set), &set);
+        appliedCount = CPU_COUNT(&set);
+    });
+    worker.join();
+
+    EXPECT_EQ(1, pinnedCount);
+    EXPECT_EQ(CPU_COUNT(&processSet), appliedCount);
+}
+
+TEST(GnssThreadPolicyTest, unsetPropertiesKeepDefaults)
+{
+    const Policy policy = GnssThreadPolicy::readPolicy(GnssThreadPolicy::Role::Callback);
+
+    EXPECT_FALSE(policy.fifo);
+    EXPECT_FALSE(policy.hasNice);
+    EXPECT_EQ((uint64_t)0, policy.cpuMask);
+}